@@ -0,0 +1,104 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "AllocationCounter.h"
+
+/* Replaces every global allocation and deallocation function of the
+   executable it's linked into with one reporting to AllocationCounter.
+   Each allocation is prefixed with a header holding its size, so live bytes
+   can be tracked on deallocation. The header is as large as the alignment,
+   so the returned memory stays aligned. */
+
+namespace {
+
+using Magnum::AllocationCounter;
+
+constexpr std::size_t DefaultAlignment = alignof(std::max_align_t);
+
+void* allocate(const std::size_t size, const std::size_t alignment) noexcept {
+    const std::size_t headerSize = alignment > DefaultAlignment ? alignment : DefaultAlignment;
+    void* block;
+    if(alignment <= DefaultAlignment) block = std::malloc(headerSize + size);
+    #ifdef CORRADE_TARGET_WINDOWS
+    else block = _aligned_malloc(headerSize + size, alignment);
+    #else
+    else if(posix_memalign(&block, alignment, headerSize + size) != 0) block = nullptr;
+    #endif
+    if(!block) return nullptr;
+
+    *static_cast<std::size_t*>(block) = size;
+    AllocationCounter::record(size);
+    return static_cast<char*>(block) + headerSize;
+}
+
+void deallocate(void* const p, const std::size_t alignment) noexcept {
+    if(!p) return;
+
+    const std::size_t headerSize = alignment > DefaultAlignment ? alignment : DefaultAlignment;
+    void* const block = static_cast<char*>(p) - headerSize;
+    AllocationCounter::release(*static_cast<std::size_t*>(block));
+    #ifdef CORRADE_TARGET_WINDOWS
+    if(alignment > DefaultAlignment) {
+        _aligned_free(block);
+        return;
+    }
+    #endif
+    std::free(block);
+}
+
+void* allocateOrThrow(const std::size_t size, const std::size_t alignment) {
+    if(void* const p = allocate(size, alignment)) return p;
+    throw std::bad_alloc{};
+}
+
+}
+
+void* operator new(std::size_t size) { return allocateOrThrow(size, DefaultAlignment); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size, DefaultAlignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, DefaultAlignment); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, DefaultAlignment); }
+void operator delete(void* p) noexcept { deallocate(p, DefaultAlignment); }
+void operator delete[](void* p) noexcept { deallocate(p, DefaultAlignment); }
+void operator delete(void* p, std::size_t) noexcept { deallocate(p, DefaultAlignment); }
+void operator delete[](void* p, std::size_t) noexcept { deallocate(p, DefaultAlignment); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { deallocate(p, DefaultAlignment); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { deallocate(p, DefaultAlignment); }
+
+#ifdef __cpp_aligned_new
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateOrThrow(size, std::size_t(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateOrThrow(size, std::size_t(alignment)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, std::size_t(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, std::size_t(alignment)); }
+void operator delete(void* p, std::align_val_t alignment) noexcept { deallocate(p, std::size_t(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment) noexcept { deallocate(p, std::size_t(alignment)); }
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept { deallocate(p, std::size_t(alignment)); }
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept { deallocate(p, std::size_t(alignment)); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(p, std::size_t(alignment)); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(p, std::size_t(alignment)); }
+#endif
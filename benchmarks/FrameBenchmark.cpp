@@ -0,0 +1,386 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Arguments.h>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Renderer.h>
+#ifdef CORRADE_TARGET_APPLE
+#include <Magnum/Platform/WindowlessCglApplication.h>
+#elif defined(CORRADE_TARGET_WINDOWS)
+#include <Magnum/Platform/WindowlessWglApplication.h>
+#else
+#include <Magnum/Platform/WindowlessGlxApplication.h>
+#endif
+
+#include "AllocationCounter.h"
+#include "AsyncHandSource.h"
+#include "Gallery.h"
+#include "HandReplay.h"
+#include "JobSystem.h"
+#include "MockHmd.h"
+#include "StartupCache.h"
+#include "SyntheticHandSource.h"
+#include "TelemetryExporter.h"
+
+namespace Magnum {
+
+/* Runs the complete gallery frame loop against a mock HMD on a windowless
+   context and prints frame time percentiles together with draw call and
+   estimated state change counts as a single JSON object, so runs can be
+   compared by scripts. Frame times are CPU time of Gallery::drawFrame() and
+   Gallery::updateUi(), and additionally the time until the GPU finished the
+   frame. With a refresh rate set, the mock HMD paces frames like a
+   compositor and the frame times include waiting for the refresh.
+
+   Heap allocations are counted in every measured frame, those done inside
+   the UI library and tracking SDK separately. With --check-allocations the
+   benchmark fails if any measured frame allocated outside of those or more
+   than --exempt-budget times inside of them, which makes it usable as a CI
+   test of the allocation-free frame loop. */
+class FrameBenchmark: public Platform::WindowlessApplication {
+    public:
+        explicit FrameBenchmark(const Arguments& arguments);
+
+        int exec() override;
+
+    private:
+        Int _frames, _warmupFrames, _workers, _sampleCount, _idleFrames, _maxReusedFrames, _exemptBudget;
+        std::string _replay, _stereo, _handRenderer, _output, _profile, _startupCache, _exportTelemetry;
+        Float _replaySpeed, _telemetryRate, _minResolutionScale, _targetFrameTime, _refreshRate;
+        bool _asyncTracking, _uiCached, _pipelined, _lateLatching, _modalsLazy, _checkAllocations, _frameReuse;
+};
+
+namespace {
+
+struct Percentiles {
+    Double mean, p50, p95, p99, max;
+};
+
+/* Nearest-rank percentiles of durations in milliseconds */
+Percentiles percentiles(std::vector<Double>& times) {
+    std::sort(times.begin(), times.end());
+
+    Double sum{};
+    for(Double time: times) sum += time;
+
+    auto rank = [&times](Double percentile) {
+        const std::size_t i = std::size_t(std::ceil(percentile*times.size()));
+        return times[std::max(i, std::size_t{1}) - 1];
+    };
+
+    return {sum/times.size(), rank(0.50), rank(0.95), rank(0.99), times.back()};
+}
+
+void printPercentiles(std::FILE* out, const char* name, const Percentiles& p) {
+    std::fprintf(out, "  \"%s\": {\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f},\n",
+        name, p.mean, p.p50, p.p95, p.p99, p.max);
+}
+
+}
+
+FrameBenchmark::FrameBenchmark(const Arguments& arguments): Platform::WindowlessApplication{arguments} {
+    Utility::Arguments args;
+    args.addOption("frames", "1000").setHelp("frames", "count of measured frames", "N")
+        .addOption("warmup", "100").setHelp("warmup", "count of frames to run before measuring", "N")
+        .addOption("hand-renderer", "instanced").setHelp("hand-renderer", "hand rendering path", "instanced|per-bone|impostor")
+        .addOption("stereo", "multi-pass").setHelp("stereo", "stereo rendering mode", "multi-pass|single-pass")
+        .addOption("msaa", "0").setHelp("msaa", "eye buffer sample count, 0 to disable multisampling", "N")
+        .addBooleanOption("no-ui-cache").setHelp("no-ui-cache", "draw the UI directly instead of through a render-to-texture cache")
+        .addBooleanOption("eager-modals").setHelp("eager-modals", "create all modal dialogs at startup instead of on first use")
+        .addOption("telemetry-rate", "30").setHelp("telemetry-rate", "max telemetry refresh rate in Hz, 0 to refresh every frame", "RATE")
+        .addOption("min-resolution-scale", "1.0").setHelp("min-resolution-scale", "min eye buffer resolution scale, below 1 enables adaptive resolution", "SCALE")
+        .addOption("target-frame-time", "11.1").setHelp("target-frame-time", "target GPU frame time for adaptive resolution in milliseconds", "MS")
+        .addOption("startup-cache").setHelp("startup-cache", "load preprocessed meshes and shader binaries from a cache file, created if it doesn't exist", "FILE")
+        .addOption("replay").setHelp("replay", "replay hand tracking input from a file instead of synthetic hands", "FILE")
+        .addOption("replay-speed", "0.0").setHelp("replay-speed", "replay speed relative to realtime, 0 to advance one recorded frame per frame", "SPEED")
+        .addOption("workers", "0").setHelp("workers", "count of worker threads preparing frames, 0 to do everything on the main thread", "N")
+        .addBooleanOption("no-pipelining").setHelp("no-pipelining", "don't prepare hands of the next frame while the current one is submitted")
+        .addOption("refresh-rate", "0").setHelp("refresh-rate", "pace frames to a mock display refresh rate in Hz, 0 to run unpaced", "RATE")
+        .addBooleanOption("no-late-latching").setHelp("no-late-latching", "draw with the head poses polled at the start of the frame")
+        .addBooleanOption("frame-reuse").setHelp("frame-reuse", "resubmit the previous frame instead of rendering an unchanged one")
+        .addOption("max-reused-frames", "8").setHelp("max-reused-frames", "max count of frames reused in a row", "N")
+        .addOption("idle-frames", "0").setHelp("idle-frames", "take synthetic hands out of view for this many frames after every 90 frames", "N")
+        .addBooleanOption("async-tracking").setHelp("async-tracking", "poll synthetic hands on a dedicated thread like live tracking in the gallery")
+        .addOption("export-telemetry").setHelp("export-telemetry", "export every frame into a shared memory region of this name", "NAME")
+        .addBooleanOption("check-allocations").setHelp("check-allocations", "fail if any measured frame allocates outside of the UI library and tracking SDK, or over the exempt budget inside of them")
+        .addOption("exempt-budget", "32").setHelp("exempt-budget", "max allocations per frame inside the UI library and tracking SDK for --check-allocations", "N")
+        .addOption("profile").setHelp("profile", "export per-stage timings of the measured frames, as CSV if the filename ends with .csv and as Chrome trace otherwise", "FILE")
+        .addOption("output").setHelp("output", "write the JSON report into a file instead of standard output", "FILE")
+        .addSkippedPrefix("magnum", "engine-specific options")
+        .parse(arguments.argc, arguments.argv);
+
+    _frames = args.value<Int>("frames");
+    _warmupFrames = args.value<Int>("warmup");
+    _handRenderer = args.value("hand-renderer");
+    _stereo = args.value("stereo");
+    _replay = args.value("replay");
+    _replaySpeed = args.value<Float>("replay-speed");
+    _output = args.value("output");
+    _profile = args.value("profile");
+    _startupCache = args.value("startup-cache");
+    _telemetryRate = args.value<Float>("telemetry-rate");
+    _minResolutionScale = args.value<Float>("min-resolution-scale");
+    _targetFrameTime = args.value<Float>("target-frame-time");
+    _asyncTracking = args.isSet("async-tracking");
+    _uiCached = !args.isSet("no-ui-cache");
+    _modalsLazy = !args.isSet("eager-modals");
+    _checkAllocations = args.isSet("check-allocations");
+    _exemptBudget = args.value<Int>("exempt-budget");
+    _exportTelemetry = args.value("export-telemetry");
+    _sampleCount = args.value<Int>("msaa");
+    _workers = args.value<Int>("workers");
+    _pipelined = !args.isSet("no-pipelining");
+    _refreshRate = args.value<Float>("refresh-rate");
+    _lateLatching = !args.isSet("no-late-latching");
+    _frameReuse = args.isSet("frame-reuse");
+    _maxReusedFrames = args.value<Int>("max-reused-frames");
+    _idleFrames = args.value<Int>("idle-frames");
+}
+
+int FrameBenchmark::exec() {
+    if(_frames <= 0) {
+        Error() << "Expected a positive frame count";
+        return 1;
+    }
+
+    std::unique_ptr<AbstractHandSource> handSource;
+    if(!_replay.empty()) {
+        std::unique_ptr<HandReplay> replay{new HandReplay{_replay}};
+        if(!replay->isConnected()) {
+            Error() << "Cannot replay" << _replay;
+            return 1;
+        }
+        replay->setSpeed(_replaySpeed)
+            .setLooping(true);
+        handSource = std::move(replay);
+    } else {
+        std::unique_ptr<SyntheticHandSource> synthetic{new SyntheticHandSource};
+        synthetic->setVisibility(90, UnsignedInt(_idleFrames));
+        handSource = std::move(synthetic);
+    }
+
+    AsyncHandSource* asyncHandSource{};
+    if(_asyncTracking) {
+        /* Synthetic hands advance by one 90 Hz frame on every poll */
+        asyncHandSource = new AsyncHandSource{std::move(handSource), std::chrono::microseconds{11111}};
+        handSource.reset(asyncHandSource);
+    }
+
+    /* Time to first frame covers creating the gallery and drawing one frame
+       until the GPU finished it */
+    const auto startupBegin = std::chrono::high_resolution_clock::now();
+    Containers::Optional<StartupCache> startupCache;
+    if(!_startupCache.empty()) startupCache.emplace(_startupCache);
+
+    Containers::Optional<JobSystem> jobs;
+    if(_workers > 0) jobs.emplace(UnsignedInt(_workers));
+
+    Containers::Optional<TelemetryExporter> telemetryExporter;
+    if(!_exportTelemetry.empty()) telemetryExporter.emplace(_exportTelemetry);
+
+    MockHmd hmd;
+    hmd.setRefreshRate(_refreshRate);
+    Gallery gallery{hmd, std::move(handSource), Gallery::Configuration{}
+        .setHandRendererMode(_handRenderer == "per-bone" ? HandRenderer::Mode::PerBone :
+            _handRenderer == "impostor" ? HandRenderer::Mode::Impostor : HandRenderer::Mode::Instanced)
+        .setSinglePassStereo(_stereo == "single-pass")
+        .setUiCached(_uiCached)
+        .setModalsLazy(_modalsLazy)
+        .setSampleCount(_sampleCount)
+        .setTelemetryRefreshRate(_telemetryRate)
+        .setResolutionScaleRange(_minResolutionScale, 1.0f)
+        .setTargetFrameTime(_targetFrameTime)
+        .setStartupCache(startupCache ? &*startupCache : nullptr)
+        .setJobSystem(jobs ? &*jobs : nullptr)
+        .setTelemetryExporter(telemetryExporter ? &*telemetryExporter : nullptr)
+        .setPipelined(_pipelined)
+        .setLateLatching(_lateLatching)
+        .setFrameReuse(_frameReuse)
+        .setMaxReusedFrames(UnsignedInt(_maxReusedFrames))};
+
+    gallery.drawFrame();
+    gallery.updateUi();
+    GL::Renderer::finish();
+    const Double startupTime = std::chrono::duration<Double, std::milli>(std::chrono::high_resolution_clock::now() - startupBegin).count();
+    if(startupCache && startupCache->hasChanged()) startupCache->save();
+
+    /* Get shader compilation, first uploads and glyph cache fills out of the
+       way, the first frame above counts as well */
+    for(Int i = 1; i < _warmupFrames; ++i) {
+        gallery.drawFrame();
+        gallery.updateUi();
+    }
+    GL::Renderer::finish();
+
+    if(!_profile.empty()) gallery.profiler().setEnabled(true);
+
+    std::vector<Double> cpuTimes, frameTimes, poseAges;
+    cpuTimes.reserve(_frames);
+    frameTimes.reserve(_frames);
+    poseAges.reserve(_frames);
+    const UnsignedInt missedRefreshes = hmd.missedRefreshCount();
+    UnsignedLong drawCalls{}, estimatedStateChanges{}, uploadedBytes{}, fenceWaits{}, visibleObjects{}, culledObjects{};
+    Double resolutionScale{};
+    UnsignedLong allocatingFrames{}, maxFrameAllocations{};
+    UnsignedLong exemptFrames{}, maxExemptAllocations{}, overBudgetFrames{};
+    AllocationCounter::reset();
+    AllocationCounter::setEnabled(true);
+    for(Int i = 0; i != _frames; ++i) {
+        const UnsignedLong allocations = AllocationCounter::count();
+        const UnsignedLong exemptAllocations = AllocationCounter::exemptCount();
+        const auto start = std::chrono::high_resolution_clock::now();
+        gallery.drawFrame();
+        gallery.updateUi();
+        const auto submitted = std::chrono::high_resolution_clock::now();
+        const UnsignedLong frameAllocations = AllocationCounter::count() - allocations;
+        if(frameAllocations) ++allocatingFrames;
+        maxFrameAllocations = std::max(maxFrameAllocations, frameAllocations);
+        const UnsignedLong frameExemptAllocations = AllocationCounter::exemptCount() - exemptAllocations;
+        if(frameExemptAllocations) ++exemptFrames;
+        if(frameExemptAllocations > UnsignedLong(_exemptBudget)) ++overBudgetFrames;
+        maxExemptAllocations = std::max(maxExemptAllocations, frameExemptAllocations);
+
+        /* Don't let the driver queue up frames, so each frame is measured
+           separately */
+        GL::Renderer::finish();
+        const auto finished = std::chrono::high_resolution_clock::now();
+
+        cpuTimes.push_back(std::chrono::duration<Double, std::milli>(submitted - start).count());
+        frameTimes.push_back(std::chrono::duration<Double, std::milli>(finished - start).count());
+        poseAges.push_back(gallery.frameStats().poseAge/1000.0);
+        drawCalls += gallery.frameStats().drawCalls;
+        estimatedStateChanges += gallery.frameStats().estimatedStateChanges;
+        uploadedBytes += gallery.frameStats().uploadedBytes;
+        fenceWaits += gallery.frameStats().fenceWaits;
+        visibleObjects += gallery.frameStats().visibleObjects;
+        culledObjects += gallery.frameStats().culledObjects;
+        resolutionScale += gallery.resolutionController().scale();
+    }
+    AllocationCounter::setEnabled(false);
+
+    if(!_profile.empty()) {
+        FrameProfiler& profiler = gallery.profiler();
+        profiler.setEnabled(false);
+        const bool csv = _profile.size() >= 4 && _profile.compare(_profile.size() - 4, 4, ".csv") == 0;
+        if(!(csv ? profiler.exportCsv(_profile) : profiler.exportChromeTrace(_profile)))
+            Error() << "Cannot export profile to" << _profile;
+    }
+
+    std::FILE* out = stdout;
+    if(!_output.empty() && !(out = std::fopen(_output.data(), "w"))) {
+        Error() << "Cannot open" << _output << "for writing";
+        return 1;
+    }
+
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"frames\": %d,\n", _frames);
+    std::fprintf(out, "  \"handSource\": \"%s\",\n", _replay.empty() ? "synthetic" : "replay");
+    std::fprintf(out, "  \"handRenderer\": \"%s\",\n", _handRenderer.data());
+    std::fprintf(out, "  \"stereo\": \"%s\",\n", _stereo.data());
+    std::fprintf(out, "  \"msaa\": %d,\n", gallery.sampleCount());
+    std::fprintf(out, "  \"workers\": %d,\n", jobs ? _workers : 0);
+    if(jobs) std::fprintf(out, "  \"jobs\": {\"pipelined\": %s, \"finished\": %llu, \"stolen\": %llu},\n",
+        _pipelined ? "true" : "false",
+        static_cast<unsigned long long>(jobs->finishedCount()),
+        static_cast<unsigned long long>(jobs->stolenCount()));
+    std::fprintf(out, "  \"renderer\": \"%s\",\n", GL::Context::current().rendererString().data());
+    std::fprintf(out, "  \"startupMs\": %.4f,\n", startupTime);
+    std::fprintf(out, "  \"modals\": {\"lazy\": %s, \"registered\": %llu, \"alive\": %llu},\n",
+        _modalsLazy ? "true" : "false", static_cast<unsigned long long>(gallery.modals().count()), static_cast<unsigned long long>(gallery.modals().liveCount()));
+    if(startupCache) std::fprintf(out, "  \"startupCache\": {\"hits\": %u, \"misses\": %u},\n",
+        startupCache->hitCount(), startupCache->missCount());
+    printPercentiles(out, "cpuMs", percentiles(cpuTimes));
+    printPercentiles(out, "frameMs", percentiles(frameTimes));
+    printPercentiles(out, "poseAgeMs", percentiles(poseAges));
+    std::fprintf(out, "  \"pacing\": {\"refreshRate\": %.2f, \"lateLatching\": %s, \"missedRefreshes\": %u},\n",
+        Double(_refreshRate), gallery.isLateLatching() ? "true" : "false", hmd.missedRefreshCount() - missedRefreshes);
+    std::fprintf(out, "  \"drawCallsPerFrame\": %.2f,\n", Double(drawCalls)/_frames);
+    std::fprintf(out, "  \"stateChangesPerFrame\": %.2f,\n", Double(estimatedStateChanges)/_frames);
+    std::fprintf(out, "  \"instanceUpload\": {\"mode\": \"%s\", \"bytesPerFrame\": %.1f, \"fenceWaits\": %llu},\n",
+        !gallery.handRenderer().isStreamed() ? "setData" :
+            gallery.handRenderer().streamingBuffer().mode() == StreamingBuffer::Mode::PersistentMapping ? "persistent" : "orphaning",
+        Double(uploadedBytes)/_frames, static_cast<unsigned long long>(fenceWaits));
+    std::fprintf(out, "  \"culling\": {\"visiblePerFrame\": %.2f, \"culledPerFrame\": %.2f},\n",
+        Double(visibleObjects)/_frames, Double(culledObjects)/_frames);
+    std::fprintf(out, "  \"resolutionScale\": {\"mean\": %.4f, \"last\": %.4f},\n",
+        resolutionScale/_frames, gallery.resolutionController().scale());
+    std::fprintf(out, "  \"telemetryUpdates\": %llu,\n", static_cast<unsigned long long>(gallery.telemetry().updateCount()));
+    if(gallery.isUiCached()) std::fprintf(out, "  \"uiCache\": {\"hits\": %llu, \"misses\": %llu},\n",
+        static_cast<unsigned long long>(gallery.cachedUi().hitCount()),
+        static_cast<unsigned long long>(gallery.cachedUi().missCount()));
+    if(asyncHandSource) std::fprintf(out, "  \"tracking\": {\"published\": %llu, \"dropped\": %llu, \"stale\": %llu},\n",
+        static_cast<unsigned long long>(asyncHandSource->publishedCount()),
+        static_cast<unsigned long long>(asyncHandSource->droppedCount()),
+        static_cast<unsigned long long>(asyncHandSource->staleCount()));
+    if(telemetryExporter) std::fprintf(out, "  \"telemetryExport\": {\"region\": \"%s\", \"written\": %llu},\n",
+        _exportTelemetry.data(), static_cast<unsigned long long>(telemetryExporter->writeCount()));
+    const Gallery::FrameReuseStats& reuse = gallery.frameReuseStats();
+    std::fprintf(out, "  \"frameReuse\": {\"enabled\": %s, \"reused\": %llu, \"resubmitted\": %u, \"sceneChanged\": %llu, \"handsVisible\": %llu, \"headMoved\": %llu, \"capReached\": %llu},\n",
+        gallery.isFrameReuse() ? "true" : "false",
+        static_cast<unsigned long long>(reuse.reused),
+        hmd.resubmittedFrameCount(),
+        static_cast<unsigned long long>(reuse.sceneChanged),
+        static_cast<unsigned long long>(reuse.handsVisible),
+        static_cast<unsigned long long>(reuse.headMoved),
+        static_cast<unsigned long long>(reuse.capReached));
+    std::fprintf(out, "  \"allocations\": {\"total\": %llu, \"allocatingFrames\": %llu, \"maxPerFrame\": %llu},\n",
+        static_cast<unsigned long long>(AllocationCounter::count()),
+        static_cast<unsigned long long>(allocatingFrames),
+        static_cast<unsigned long long>(maxFrameAllocations));
+    std::fprintf(out, "  \"exemptAllocations\": {\"total\": %llu, \"allocatingFrames\": %llu, \"maxPerFrame\": %llu, \"budget\": %d, \"overBudgetFrames\": %llu},\n",
+        static_cast<unsigned long long>(AllocationCounter::exemptCount()),
+        static_cast<unsigned long long>(exemptFrames),
+        static_cast<unsigned long long>(maxExemptAllocations),
+        _exemptBudget,
+        static_cast<unsigned long long>(overBudgetFrames));
+    std::fprintf(out, "  \"submittedFrames\": %u\n", hmd.submittedFrameCount());
+    std::fprintf(out, "}\n");
+
+    if(out != stdout) std::fclose(out);
+
+    if(_checkAllocations && (allocatingFrames || overBudgetFrames)) {
+        if(allocatingFrames)
+            Error() << allocatingFrames << "of" << _frames << "measured frames allocated, up to" << maxFrameAllocations << "allocations per frame";
+        if(overBudgetFrames)
+            Error() << overBudgetFrames << "of" << _frames << "measured frames allocated over the budget of" << _exemptBudget << "in the UI library or tracking SDK, up to" << maxExemptAllocations << "allocations per frame";
+        return 1;
+    }
+
+    return 0;
+}
+
+}
+
+MAGNUM_WINDOWLESSAPPLICATION_MAIN(Magnum::FrameBenchmark)
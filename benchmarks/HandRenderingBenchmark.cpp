@@ -0,0 +1,184 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <chrono>
+
+#include <Corrade/Utility/Arguments.h>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Math/Matrix4.h>
+#ifdef CORRADE_TARGET_APPLE
+#include <Magnum/Platform/WindowlessCglApplication.h>
+#elif defined(CORRADE_TARGET_WINDOWS)
+#include <Magnum/Platform/WindowlessWglApplication.h>
+#else
+#include <Magnum/Platform/WindowlessGlxApplication.h>
+#endif
+
+#include "HandRenderer.h"
+#include "HandSnapshot.h"
+#include "SyntheticHandSource.h"
+
+namespace Magnum {
+
+using namespace Math::Literals;
+
+/* Compares CPU submission cost of the per-bone, instanced and single-pass
+   stereo hand rendering paths on a synthetic pair of hands with the same bone
+   and joint counts as LeapHandSource produces */
+class HandRenderingBenchmark: public Platform::WindowlessApplication {
+    public:
+        explicit HandRenderingBenchmark(const Arguments& arguments);
+
+        int exec() override;
+
+    private:
+        void addHands(HandRenderer& renderer);
+        void benchmark(HandRenderer& renderer, HandRenderer::Mode mode, bool stereo);
+
+        Int _frames;
+        Range2Di _eyeViewport[2];
+        Range2Di _stereoViewport;
+        GL::Renderbuffer _color, _depth;
+        GL::Framebuffer _framebuffer{NoCreate};
+        Matrix4 _projectionMatrix[2];
+        SyntheticHandSource _handSource;
+        HandSnapshot _hands;
+};
+
+HandRenderingBenchmark::HandRenderingBenchmark(const Arguments& arguments): Platform::WindowlessApplication{arguments} {
+    Utility::Arguments args;
+    args.addOption("frames", "1000").setHelp("frames", "count of frames to submit for each mode", "N")
+        .addSkippedPrefix("magnum", "engine-specific options")
+        .parse(arguments.argc, arguments.argv);
+    _frames = args.value<Int>("frames");
+
+    /* Roughly the size of two Rift eye buffers side by side */
+    const Vector2i size{2*1344, 1600};
+    _eyeViewport[0] = {{}, {size.x()/2, size.y()}};
+    _eyeViewport[1] = {{size.x()/2, 0}, size};
+    _stereoViewport = {{}, size};
+    _color.setStorage(GL::RenderbufferFormat::RGBA8, size);
+    _depth.setStorage(GL::RenderbufferFormat::DepthComponent24, size);
+    _framebuffer = GL::Framebuffer{{{}, size}};
+    _framebuffer.attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, _color)
+                .attachRenderbuffer(GL::Framebuffer::BufferAttachment::Depth, _depth)
+                .bind();
+
+    GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
+
+    /* Both eyes looking at the hands from 40 cm, the same way the hand
+       tracking space is mapped in Gallery */
+    const Matrix4 toWorldSpace = Matrix4::rotationX(-90.0_degf)*Matrix4::scaling(0.001f*Vector3{-1.0f, 1.0f, -1.0f});
+    for(Int eye: {0, 1})
+        _projectionMatrix[eye] = Matrix4::perspectiveProjection(100.0_degf, Vector2{_eyeViewport[eye].size()}.aspectRatio(), 0.001f, 25.0f)*
+            Matrix4::translation({eye ? -0.032f : 0.032f, 0.65f, 0.0f})*toWorldSpace;
+}
+
+void HandRenderingBenchmark::addHands(HandRenderer& renderer) {
+    _handSource.frame(_hands);
+    _hands.computeTransformations(Matrix4{});
+    renderer.setHands(_hands);
+}
+
+void HandRenderingBenchmark::benchmark(HandRenderer& renderer, const HandRenderer::Mode mode, const bool stereo) {
+    renderer.setMode(mode)
+        .setStereo(stereo);
+
+    std::chrono::high_resolution_clock::duration prepareTime{}, submitTime{};
+    UnsignedInt drawCalls{};
+    for(Int frame = 0; frame != _frames; ++frame) {
+        _framebuffer.clear(GL::FramebufferClear::Color|GL::FramebufferClear::Depth);
+
+        addHands(renderer);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        renderer.prepare();
+        const auto prepared = std::chrono::high_resolution_clock::now();
+        if(stereo) {
+            _framebuffer.setViewport(_stereoViewport);
+            glEnable(GL_CLIP_DISTANCE0);
+            renderer.drawStereo(_projectionMatrix[0], _projectionMatrix[1]);
+            glDisable(GL_CLIP_DISTANCE0);
+        } else for(Int eye: {0, 1}) {
+            _framebuffer.setViewport(_eyeViewport[eye]);
+            renderer.draw(_projectionMatrix[eye]);
+        }
+        const auto submitted = std::chrono::high_resolution_clock::now();
+
+        prepareTime += prepared - start;
+        submitTime += submitted - prepared;
+        drawCalls = renderer.drawCallCount();
+
+        /* Don't let the driver queue up frames, we're measuring only the
+           CPU side */
+        GL::Renderer::finish();
+    }
+
+    const Double frames = _frames;
+    const char* name;
+    if(mode == HandRenderer::Mode::Impostor)
+        name = stereo ? "impostor stereo:   " : "impostor:          ";
+    else if(stereo) name = "single-pass stereo:";
+    else name = mode == HandRenderer::Mode::Instanced ? "instanced:         " : "per-bone:          ";
+    Debug() << name
+        << renderer.boneCount() << "bones," << renderer.jointCount() << "joints,"
+        << drawCalls << "draw calls per frame, upload"
+        << std::chrono::duration<Double, std::micro>(prepareTime).count()/frames << "µs, submit"
+        << std::chrono::duration<Double, std::micro>(submitTime).count()/frames << "µs per frame";
+}
+
+int HandRenderingBenchmark::exec() {
+    HandRenderer renderer;
+    renderer.setViewportSize(_eyeViewport[0].size());
+
+    /* Warm up all paths so first uploads and draws aren't measured */
+    for(HandRenderer::Mode mode: {HandRenderer::Mode::PerBone, HandRenderer::Mode::Instanced, HandRenderer::Mode::Impostor}) {
+        renderer.setMode(mode).setStereo(true);
+        addHands(renderer);
+        renderer.prepare()
+            .draw(_projectionMatrix[0]);
+        glEnable(GL_CLIP_DISTANCE0);
+        renderer.drawStereo(_projectionMatrix[0], _projectionMatrix[1]);
+        glDisable(GL_CLIP_DISTANCE0);
+        GL::Renderer::finish();
+    }
+
+    benchmark(renderer, HandRenderer::Mode::PerBone, false);
+    benchmark(renderer, HandRenderer::Mode::Instanced, false);
+    benchmark(renderer, HandRenderer::Mode::Instanced, true);
+    benchmark(renderer, HandRenderer::Mode::Impostor, false);
+    benchmark(renderer, HandRenderer::Mode::Impostor, true);
+
+    return 0;
+}
+
+}
+
+MAGNUM_WINDOWLESSAPPLICATION_MAIN(Magnum::HandRenderingBenchmark)
@@ -0,0 +1,174 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include <chrono>
+#include <cstddef>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Arguments.h>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Renderer.h>
+#ifdef CORRADE_TARGET_APPLE
+#include <Magnum/Platform/WindowlessCglApplication.h>
+#elif defined(CORRADE_TARGET_WINDOWS)
+#include <Magnum/Platform/WindowlessWglApplication.h>
+#else
+#include <Magnum/Platform/WindowlessGlxApplication.h>
+#endif
+#include <Magnum/Ui/UserInterface.h>
+
+#include "AllocationCounter.h"
+#include "GalleryUi.h"
+#include "ModalPool.h"
+
+namespace Magnum {
+
+/* Registers a given count of modal dialogs like an app with many of them,
+   creating the planes either all upfront or on first use through a
+   ModalPool, and compares startup time and resident heap memory. Then
+   simulates a session opening and closing a few of the dialogs over and
+   over, and reports the activation time, how many planes were created and
+   destroyed and the heap memory at the end and at peak. GPU memory of the
+   UI is shared by all planes and not affected. */
+class ModalBenchmark: public Platform::WindowlessApplication {
+    public:
+        explicit ModalBenchmark(const Arguments& arguments);
+
+        int exec() override;
+
+    private:
+        void benchmark(bool lazy);
+
+        Int _dialogs, _opened, _sessions;
+        std::size_t _capacity;
+        GL::Renderbuffer _color;
+        GL::Framebuffer _framebuffer{NoCreate};
+        Containers::Optional<Ui::UserInterface> _ui;
+};
+
+ModalBenchmark::ModalBenchmark(const Arguments& arguments): Platform::WindowlessApplication{arguments} {
+    Utility::Arguments args;
+    args.addOption("dialogs", "50").setHelp("dialogs", "count of registered modal dialogs", "N")
+        .addOption("opened", "3").setHelp("opened", "count of distinct dialogs opened during a session", "N")
+        .addOption("sessions", "100").setHelp("sessions", "count of times each opened dialog is shown and closed", "N")
+        .addOption("capacity", "2").setHelp("capacity", "max count of closed dialogs kept alive by the lazy pool", "N")
+        .addSkippedPrefix("magnum", "engine-specific options")
+        .parse(arguments.argc, arguments.argv);
+    _dialogs = args.value<Int>("dialogs");
+    _opened = args.value<Int>("opened");
+    _sessions = args.value<Int>("sessions");
+    _capacity = args.value<std::size_t>("capacity");
+
+    const Vector2i size{1024, 1024};
+    _color.setStorage(GL::RenderbufferFormat::RGBA8, size);
+    _framebuffer = GL::Framebuffer{{{}, size}};
+    _framebuffer.attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, _color)
+                .bind();
+
+    GL::Renderer::enable(GL::Renderer::Feature::Blending);
+    GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+
+    _ui.emplace(Vector2{1024.0f, 1024.0f}, size, Ui::mcssDarkStyleConfiguration(), "»");
+}
+
+void ModalBenchmark::benchmark(const bool lazy) {
+    constexpr Ui::Style Styles[]{Ui::Style::Default, Ui::Style::Danger, Ui::Style::Success, Ui::Style::Warning, Ui::Style::Info};
+
+    const std::size_t bytesBefore = AllocationCounter::liveBytes();
+    AllocationCounter::resetPeakBytes();
+
+    /* Startup is registering all dialogs, with eager creation also creating
+       their planes */
+    const auto start = std::chrono::high_resolution_clock::now();
+    Containers::Optional<ModalPool> modals{Containers::InPlaceInit, *_ui, lazy ? _capacity : std::size_t(_dialogs)};
+    for(Int i = 0; i != _dialogs; ++i) modals->add(Styles[i % 5]);
+    if(!lazy) modals->createAll();
+    const auto started = std::chrono::high_resolution_clock::now();
+    const std::size_t startupBytes = AllocationCounter::liveBytes() - bytesBefore;
+
+    /* Open and close the same few dialogs spread over the whole range,
+       drawing each once so its widget data are uploaded */
+    std::chrono::high_resolution_clock::duration activateTime{};
+    for(Int session = 0; session != _sessions; ++session) {
+        for(Int i = 0; i != _opened; ++i) {
+            const UnsignedInt id = UnsignedInt(i*_dialogs/_opened);
+            const auto activateStart = std::chrono::high_resolution_clock::now();
+            modals->activate(id);
+            activateTime += std::chrono::high_resolution_clock::now() - activateStart;
+            _ui->draw();
+            modals->hide(id);
+            modals->collect();
+        }
+    }
+    GL::Renderer::finish();
+    const std::size_t sessionBytes = AllocationCounter::liveBytes() - bytesBefore;
+    const std::size_t sessionPeakBytes = AllocationCounter::peakBytes() - bytesBefore;
+
+    const auto teardownStart = std::chrono::high_resolution_clock::now();
+    const std::size_t liveCount = modals->liveCount();
+    const UnsignedLong createdCount = modals->createdCount();
+    const UnsignedLong releasedCount = modals->releasedCount();
+    modals = Containers::NullOpt;
+    const auto tornDown = std::chrono::high_resolution_clock::now();
+
+    const Int activations = _sessions*_opened;
+    Debug() << (lazy ? "lazy: " : "eager:") << _dialogs << "dialogs, startup"
+        << std::chrono::duration<Double, std::milli>(started - start).count() << "ms with"
+        << startupBytes/1024.0 << "kB, activation"
+        << std::chrono::duration<Double, std::micro>(activateTime).count()/activations << "µs, after"
+        << activations << "activations" << createdCount << "planes created,"
+        << releasedCount << "released," << liveCount << "alive with"
+        << sessionBytes/1024.0 << "kB, peak" << sessionPeakBytes/1024.0 << "kB, teardown"
+        << std::chrono::duration<Double, std::milli>(tornDown - teardownStart).count() << "ms";
+}
+
+int ModalBenchmark::exec() {
+    if(_dialogs <= 0 || _opened <= 0 || _opened > _dialogs) {
+        Error() << "Expected a positive dialog count and at most that many opened dialogs";
+        return 1;
+    }
+
+    /* Warm up the glyph cache with one of each dialog style */
+    {
+        ModalPool modals{*_ui, 0};
+        for(const Ui::Style style: {Ui::Style::Default, Ui::Style::Danger, Ui::Style::Success, Ui::Style::Warning, Ui::Style::Info})
+            modals.activate(modals.add(style));
+        _ui->draw();
+        GL::Renderer::finish();
+    }
+
+    benchmark(false);
+    benchmark(true);
+
+    return 0;
+}
+
+}
+
+MAGNUM_WINDOWLESSAPPLICATION_MAIN(Magnum::ModalBenchmark)
@@ -0,0 +1,245 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <Corrade/Utility/Arguments.h>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "HandSnapshot.h"
+#include "PanelRegistry.h"
+#include "StereoFrustum.h"
+
+namespace Magnum {
+
+using namespace Math::Literals;
+
+namespace {
+
+/* Same query parameters as in Gallery */
+constexpr Float TouchQueryRadius = 0.05f;
+constexpr Float PointerDistance = 10.0f;
+
+/* A typical HMD field of view and eye distance, with the same near and far
+   planes as in Gallery */
+const Matrix4 EyeProjection = Matrix4::perspectiveProjection(Deg(100.0f), 1.0f, 0.001f, 25.0f);
+constexpr Float EyeDistance = 0.064f;
+
+/* Panels scattered on shells around the user at 0.5 to 5 meters, facing
+   them, between 20 centimeters and a meter large */
+PanelRegistry scatterPanels(std::mt19937& random, const UnsignedInt count) {
+    std::uniform_real_distribution<Float> angle{-180.0f, 180.0f};
+    std::uniform_real_distribution<Float> elevation{-60.0f, 60.0f};
+    std::uniform_real_distribution<Float> distance{0.5f, 5.0f};
+    std::uniform_real_distribution<Float> size{0.2f, 1.0f};
+
+    PanelRegistry panels;
+    for(UnsignedInt i = 0; i != count; ++i) {
+        const Float width = size(random);
+        panels.add(
+            Matrix4::rotationY(Deg(angle(random)))*
+            Matrix4::rotationX(Deg(elevation(random)))*
+            Matrix4::translation(Vector3::zAxis(-distance(random)))*
+            Matrix4::scaling({width, width*0.75f, 1.0f}),
+            {1024, 768});
+    }
+    return panels;
+}
+
+/* The same tests done against every panel, to check the hierarchy against */
+PanelRegistry::Hit bruteForceSphere(const PanelRegistry& panels, const Vector3& center) {
+    PanelRegistry::Hit best;
+    for(UnsignedInt id = 0; id != panels.panelCount(); ++id) {
+        const PanelRegistry::Hit hit = panels.project(id, center);
+        const Vector2 halfSize = panels.size(id)*0.5f;
+        if(hit.distance > TouchQueryRadius ||
+           Math::abs(hit.position.x()) > halfSize.x() ||
+           Math::abs(hit.position.y()) > halfSize.y()) continue;
+        if(best.panel == -1 || hit.distance < best.distance) best = hit;
+    }
+    return best;
+}
+
+PanelRegistry::Hit bruteForceRay(const PanelRegistry& panels, const Vector3& origin, const Vector3& direction) {
+    PanelRegistry::Hit best;
+    for(UnsignedInt id = 0; id != panels.panelCount(); ++id) {
+        const Float z0 = panels.project(id, origin).position.z();
+        const Float z1 = panels.project(id, origin + direction).position.z();
+        if(Math::abs(z1 - z0) < 1.0e-6f) continue;
+
+        const Float t = z0/(z0 - z1);
+        if(t < 0.0f || t > PointerDistance || (best.panel != -1 && t >= best.distance))
+            continue;
+
+        PanelRegistry::Hit hit = panels.project(id, origin + direction*t);
+        const Vector2 halfSize = panels.size(id)*0.5f;
+        if(Math::abs(hit.position.x()) > halfSize.x() ||
+           Math::abs(hit.position.y()) > halfSize.y()) continue;
+        hit.distance = t;
+        best = hit;
+    }
+    return best;
+}
+
+}
+
+}
+
+/* Queries panel registries of 10 to 10000 panels with the sphere and ray
+   tests Gallery does every frame for all ten fingertips, with the bounding
+   volume hierarchy and with brute force, and prints time per frame, panels
+   tested per query and how many hits differ between the two. Half of the
+   fingertips are placed right next to a random panel, the rest anywhere
+   within reach. Then the panels are culled for a head looking in a random
+   direction, once through the hierarchy and the combined stereo frustum
+   and once by testing every panel against both eyes, printing time per
+   frame, nodes and panels tested, visible panels and masks that differ. */
+int main(int argc, char** argv) {
+    using namespace Magnum;
+
+    Utility::Arguments args;
+    args.addOption("frames", "1000").setHelp("frames", "count of queried frames for each panel count", "N")
+        .addOption("moving", "0.01").setHelp("moving", "fraction of panels moved every frame", "FRACTION")
+        .parse(argc, argv);
+
+    const Int frames = args.value<Int>("frames");
+    const Float moving = args.value<Float>("moving");
+
+    std::printf("{\n");
+    bool first = true;
+    for(UnsignedInt count: {10u, 100u, 1000u, 10000u}) {
+        std::mt19937 random{count};
+        PanelRegistry panels = scatterPanels(random, count);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        panels.update();
+        const Double buildMs = std::chrono::duration<Double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::uniform_int_distribution<UnsignedInt> panelId{0, count - 1};
+        std::uniform_real_distribution<Float> unit{-1.0f, 1.0f};
+        std::uniform_real_distribution<Float> offset{-0.4f, 0.4f};
+        std::uniform_real_distribution<Float> yaw{-180.0f, 180.0f};
+        std::uniform_real_distribution<Float> pitch{-45.0f, 45.0f};
+        std::vector<UnsignedByte> cullMasks(count), bruteForceMasks(count);
+
+        std::chrono::high_resolution_clock::duration refitTime{}, bvhTime{}, bruteForceTime{}, cullTime{}, bruteForceCullTime{};
+        UnsignedLong bvhTests{}, hits{}, mismatches{};
+        UnsignedLong cullNodes{}, cullPanels{}, visible{}, cullMismatches{};
+        const UnsignedInt movedCount = UnsignedInt(count*moving);
+        for(Int frame = 0; frame != frames; ++frame) {
+            /* Move some panels around the user */
+            start = std::chrono::high_resolution_clock::now();
+            for(UnsignedInt i = 0; i != movedCount; ++i) {
+                const UnsignedInt id = panelId(random);
+                panels.setTransformation(id, Matrix4::rotationY(1.0_degf)*panels.transformation(id));
+            }
+            panels.update();
+            refitTime += std::chrono::high_resolution_clock::now() - start;
+
+            Vector3 fingertips[HandSnapshot::MaxFingertips];
+            for(UnsignedInt i = 0; i != HandSnapshot::MaxFingertips; ++i) {
+                if(i % 2) {
+                    const Matrix4& transformation = panels.transformation(panelId(random));
+                    fingertips[i] = transformation.transformPoint({offset(random), offset(random), 0.0f}) +
+                        transformation.backward().normalized()*(unit(random)*TouchQueryRadius);
+                } else fingertips[i] = Vector3{unit(random), unit(random), unit(random)}*5.0f;
+            }
+
+            PanelRegistry::Hit bvh[HandSnapshot::MaxFingertips*2];
+            const UnsignedLong testsBefore = panels.panelTestCount();
+            start = std::chrono::high_resolution_clock::now();
+            panels.querySpheres({fingertips, HandSnapshot::MaxFingertips}, TouchQueryRadius, {bvh, HandSnapshot::MaxFingertips});
+            for(UnsignedInt i = 0; i != HandSnapshot::MaxFingertips; ++i)
+                bvh[HandSnapshot::MaxFingertips + i] = panels.queryRay({}, fingertips[i].normalized(), PointerDistance);
+            bvhTime += std::chrono::high_resolution_clock::now() - start;
+            bvhTests += panels.panelTestCount() - testsBefore;
+
+            PanelRegistry::Hit bruteForce[HandSnapshot::MaxFingertips*2];
+            start = std::chrono::high_resolution_clock::now();
+            for(UnsignedInt i = 0; i != HandSnapshot::MaxFingertips; ++i) {
+                bruteForce[i] = bruteForceSphere(panels, fingertips[i]);
+                bruteForce[HandSnapshot::MaxFingertips + i] = bruteForceRay(panels, {}, fingertips[i].normalized());
+            }
+            bruteForceTime += std::chrono::high_resolution_clock::now() - start;
+
+            for(UnsignedInt i = 0; i != HandSnapshot::MaxFingertips*2; ++i) {
+                if(bvh[i].panel != -1) ++hits;
+                if(bvh[i].panel != bruteForce[i].panel) ++mismatches;
+            }
+
+            /* Look around from the origin */
+            const Matrix4 head = Matrix4::rotationY(Deg(yaw(random)))*Matrix4::rotationX(Deg(pitch(random)));
+            Matrix4 viewProjection[2];
+            for(Int eye: {0, 1})
+                viewProjection[eye] = EyeProjection*(head*Matrix4::translation(Vector3::xAxis((eye ? 0.5f : -0.5f)*EyeDistance))).inverted();
+
+            start = std::chrono::high_resolution_clock::now();
+            const StereoFrustum frustum{viewProjection[0], viewProjection[1]};
+            panels.cull(frustum, {cullMasks.data(), count});
+            cullTime += std::chrono::high_resolution_clock::now() - start;
+            cullNodes += panels.cullStats().nodesTested;
+            cullPanels += panels.cullStats().panelsTested;
+            visible += panels.cullStats().visible;
+
+            start = std::chrono::high_resolution_clock::now();
+            for(UnsignedInt id = 0; id != count; ++id) {
+                const Range3D& bounds = panels.bounds(id);
+                bruteForceMasks[id] =
+                    (frustum.test(0, bounds) != StereoFrustum::Test::Outside ? StereoFrustum::LeftEye : 0)|
+                    (frustum.test(1, bounds) != StereoFrustum::Test::Outside ? StereoFrustum::RightEye : 0);
+            }
+            bruteForceCullTime += std::chrono::high_resolution_clock::now() - start;
+
+            for(UnsignedInt id = 0; id != count; ++id)
+                if(cullMasks[id] != bruteForceMasks[id]) ++cullMismatches;
+        }
+
+        const Double queries = Double(frames)*HandSnapshot::MaxFingertips*2;
+        std::printf("%s  \"%u\": {\"nodes\": %zu, \"buildMs\": %.3f, \"refitUs\": %.2f, "
+            "\"bvhUs\": %.2f, \"bruteForceUs\": %.2f, \"testsPerQuery\": %.2f, "
+            "\"hits\": %llu, \"mismatches\": %llu, "
+            "\"cullUs\": %.2f, \"bruteForceCullUs\": %.2f, \"cullNodesTested\": %.2f, "
+            "\"cullPanelsTested\": %.2f, \"visible\": %.2f, \"cullMismatches\": %llu}",
+            first ? "" : ",\n", count, panels.nodeCount(), buildMs,
+            std::chrono::duration<Double, std::micro>(refitTime).count()/frames,
+            std::chrono::duration<Double, std::micro>(bvhTime).count()/frames,
+            std::chrono::duration<Double, std::micro>(bruteForceTime).count()/frames,
+            bvhTests/queries,
+            static_cast<unsigned long long>(hits), static_cast<unsigned long long>(mismatches),
+            std::chrono::duration<Double, std::micro>(cullTime).count()/frames,
+            std::chrono::duration<Double, std::micro>(bruteForceCullTime).count()/frames,
+            Double(cullNodes)/frames, Double(cullPanels)/frames, Double(visible)/frames,
+            static_cast<unsigned long long>(cullMismatches));
+        first = false;
+    }
+    std::printf("\n}\n");
+
+    return 0;
+}
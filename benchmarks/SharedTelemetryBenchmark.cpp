@@ -0,0 +1,244 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+#include <Corrade/Utility/Arguments.h>
+
+#include <Magnum/Magnum.h>
+
+#include "TelemetryExporter.h"
+#include "TelemetryReader.h"
+
+namespace Magnum {
+
+namespace {
+
+/* Frame budget of a 90 Hz HMD, in nanoseconds */
+constexpr Double FrameBudget = 11.1e6;
+
+constexpr const char RegionName[] = "magnum-vr-ui-telemetry-benchmark";
+
+/* Fills every field like Gallery does, with two fully tracked hands */
+void fillFrame(SharedTelemetry::Frame& frame, const UnsignedLong index) {
+    frame.frameIndex = index;
+    frame.timestamp = UnsignedLong(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    frame.handTimestamp = index*11111;
+    for(Int i = 0; i != 8; ++i) {
+        frame.headPose[i] = Float(i);
+        frame.eyePoses[0][i] = Float(i);
+        frame.eyePoses[1][i] = Float(i);
+    }
+    frame.cpuTime = 2000;
+    frame.poseAge = 3000;
+    frame.drawCalls = 8;
+    frame.estimatedStateChanges = 20;
+    frame.resolutionScale = 1.0f;
+    frame.flags = SharedTelemetry::HandsTracked;
+    for(Int i: {0, 1}) {
+        frame.touchPanel[i] = -1;
+        frame.touchEvent[i] = 0;
+        frame.touchPosition[i][0] = frame.touchPosition[i][1] = frame.touchPosition[i][2] = 0.0f;
+    }
+    frame.handCount = 2;
+    frame.jointCount = HandSnapshot::MaxJoints;
+    frame.rightHandMask = 1;
+    frame.reserved = 0;
+    for(UnsignedInt joint = 0; joint != HandSnapshot::MaxJoints; ++joint) {
+        frame.jointHand[joint] = UnsignedByte(joint/HandSnapshot::MaxJointsPerHand);
+        frame.joints[joint][0] = Float(joint);
+        frame.joints[joint][1] = Float(index);
+        frame.joints[joint][2] = -Float(joint);
+    }
+}
+
+struct WriteResult {
+    Double nsPerFrame;
+    Double maxNs;
+};
+
+/* Writes frames in batches, timing each batch so the clock overhead doesn't
+   dominate */
+WriteResult writeFrames(TelemetryExporter& exporter, const UnsignedLong frames) {
+    constexpr UnsignedLong BatchSize = 64;
+    WriteResult result{};
+    std::chrono::high_resolution_clock::duration total{};
+    for(UnsignedLong i = 0; i < frames; i += BatchSize) {
+        const auto start = std::chrono::high_resolution_clock::now();
+        for(UnsignedLong j = 0; j != BatchSize; ++j) {
+            fillFrame(exporter.beginFrame(), exporter.writeCount());
+            exporter.endFrame();
+        }
+        const auto elapsed = std::chrono::high_resolution_clock::now() - start;
+        total += elapsed;
+        result.maxNs = std::max(result.maxNs, std::chrono::duration<Double, std::nano>(elapsed).count()/BatchSize);
+    }
+    result.nsPerFrame = std::chrono::duration<Double, std::nano>(total).count()/exporter.writeCount();
+    return result;
+}
+
+struct ReadResult {
+    UnsignedLong read, lost, torn;
+};
+
+/* Copies frames out through the cursor, checking that each is consistent */
+void copyingReader(TelemetryReader& reader, const std::atomic<bool>& done, ReadResult& result) {
+    SharedTelemetry::Frame frame;
+    for(;;) {
+        const TelemetryReader::Status status = reader.next(frame);
+        if(status == TelemetryReader::Status::Pending) {
+            if(done.load(std::memory_order_acquire) && reader.cursor() == reader.writeCount()) break;
+            continue;
+        }
+        if(status != TelemetryReader::Status::Ok) continue;
+
+        ++result.read;
+        if(frame.joints[HandSnapshot::MaxJoints - 1][1] != Float(frame.frameIndex))
+            ++result.torn;
+    }
+    result.lost = reader.overrunCount();
+}
+
+/* Reads frames in place without copying them */
+void zeroCopyReader(TelemetryReader& reader, const std::atomic<bool>& done, ReadResult& result) {
+    UnsignedLong cursor = 0;
+    for(;;) {
+        const UnsignedLong written = reader.writeCount();
+        if(cursor == written) {
+            if(done.load(std::memory_order_acquire) && cursor == reader.writeCount()) break;
+            continue;
+        }
+        if(written - cursor > reader.capacity()) {
+            result.lost += written - reader.capacity() - cursor;
+            cursor = written - reader.capacity();
+        }
+
+        const SharedTelemetry::Frame* const frame = reader.view(cursor);
+        const bool consistent = frame && frame->joints[HandSnapshot::MaxJoints - 1][1] == Float(frame->frameIndex);
+        if(frame && reader.isIntact(cursor)) {
+            ++result.read;
+            if(!consistent) ++result.torn;
+        } else ++result.lost;
+        ++cursor;
+    }
+}
+
+}
+
+}
+
+/* Measures the cost of exporting a telemetry frame into shared memory, alone
+   and with a reader in another thread polling as fast as it can, together
+   with how many frames the reader gets and loses. The writer runs
+   unthrottled, orders of magnitude faster than the 90 frames per second of
+   the gallery, so lost frames there only show the ring is safe to overrun.
+   A last run paces the writer to a fixed rate, where a reader is expected to
+   lose nothing. */
+int main(int argc, char** argv) {
+    using namespace Magnum;
+
+    Utility::Arguments args;
+    args.addOption("frames", "1000000").setHelp("frames", "count of frames written in each mode", "N")
+        .addOption("capacity", "1024").setHelp("capacity", "ring buffer slot count", "N")
+        .addOption("paced-rate", "1000").setHelp("paced-rate", "frame rate of the paced writer in Hz", "RATE")
+        .addOption("paced-frames", "1000").setHelp("paced-frames", "count of frames written by the paced writer", "N")
+        .parse(argc, argv);
+
+    const UnsignedLong frames = args.value<UnsignedLong>("frames");
+    const UnsignedInt capacity = args.value<UnsignedInt>("capacity");
+    const Float pacedRate = args.value<Float>("paced-rate");
+    const UnsignedInt pacedFrames = args.value<UnsignedInt>("paced-frames");
+
+    std::printf("{\n");
+    std::printf("  \"frameSize\": %u,\n", UnsignedInt(sizeof(SharedTelemetry::Frame)));
+
+    {
+        TelemetryExporter exporter{RegionName, capacity};
+        if(!exporter.isOpen()) return 1;
+        std::printf("  \"capacity\": %u,\n", exporter.capacity());
+
+        const WriteResult write = writeFrames(exporter, frames);
+        std::printf("  \"noReader\": {\"nsPerFrame\": %.2f, \"maxNsPerFrame\": %.2f, \"budgetFraction\": %.8f},\n",
+            write.nsPerFrame, write.maxNs, write.nsPerFrame/FrameBudget);
+    }
+
+    for(const bool copying: {true, false}) {
+        TelemetryExporter exporter{RegionName, capacity};
+        TelemetryReader reader{RegionName};
+        if(!exporter.isOpen() || !reader.isOpen()) return 1;
+
+        std::atomic<bool> done{false};
+        ReadResult read{};
+        std::thread thread{copying ? copyingReader : zeroCopyReader, std::ref(reader), std::cref(done), std::ref(read)};
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        const WriteResult write = writeFrames(exporter, frames);
+        done.store(true, std::memory_order_release);
+        thread.join();
+        const Double seconds = std::chrono::duration<Double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::printf("  \"%s\": {\"nsPerFrame\": %.2f, \"maxNsPerFrame\": %.2f, \"budgetFraction\": %.8f, \"readPerSecond\": %.0f, \"read\": %llu, \"lost\": %llu, \"torn\": %llu},\n",
+            copying ? "copying" : "zeroCopy", write.nsPerFrame, write.maxNs, write.nsPerFrame/FrameBudget,
+            read.read/seconds,
+            static_cast<unsigned long long>(read.read),
+            static_cast<unsigned long long>(read.lost),
+            static_cast<unsigned long long>(read.torn));
+    }
+
+    {
+        TelemetryExporter exporter{RegionName, capacity};
+        TelemetryReader reader{RegionName};
+        if(!exporter.isOpen() || !reader.isOpen()) return 1;
+
+        std::atomic<bool> done{false};
+        ReadResult read{};
+        std::thread thread{copyingReader, std::ref(reader), std::cref(done), std::ref(read)};
+
+        const std::chrono::nanoseconds period{UnsignedLong(1.0e9/pacedRate)};
+        auto next = std::chrono::steady_clock::now();
+        for(UnsignedInt i = 0; i != pacedFrames; ++i) {
+            next += period;
+            std::this_thread::sleep_until(next);
+            fillFrame(exporter.beginFrame(), i);
+            exporter.endFrame();
+        }
+        done.store(true, std::memory_order_release);
+        thread.join();
+
+        std::printf("  \"paced\": {\"rate\": %.1f, \"written\": %u, \"read\": %llu, \"lost\": %llu, \"torn\": %llu}\n",
+            Double(pacedRate), pacedFrames,
+            static_cast<unsigned long long>(read.read),
+            static_cast<unsigned long long>(read.lost),
+            static_cast<unsigned long long>(read.torn));
+    }
+
+    std::printf("}\n");
+    return 0;
+}
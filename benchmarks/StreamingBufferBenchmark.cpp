@@ -0,0 +1,142 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <chrono>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Arguments.h>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Renderer.h>
+#ifdef CORRADE_TARGET_APPLE
+#include <Magnum/Platform/WindowlessCglApplication.h>
+#elif defined(CORRADE_TARGET_WINDOWS)
+#include <Magnum/Platform/WindowlessWglApplication.h>
+#else
+#include <Magnum/Platform/WindowlessGlxApplication.h>
+#endif
+
+#include "StreamingBuffer.h"
+
+namespace Magnum {
+
+/* Compares uploading per-frame dynamic data with GL::Buffer::setData()
+   into a separate buffer per upload, like the hand instance buffers used to,
+   against StreamingBuffer with orphaning and with persistent mapping. Every
+   upload is then read by the GPU with a buffer copy, so the GPU actually
+   depends on the data like a draw would, and the frames are flushed but not
+   finished, so up to a few frames can be in flight. */
+class StreamingBufferBenchmark: public Platform::WindowlessApplication {
+    public:
+        explicit StreamingBufferBenchmark(const Arguments& arguments);
+
+        int exec() override;
+
+    private:
+        enum class Mode { SetData, Orphaning, PersistentMapping };
+
+        void benchmark(Mode mode, std::size_t frameSize);
+
+        Int _frames, _uploads;
+        GL::Buffer _sink;
+};
+
+StreamingBufferBenchmark::StreamingBufferBenchmark(const Arguments& arguments): Platform::WindowlessApplication{arguments} {
+    Utility::Arguments args;
+    args.addOption("frames", "1000").setHelp("frames", "count of frames to run for each mode and size", "N")
+        .addOption("uploads", "8").setHelp("uploads", "count of uploads per frame", "N")
+        .addSkippedPrefix("magnum", "engine-specific options")
+        .parse(arguments.argc, arguments.argv);
+    _frames = args.value<Int>("frames");
+    _uploads = args.value<Int>("uploads");
+}
+
+void StreamingBufferBenchmark::benchmark(const Mode mode, const std::size_t frameSize) {
+    const std::size_t uploadSize = frameSize/_uploads;
+    Containers::Array<char> data{Containers::ValueInit, uploadSize};
+    _sink.setData({nullptr, uploadSize}, GL::BufferUsage::StaticCopy);
+
+    std::vector<GL::Buffer> buffers;
+    StreamingBuffer stream{NoCreate};
+    if(mode == Mode::SetData) {
+        for(Int i = 0; i != _uploads; ++i) buffers.emplace_back();
+    } else stream = StreamingBuffer{frameSize, mode == Mode::PersistentMapping ?
+        StreamingBuffer::Mode::PersistentMapping : StreamingBuffer::Mode::Orphaning};
+
+    GL::Renderer::finish();
+    std::chrono::high_resolution_clock::duration cpuTime{};
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(Int frame = 0; frame != _frames; ++frame) {
+        /* Make every frame's data different so nothing can be skipped */
+        data[0] = char(frame);
+
+        const auto frameStart = std::chrono::high_resolution_clock::now();
+        if(mode == Mode::SetData) {
+            for(GL::Buffer& buffer: buffers) {
+                buffer.setData(data, GL::BufferUsage::StreamDraw);
+                GL::Buffer::copy(buffer, _sink, 0, 0, uploadSize);
+            }
+        } else {
+            stream.beginFrame();
+            for(Int i = 0; i != _uploads; ++i) {
+                const std::size_t offset = stream.upload(data, 16);
+                GL::Buffer::copy(stream.buffer(), _sink, offset, 0, uploadSize);
+            }
+        }
+        cpuTime += std::chrono::high_resolution_clock::now() - frameStart;
+
+        GL::Renderer::flush();
+    }
+    GL::Renderer::finish();
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    const char* name = mode == Mode::SetData ? "setData:   " :
+        mode == Mode::Orphaning ? "orphaning: " : "persistent:";
+    Debug d;
+    d << name << frameSize/1024 << "KiB per frame in" << _uploads << "uploads, CPU"
+        << std::chrono::duration<Double, std::micro>(cpuTime).count()/_frames << "µs per frame, total"
+        << std::chrono::duration<Double, std::micro>(end - start).count()/_frames << "µs per frame";
+    if(mode != Mode::SetData) d << Debug::nospace << "," << stream.fenceWaits() << "fence waits";
+}
+
+int StreamingBufferBenchmark::exec() {
+    const bool persistent = StreamingBuffer::isPersistentMappingSupported();
+    if(!persistent) Debug() << "Persistent mapping is not supported, skipping it";
+
+    /* Sizes of the hand instance data, of a hundred times that and of a
+       large dynamic mesh */
+    for(std::size_t frameSize: {std::size_t{16}*1024, std::size_t{1024}*1024, std::size_t{16}*1024*1024}) {
+        benchmark(Mode::SetData, frameSize);
+        benchmark(Mode::Orphaning, frameSize);
+        if(persistent) benchmark(Mode::PersistentMapping, frameSize);
+    }
+
+    return 0;
+}
+
+}
+
+MAGNUM_WINDOWLESSAPPLICATION_MAIN(Magnum::StreamingBufferBenchmark)
@@ -0,0 +1,97 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "SyntheticHandSource.h"
+
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "HandSnapshot.h"
+
+namespace Magnum {
+
+namespace {
+
+constexpr const UnsignedLong FrameDuration{11111};
+
+constexpr const Float BoneLength{25.0f};
+
+}
+
+Vector3 SyntheticHandSource::noise() {
+    if(_jitter == 0.0f) return {};
+
+    /* Numerical Recipes LCG, good enough for noise */
+    Vector3 out;
+    for(std::size_t i = 0; i != 3; ++i) {
+        _seed = _seed*1664525u + 1013904223u;
+        out[i] = (Float(_seed >> 8)/Float(1 << 24)*2.0f - 1.0f)*_jitter;
+    }
+    return out;
+}
+
+bool SyntheticHandSource::doFrame(HandSnapshot& hands) {
+    hands.setTimestamp(_frame*FrameDuration);
+
+    /* Out of view, the tracking still delivers frames, just without hands */
+    if(_hiddenFrames && _frame % (_visibleFrames + _hiddenFrames) >= _visibleFrames) {
+        ++_frame;
+        return true;
+    }
+
+    /* Right index fingertip moves up and down by 40 mm around the UI plane,
+       which is 400 mm above the device, roughly once per second */
+    const Float height = 400.0f + 40.0f*Math::sin(Rad(Float(_frame)*0.07f));
+
+    for(const bool right: {true, false}) {
+        const UnsignedInt id = hands.addHand(right);
+
+        /* Fingers point along negative Z, 20 mm apart, index finger of the
+           right hand at X = -200 mm */
+        const Vector3 origin = Vector3{right ? -220.0f : 120.0f, height, 600.0f + 4*BoneLength} + noise();
+
+        for(UnsignedInt finger = 0; finger != HandSnapshot::FingerCount; ++finger) {
+            for(Int b = 0; b != 4; ++b) {
+                /* Same bones as LeapHandSource leaves out for middle and
+                   ring finger */
+                if(b == 0 && (finger == HandSnapshot::Middle || finger == HandSnapshot::Ring)) continue;
+
+                const Vector3 prevJoint = origin + Vector3{finger*20.0f, 0.0f, -b*BoneLength} + noise();
+                const Vector3 nextJoint = prevJoint + Vector3::zAxis(-BoneLength);
+                hands.addBone(id, (prevJoint + nextJoint)*0.5f,
+                    Vector3::xAxis(), Vector3::yAxis(), Vector3::zAxis(), BoneLength);
+                hands.addJoint(id, prevJoint);
+                if(b == 3) {
+                    hands.addJoint(id, nextJoint);
+                    hands.setFingertip(id, finger, nextJoint);
+                }
+            }
+        }
+    }
+
+    ++_frame;
+    return true;
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_SyntheticHandSource_h
+#define Magnum_VrUi_SyntheticHandSource_h
+
+#include <Magnum/Math/Vector3.h>
+
+#include "AbstractHandSource.h"
+
+namespace Magnum {
+
+/**
+@brief Synthetic hand source
+
+Two hands in Leap Motion tracking space with the same bone and joint counts
+as @ref LeapHandSource produces, deterministically animated so that the
+right index finger repeatedly pokes through the gallery UI plane. Every
+@ref frame() advances the animation by one 90 Hz frame, so benchmark runs
+are reproducible without a tracking device or a capture. Optionally,
+pseudo-random jitter resembling tracking noise can be added to all
+positions, and the hands can periodically leave the tracking area.
+*/
+class SyntheticHandSource: public AbstractHandSource {
+    public:
+        explicit SyntheticHandSource() = default;
+
+        /** @brief Jitter amplitude, in millimeters */
+        Float jitter() const { return _jitter; }
+
+        /**
+         * @brief Set jitter amplitude
+         *
+         * Each coordinate gets a uniformly distributed offset in the
+         * @f$ [-a, a] @f$ range. The sequence is the same every run.
+         * Default is @cpp 0.0f @ce.
+         */
+        SyntheticHandSource& setJitter(Float amplitude) {
+            _jitter = amplitude;
+            return *this;
+        }
+
+        /** @brief Count of frames the hands are visible in each cycle */
+        UnsignedInt visibleFrames() const { return _visibleFrames; }
+
+        /** @brief Count of frames the hands are out of view in each cycle */
+        UnsignedInt hiddenFrames() const { return _hiddenFrames; }
+
+        /**
+         * @brief Set how long the hands are visible and out of view
+         *
+         * The hands are visible for @p visible frames, then out of view for
+         * @p hidden frames, and so on, starting with visible ones. The
+         * animation continues also while they're out of view. Default is
+         * @cpp 1 @ce and @cpp 0 @ce, so they're always visible.
+         */
+        SyntheticHandSource& setVisibility(UnsignedInt visible, UnsignedInt hidden) {
+            _visibleFrames = visible;
+            _hiddenFrames = hidden;
+            return *this;
+        }
+
+    private:
+        Vector3 noise();
+
+        bool doIsConnected() const override { return true; }
+        bool doFrame(HandSnapshot& hands) override;
+
+        UnsignedLong _frame{};
+        Float _jitter{};
+        UnsignedInt _visibleFrames{1}, _hiddenFrames{};
+        UnsignedInt _seed{1};
+};
+
+}
+
+#endif
@@ -0,0 +1,175 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <chrono>
+#include <string>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Arguments.h>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector3.h>
+#ifdef CORRADE_TARGET_APPLE
+#include <Magnum/Platform/WindowlessCglApplication.h>
+#elif defined(CORRADE_TARGET_WINDOWS)
+#include <Magnum/Platform/WindowlessWglApplication.h>
+#else
+#include <Magnum/Platform/WindowlessGlxApplication.h>
+#endif
+
+#include "GalleryUi.h"
+#include "TelemetryPanel.h"
+
+namespace Magnum {
+
+/* Compares per-frame cost of updating the gallery fingertip telemetry with
+   std::to_string() and Ui::Input::setValue() every frame against
+   TelemetryPanel, both unlimited and rate-limited. The fingertip moves
+   slowly, so some of the values stay the same for several frames, like with
+   a real hand hovering in front of the UI. */
+class TelemetryBenchmark: public Platform::WindowlessApplication {
+    public:
+        explicit TelemetryBenchmark(const Arguments& arguments);
+
+        int exec() override;
+
+    private:
+        enum class Mode { SetValue, Panel, RateLimitedPanel };
+
+        static Vector3 fingertip(Int frame);
+
+        void benchmark(Mode mode);
+
+        Int _frames;
+        GL::Renderbuffer _color;
+        GL::Framebuffer _framebuffer{NoCreate};
+        Containers::Optional<Ui::UserInterface> _ui;
+        Containers::Optional<BaseUiPlane> _plane;
+};
+
+TelemetryBenchmark::TelemetryBenchmark(const Arguments& arguments): Platform::WindowlessApplication{arguments} {
+    Utility::Arguments args;
+    args.addOption("frames", "1000").setHelp("frames", "count of frames to run for each mode", "N")
+        .addSkippedPrefix("magnum", "engine-specific options")
+        .parse(arguments.argc, arguments.argv);
+    _frames = args.value<Int>("frames");
+
+    const Vector2i size{1024, 1024};
+    _color.setStorage(GL::RenderbufferFormat::RGBA8, size);
+    _framebuffer = GL::Framebuffer{{{}, size}};
+    _framebuffer.attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, _color)
+                .bind();
+
+    GL::Renderer::enable(GL::Renderer::Feature::Blending);
+    GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+
+    _ui.emplace(Vector2{1024.0f, 1024.0f}, size, Ui::mcssDarkStyleConfiguration(), "»");
+    _plane.emplace(*_ui);
+}
+
+Vector3 TelemetryBenchmark::fingertip(const Int frame) {
+    /* A few millimeters of drift per second at 90 FPS */
+    const Float t = frame/90.0f;
+    return {0.01f*Math::sin(Rad(t)), 0.005f*Math::cos(Rad(t*0.7f)), 0.02f + 0.002f*Math::sin(Rad(t*1.3f))};
+}
+
+void TelemetryBenchmark::benchmark(const Mode mode) {
+    TelemetryPanel telemetry;
+    telemetry.addField(_plane->inputDefault, 6);
+    telemetry.addField(_plane->inputDanger, 6);
+    telemetry.addField(_plane->inputSuccess, 6);
+    telemetry.addField(_plane->inputWarning, 6);
+    telemetry.addField(_plane->inputFlat, 6);
+    if(mode == Mode::RateLimitedPanel) telemetry.setMaxRefreshRate(30.0f);
+
+    /* Simulated 90 FPS clock to make the rate limiting deterministic */
+    const std::chrono::steady_clock::time_point epoch;
+    const std::chrono::microseconds frameDuration{11111};
+
+    std::chrono::high_resolution_clock::duration updateTime{}, drawTime{};
+    UnsignedLong setValueCount{};
+    for(Int frame = 0; frame != _frames; ++frame) {
+        const Vector3 screenSpace = fingertip(frame);
+        const Vector2i screenPos{Int((screenSpace.x() + 0.5f)*1024),
+                                 Int((-screenSpace.y() + 0.5f)*1024)};
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        if(mode == Mode::SetValue) {
+            _plane->inputDefault.setValue(std::to_string(screenPos.x()));
+            _plane->inputDanger.setValue(std::to_string(screenPos.y()));
+            _plane->inputSuccess.setValue(std::to_string(screenSpace.x()).substr(0, 6));
+            _plane->inputWarning.setValue(std::to_string(screenSpace.y()).substr(0, 6));
+            _plane->inputFlat.setValue(std::to_string(screenSpace.z()).substr(0, 6));
+            setValueCount += 5;
+        } else telemetry
+            .set(0, screenPos.x())
+            .set(1, screenPos.y())
+            .set(2, screenSpace.x())
+            .set(3, screenSpace.y())
+            .set(4, screenSpace.z())
+            .flush(epoch + frame*frameDuration);
+        const auto updated = std::chrono::high_resolution_clock::now();
+
+        /* Text reshaping results are uploaded on draw */
+        _ui->draw();
+        const auto drawn = std::chrono::high_resolution_clock::now();
+
+        updateTime += updated - start;
+        drawTime += drawn - updated;
+
+        GL::Renderer::finish();
+    }
+
+    if(mode != Mode::SetValue) setValueCount = telemetry.updateCount();
+
+    const Double frames = _frames;
+    Debug() << (mode == Mode::SetValue ? "setValue() every frame:" :
+                mode == Mode::Panel ?    "TelemetryPanel:        " :
+                                         "TelemetryPanel, 30 Hz: ")
+        << setValueCount/frames << "widget updates, update"
+        << std::chrono::duration<Double, std::micro>(updateTime).count()/frames << "µs, UI draw"
+        << std::chrono::duration<Double, std::micro>(drawTime).count()/frames << "µs per frame";
+}
+
+int TelemetryBenchmark::exec() {
+    /* Warm up the glyph cache and buffers */
+    _plane->inputDefault.setValue("000000");
+    _ui->draw();
+    GL::Renderer::finish();
+
+    benchmark(Mode::SetValue);
+    benchmark(Mode::Panel);
+    benchmark(Mode::RateLimitedPanel);
+
+    return 0;
+}
+
+}
+
+MAGNUM_WINDOWLESSAPPLICATION_MAIN(Magnum::TelemetryBenchmark)
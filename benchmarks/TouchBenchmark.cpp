@@ -0,0 +1,182 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <Corrade/Utility/Arguments.h>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include "FingertipTouch.h"
+#include "HandReplay.h"
+#include "HandSnapshot.h"
+#include "SyntheticHandSource.h"
+
+namespace Magnum {
+
+using namespace Math::Literals;
+
+namespace {
+
+/* Presses starting this soon after a release are most likely caused by
+   jitter and not by the user */
+constexpr const UnsignedLong BounceInterval{100000};
+
+/* Same mapping of tracking space to the UI plane as in Gallery, with the
+   head at the origin */
+const Matrix4 ToWorldSpace = Matrix4::rotationX(-90.0_degf)*Matrix4::scaling(0.001f*Vector3{-1.0f, 1.0f, -1.0f});
+const Vector3 UiPosition{0.2f, -0.6f, -0.4f};
+
+/* The touch detection as it was before FingertipTouch, with no filtering
+   and no hysteresis */
+struct RawTouch {
+    FingertipTouch::Event update(const Vector3& position) {
+        if(Math::abs(position.z()) < 0.008f) {
+            if(pressed) return FingertipTouch::Event::Move;
+            pressed = true;
+            return FingertipTouch::Event::Press;
+        }
+
+        if(!pressed) return FingertipTouch::Event::None;
+        pressed = false;
+        return FingertipTouch::Event::Release;
+    }
+
+    bool pressed{};
+};
+
+struct Stats {
+    void add(FingertipTouch::Event event, UnsignedLong timestamp) {
+        if(event == FingertipTouch::Event::Press) {
+            ++presses;
+            if(released && timestamp - lastRelease < BounceInterval) ++bounces;
+        } else if(event == FingertipTouch::Event::Release) {
+            released = true;
+            lastRelease = timestamp;
+        }
+    }
+
+    void print(const char* name, bool last) const {
+        std::printf("  \"%s\": {\"presses\": %llu, \"bounces\": %llu",
+            name, static_cast<unsigned long long>(presses), static_cast<unsigned long long>(bounces));
+        if(samples) std::printf(", \"latencyMs\": {\"mean\": %.2f, \"max\": %.2f}",
+            latencySum/samples*1000.0, latencyMax*1000.0);
+        std::printf("}%s\n", last ? "" : ",");
+    }
+
+    UnsignedLong presses{}, bounces{};
+    bool released{};
+    UnsignedLong lastRelease{};
+    Double latencySum{};
+    Float latencyMax{};
+    UnsignedLong samples{};
+};
+
+}
+
+}
+
+/* Runs fingertip touch detection of the right index finger over recorded or
+   synthetic hand data, without any rendering, and compares the unfiltered
+   detection with FingertipTouch with and without prediction. Bounces are
+   presses shortly after a release, which with a finger held close to the
+   UI are practically always caused by tracking jitter. */
+int main(int argc, char** argv) {
+    using namespace Magnum;
+
+    Utility::Arguments args;
+    args.addOption("replay").setHelp("replay", "analyze a hand capture instead of synthetic hands", "FILE")
+        .addOption("frames", "1000").setHelp("frames", "count of synthetic frames", "N")
+        .addOption("jitter", "3.0").setHelp("jitter", "jitter amplitude of synthetic hands in millimeters", "MM")
+        .addOption("prediction", "0.015").setHelp("prediction", "prediction time in seconds", "SECONDS")
+        .parse(argc, argv);
+
+    std::unique_ptr<AbstractHandSource> source;
+    Int frames;
+    if(!args.value("replay").empty()) {
+        std::unique_ptr<HandReplay> replay{new HandReplay{args.value("replay")}};
+        if(!replay->isConnected()) {
+            Error() << "Cannot replay" << args.value("replay");
+            return 1;
+        }
+        frames = replay->frameCount();
+        source = std::move(replay);
+    } else {
+        std::unique_ptr<SyntheticHandSource> synthetic{new SyntheticHandSource};
+        synthetic->setJitter(args.value<Float>("jitter"));
+        frames = args.value<Int>("frames");
+        source = std::move(synthetic);
+    }
+
+    RawTouch raw;
+    FingertipTouch filtered, predicted;
+    filtered.setPrediction(0.0f);
+    predicted.setPrediction(args.value<Float>("prediction"));
+
+    Stats rawStats, filteredStats, predictedStats;
+    HandSnapshot hands;
+    Int trackedFrames{};
+    for(Int i = 0; i != frames; ++i) {
+        if(!source->frame(hands)) break;
+        hands.computeTransformations(ToWorldSpace);
+
+        const UnsignedLong timestamp = hands.timestamp();
+        const Int hand = hands.hand(true);
+        if(hand == -1) {
+            rawStats.add(raw.pressed ? FingertipTouch::Event::Release : FingertipTouch::Event::None, timestamp);
+            raw.pressed = false;
+            filteredStats.add(filtered.lose(), timestamp);
+            predictedStats.add(predicted.lose(), timestamp);
+            continue;
+        }
+
+        ++trackedFrames;
+        const Vector3 position = hands.worldFingertip(hand, HandSnapshot::Index) - UiPosition;
+        rawStats.add(raw.update(position), timestamp);
+        filteredStats.add(filtered.update(position, timestamp), timestamp);
+        predictedStats.add(predicted.update(position, timestamp), timestamp);
+
+        for(std::pair<Stats*, FingertipTouch*> s: {std::make_pair(&filteredStats, &filtered),
+                                                   std::make_pair(&predictedStats, &predicted)}) {
+            const Float latency = s.second->estimatedLatency();
+            s.first->latencySum += latency;
+            s.first->latencyMax = Math::max(s.first->latencyMax, latency);
+            ++s.first->samples;
+        }
+    }
+
+    std::printf("{\n");
+    std::printf("  \"handSource\": \"%s\",\n", args.value("replay").empty() ? "synthetic" : "replay");
+    std::printf("  \"trackedFrames\": %d,\n", trackedFrames);
+    rawStats.print("raw", false);
+    filteredStats.print("filtered", false);
+    predictedStats.print("predicted", true);
+    std::printf("}\n");
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Arguments.h>
+
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Renderer.h>
+#ifdef CORRADE_TARGET_APPLE
+#include <Magnum/Platform/WindowlessCglApplication.h>
+#elif defined(CORRADE_TARGET_WINDOWS)
+#include <Magnum/Platform/WindowlessWglApplication.h>
+#else
+#include <Magnum/Platform/WindowlessGlxApplication.h>
+#endif
+#include <Magnum/Ui/Button.h>
+#include <Magnum/Ui/Input.h>
+#include <Magnum/Ui/Label.h>
+#include <Magnum/Ui/Plane.h>
+#include <Magnum/Ui/UserInterface.h>
+
+#include "AllocationCounter.h"
+#include "GalleryUi.h"
+#include "UiPanel.h"
+
+namespace Magnum {
+
+/* Builds and tears down UI planes of 100, 1000 and 10000 widgets, once with
+   every widget allocated separately like hand-written planes do, and once
+   with UiPanel, and compares build, first draw and teardown time together
+   with heap allocation counts. Both use the same automatically calculated
+   plane capacities, as the hand-tuned ones don't scale to these sizes. */
+class UiPanelBenchmark: public Platform::WindowlessApplication {
+    public:
+        explicit UiPanelBenchmark(const Arguments& arguments);
+
+        int exec() override;
+
+    private:
+        enum class Mode { Separate, Panel };
+
+        static std::vector<UiPanel::WidgetDescription> describe(std::size_t count);
+
+        void benchmark(Mode mode, std::size_t count);
+
+        Int _repeats;
+        GL::Renderbuffer _color;
+        GL::Framebuffer _framebuffer{NoCreate};
+        Containers::Optional<Ui::UserInterface> _ui;
+};
+
+UiPanelBenchmark::UiPanelBenchmark(const Arguments& arguments): Platform::WindowlessApplication{arguments} {
+    Utility::Arguments args;
+    args.addOption("repeats", "10").setHelp("repeats", "count of builds and teardowns for each size", "N")
+        .addSkippedPrefix("magnum", "engine-specific options")
+        .parse(arguments.argc, arguments.argv);
+    _repeats = args.value<Int>("repeats");
+
+    const Vector2i size{1024, 1024};
+    _color.setStorage(GL::RenderbufferFormat::RGBA8, size);
+    _framebuffer = GL::Framebuffer{{{}, size}};
+    _framebuffer.attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, _color)
+                .bind();
+
+    GL::Renderer::enable(GL::Renderer::Feature::Blending);
+    GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+
+    _ui.emplace(Vector2{1024.0f, 1024.0f}, size, Ui::mcssDarkStyleConfiguration(), "»");
+}
+
+std::vector<UiPanel::WidgetDescription> UiPanelBenchmark::describe(const std::size_t count) {
+    /* Rows of ten widgets cycling through buttons, labels and inputs, like
+       a large settings page */
+    constexpr const char* Texts[]{"Apply", "Brightness", "Value", "Reset", "Contrast", "Default"};
+    constexpr Ui::Style Styles[]{Ui::Style::Default, Ui::Style::Primary, Ui::Style::Success, Ui::Style::Dim};
+
+    std::vector<UiPanel::WidgetDescription> widgets;
+    widgets.reserve(count);
+    for(std::size_t i = 0; i != count; ++i) {
+        const bool rowStart = i % 10 == 0;
+        const Ui::Snaps snaps = rowStart ? Ui::Snap::Top|Ui::Snap::Left : Ui::Snap::Right;
+        const Int relativeTo = rowStart ? Int(UiPanel::RelativeToPlane) : Int(i - 1);
+        const Range2D rect = rowStart ?
+            Range2D::fromSize(Vector2::yAxis(-WidgetHeight*(i/10 % 24)), ButtonSize) :
+            Range2D{{}, ButtonSize};
+        const char* const text = Texts[i % 6];
+        const Ui::Style style = Styles[i % 4];
+
+        switch(i % 3) {
+            case 0:
+                widgets.push_back(UiPanel::button(snaps, relativeTo, rect, text, style));
+                break;
+            case 1:
+                widgets.push_back(UiPanel::label(snaps, relativeTo, rect, text, Text::Alignment::LineCenterIntegral, style));
+                break;
+            case 2:
+                widgets.push_back(UiPanel::input(snaps, relativeTo, rect, text, 12, style));
+                break;
+        }
+    }
+
+    return widgets;
+}
+
+void UiPanelBenchmark::benchmark(const Mode mode, const std::size_t count) {
+    const std::vector<UiPanel::WidgetDescription> widgets = describe(count);
+    const Containers::ArrayView<const UiPanel::WidgetDescription> view{widgets.data(), widgets.size()};
+    const UiPanel::Capacity capacity = UiPanel::capacity(view);
+
+    std::chrono::high_resolution_clock::duration buildTime{}, drawTime{}, teardownTime{};
+    UnsignedLong buildAllocations{}, teardownAllocations{};
+    for(Int repeat = 0; repeat != _repeats; ++repeat) {
+        Containers::Optional<Ui::Plane> plane;
+        std::vector<std::unique_ptr<Ui::Widget>> separate;
+        Containers::Optional<UiPanel> panel;
+
+        const UnsignedLong allocationsBefore = AllocationCounter::count();
+        const auto start = std::chrono::high_resolution_clock::now();
+        if(mode == Mode::Separate) {
+            plane.emplace(*_ui, Ui::Snap::Top|Ui::Snap::Bottom|Ui::Snap::Left|Ui::Snap::Right,
+                capacity.background, capacity.foreground, capacity.text);
+            for(const UiPanel::WidgetDescription& widget: widgets) {
+                const Ui::Anchor anchor = widget.relativeTo == UiPanel::RelativeToPlane ?
+                    Ui::Anchor{widget.snaps, widget.rect} :
+                    Ui::Anchor{widget.snaps, *separate[widget.relativeTo], widget.rect};
+                if(widget.type == UiPanel::WidgetType::Button)
+                    separate.emplace_back(new Ui::Button{*plane, anchor, widget.text, widget.style});
+                else if(widget.type == UiPanel::WidgetType::Label)
+                    separate.emplace_back(new Ui::Label{*plane, anchor, widget.text, widget.alignment, widget.style});
+                else
+                    separate.emplace_back(new Ui::Input{*plane, anchor, widget.text, widget.maxValueSize, widget.style});
+            }
+        } else panel.emplace(*_ui, Ui::Snap::Top|Ui::Snap::Bottom|Ui::Snap::Left|Ui::Snap::Right, view);
+        const auto built = std::chrono::high_resolution_clock::now();
+        buildAllocations += AllocationCounter::count() - allocationsBefore;
+
+        /* Widget data are uploaded on first draw */
+        (plane ? static_cast<Ui::Plane&>(*plane) : *panel).activate();
+        _ui->draw();
+        GL::Renderer::finish();
+        const auto drawn = std::chrono::high_resolution_clock::now();
+
+        const UnsignedLong allocationsBeforeTeardown = AllocationCounter::count();
+        separate.clear();
+        plane = Containers::NullOpt;
+        panel = Containers::NullOpt;
+        const auto tornDown = std::chrono::high_resolution_clock::now();
+        teardownAllocations += AllocationCounter::count() - allocationsBeforeTeardown;
+
+        buildTime += built - start;
+        drawTime += drawn - built;
+        teardownTime += tornDown - drawn;
+    }
+
+    const Double repeats = _repeats;
+    Debug() << (mode == Mode::Separate ? "separate:" : "UiPanel: ") << count << "widgets, build"
+        << std::chrono::duration<Double, std::milli>(buildTime).count()/repeats << "ms with"
+        << buildAllocations/repeats << "allocations, first draw"
+        << std::chrono::duration<Double, std::milli>(drawTime).count()/repeats << "ms, teardown"
+        << std::chrono::duration<Double, std::milli>(teardownTime).count()/repeats << "ms with"
+        << teardownAllocations/repeats << "allocations";
+}
+
+int UiPanelBenchmark::exec() {
+    /* Allocations are counted through the hook in AllocationHook.cpp */
+    AllocationCounter::setEnabled(true);
+
+    /* Warm up the glyph cache and buffers with the gallery plane, which
+       also checks the calculated capacities are enough for it */
+    {
+        BaseUiPlane plane{*_ui};
+        _ui->draw();
+        GL::Renderer::finish();
+    }
+
+    for(std::size_t count: {100, 1000, 10000}) {
+        benchmark(Mode::Separate, count);
+        benchmark(Mode::Panel, count);
+    }
+
+    return 0;
+}
+
+}
+
+MAGNUM_WINDOWLESSAPPLICATION_MAIN(Magnum::UiPanelBenchmark)
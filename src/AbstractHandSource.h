@@ -0,0 +1,66 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_AbstractHandSource_h
+#define Magnum_VrUi_AbstractHandSource_h
+
+#include <Magnum/Magnum.h>
+
+namespace Magnum {
+
+class HandSnapshot;
+
+/**
+@brief Base for hand tracking input sources
+
+Decouples the frame loop from the tracking device. Implemented by
+@ref LeapHandSource for live input, @ref HandRecorder for capturing another
+source into a file and @ref HandReplay for playing such capture back.
+*/
+class AbstractHandSource {
+    public:
+        explicit AbstractHandSource() = default;
+
+        virtual ~AbstractHandSource();
+
+        /** @brief Whether the source is able to deliver frames */
+        bool isConnected() const { return doIsConnected(); }
+
+        /**
+         * @brief Fetch current frame
+         *
+         * Clears @p hands and fills it with hands of the current frame.
+         * Returns @cpp false @ce if no frame is available, for example if
+         * the device is not connected or a replay reached its end.
+         */
+        bool frame(HandSnapshot& hands);
+
+    private:
+        virtual bool doIsConnected() const = 0;
+        virtual bool doFrame(HandSnapshot& hands) = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_AbstractHmd_h
+#define Magnum_VrUi_AbstractHmd_h
+
+#include <chrono>
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/GL.h>
+#include <Magnum/Math/DualQuaternion.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
+
+namespace Magnum {
+
+/**
+@brief Base for head-mounted displays
+
+Everything the @ref Gallery frame loop needs from the VR runtime: eye
+projections, texture swap chains to render into, head tracking and frame
+submission. Implemented by @ref OvrHmd for the Oculus runtime and by
+@ref MockHmd for running the frame loop without a device.
+
+Eye targets are texture swap chains. There is either one target per eye, or
+a single target shared by both eyes side by side, see @ref setEyeViewport().
+
+A frame starts with @ref waitForFrame(), which paces the frame loop to the
+compositor. Poses can be polled more than once per frame, the ones polled
+last are used for the submitted frame.
+*/
+class AbstractHmd {
+    public:
+        explicit AbstractHmd() = default;
+
+        virtual ~AbstractHmd();
+
+        /** @brief Recommended eye texture size */
+        Vector2i eyeTextureSize(Int eye) const { return doEyeTextureSize(eye); }
+
+        /** @brief Eye projection matrix */
+        Matrix4 projectionMatrix(Int eye, Float near, Float far) const {
+            return doProjectionMatrix(eye, near, far);
+        }
+
+        /**
+         * @brief Create eye target
+         * @param target    Target ID, either @cpp 0 @ce or @cpp 1 @ce
+         * @param size      Texture size
+         */
+        void createEyeTarget(Int target, const Vector2i& size) {
+            doCreateEyeTarget(target, size);
+        }
+
+        /** @brief Texture of given eye target to render the current frame into */
+        GL::Texture2D& activeTexture(Int target) { return doActiveTexture(target); }
+
+        /** @brief Commit the rendered texture and advance the swap chain */
+        void commit(Int target) { doCommit(target); }
+
+        /** @brief Set which eye target and which part of it is shown to given eye */
+        void setEyeViewport(Int eye, Int target, const Range2Di& viewport) {
+            doSetEyeViewport(eye, target, viewport);
+        }
+
+        /**
+         * @brief Wait for the compositor frame boundary
+         *
+         * Blocks until the compositor is ready for a new frame, so the
+         * frame is rendered as close to being displayed as possible.
+         */
+        void waitForFrame() { doWaitForFrame(); }
+
+        /**
+         * @brief Poll head tracking
+         *
+         * Updates @ref eyePose(), @ref headPose() and @ref poseTime().
+         * Poses from the last call are then used for the frame submitted
+         * with @ref submitFrame().
+         */
+        void pollPoses() {
+            doPollPoses(_eyePoses, _headPose);
+            _poseTime = std::chrono::steady_clock::now();
+        }
+
+        /** @brief Time of last @ref pollPoses() */
+        std::chrono::steady_clock::time_point poseTime() const { return _poseTime; }
+
+        /** @brief Eye pose from last @ref pollPoses() */
+        const DualQuaternion& eyePose(Int eye) const { return _eyePoses[eye]; }
+
+        /** @brief Head pose from last @ref pollPoses() */
+        const DualQuaternion& headPose() const { return _headPose; }
+
+        /** @brief Submit committed eye targets to the compositor */
+        void submitFrame() { doSubmitFrame(); }
+
+        /**
+         * @brief Submit the previous frame again
+         *
+         * Submits the last committed eye targets together with the poses
+         * they were rendered with, instead of poses from last
+         * @ref pollPoses(), so the compositor can reproject them for the
+         * current head pose. Expects that no eye target was committed
+         * since the last @ref submitFrame().
+         */
+        void resubmitFrame() { doResubmitFrame(); }
+
+    private:
+        virtual Vector2i doEyeTextureSize(Int eye) const = 0;
+        virtual Matrix4 doProjectionMatrix(Int eye, Float near, Float far) const = 0;
+        virtual void doCreateEyeTarget(Int target, const Vector2i& size) = 0;
+        virtual GL::Texture2D& doActiveTexture(Int target) = 0;
+        virtual void doCommit(Int target) = 0;
+        virtual void doSetEyeViewport(Int eye, Int target, const Range2Di& viewport) = 0;
+        virtual void doWaitForFrame() = 0;
+        virtual void doPollPoses(DualQuaternion(&eyePoses)[2], DualQuaternion& headPose) = 0;
+        virtual void doSubmitFrame() = 0;
+        virtual void doResubmitFrame() = 0;
+
+        DualQuaternion _eyePoses[2];
+        DualQuaternion _headPose;
+        std::chrono::steady_clock::time_point _poseTime;
+};
+
+}
+
+#endif
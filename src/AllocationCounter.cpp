@@ -0,0 +1,93 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+
+namespace Magnum {
+
+namespace {
+    std::atomic<bool> enabled{false};
+    std::atomic<UnsignedLong> counted{0}, exempt{0};
+    std::atomic<std::size_t> live{0}, peak{0};
+    thread_local UnsignedInt exemptDepth{};
+}
+
+bool AllocationCounter::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::setEnabled(const bool enable) {
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+UnsignedLong AllocationCounter::count() {
+    return counted.load(std::memory_order_relaxed);
+}
+
+UnsignedLong AllocationCounter::exemptCount() {
+    return exempt.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::reset() {
+    counted.store(0, std::memory_order_relaxed);
+    exempt.store(0, std::memory_order_relaxed);
+}
+
+std::size_t AllocationCounter::liveBytes() {
+    return live.load(std::memory_order_relaxed);
+}
+
+std::size_t AllocationCounter::peakBytes() {
+    return peak.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::resetPeakBytes() {
+    peak.store(live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void AllocationCounter::record(const std::size_t size) noexcept {
+    const std::size_t bytes = live.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t previousPeak = peak.load(std::memory_order_relaxed);
+    while(bytes > previousPeak && !peak.compare_exchange_weak(previousPeak, bytes, std::memory_order_relaxed)) {}
+
+    if(!enabled.load(std::memory_order_relaxed)) return;
+    (exemptDepth ? exempt : counted).fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocationCounter::release(const std::size_t size) noexcept {
+    live.fetch_sub(size, std::memory_order_relaxed);
+}
+
+AllocationCounter::Exempt::Exempt() noexcept {
+    ++exemptDepth;
+}
+
+AllocationCounter::Exempt::~Exempt() {
+    --exemptDepth;
+}
+
+}
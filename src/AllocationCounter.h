@@ -0,0 +1,130 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef Magnum_VrUi_AllocationCounter_h
+#define Magnum_VrUi_AllocationCounter_h
+
+#include <cstddef>
+#include <Magnum/Magnum.h>
+
+namespace Magnum {
+
+/**
+@brief Heap allocation counter
+
+Counts heap allocations of the whole process while enabled, to verify the
+frame loop doesn't allocate once warmed up, and tracks live and peak heap
+bytes. Nothing is recorded unless the executable replaces the global
+allocation functions with ones calling @ref record() and @ref release(),
+which the library deliberately doesn't do. The benchmarks link
+@cb{.sh} benchmarks/AllocationHook.cpp @ce, which replaces all of them
+including the aligned and non-throwing variants.
+
+Calls into third-party code that allocates internally and can't be avoided,
+such as UI event handling or text layout, are wrapped in an @ref Exempt
+scope. Allocations in it are counted separately in @ref exemptCount(), so
+they can be checked against a budget instead of being hidden. The counters
+are shared by all threads, exempt scopes are per thread.
+*/
+class AllocationCounter {
+    public:
+        class Exempt;
+
+        AllocationCounter() = delete;
+
+        /** @brief Whether counting is enabled */
+        static bool isEnabled();
+
+        /**
+         * @brief Enable or disable counting
+         *
+         * Disabled by default. Doesn't reset the counters.
+         */
+        static void setEnabled(bool enabled);
+
+        /** @brief Count of allocations outside of exempt scopes */
+        static UnsignedLong count();
+
+        /** @brief Count of allocations in exempt scopes */
+        static UnsignedLong exemptCount();
+
+        /** @brief Reset both counters to zero */
+        static void reset();
+
+        /**
+         * @brief Live heap bytes
+         *
+         * Tracked regardless of @ref isEnabled(), as memory allocated
+         * before counting got enabled can be freed after.
+         */
+        static std::size_t liveBytes();
+
+        /** @brief Peak of @ref liveBytes() since the last @ref resetPeakBytes() */
+        static std::size_t peakBytes();
+
+        /** @brief Reset the peak to current @ref liveBytes() */
+        static void resetPeakBytes();
+
+        /**
+         * @brief Record an allocation
+         *
+         * Expected to be called from the global allocation functions. The
+         * allocation is counted only if counting is enabled, its size is
+         * always added to @ref liveBytes().
+         */
+        static void record(std::size_t size) noexcept;
+
+        /**
+         * @brief Record a deallocation
+         *
+         * Expected to be called from the global deallocation functions
+         * with the size passed to @ref record().
+         */
+        static void release(std::size_t size) noexcept;
+};
+
+/**
+@brief Exempt scope of @ref AllocationCounter
+
+Allocations done on the current thread while an instance is alive are
+counted in @ref AllocationCounter::exemptCount() instead of
+@ref AllocationCounter::count(). Scopes can be nested.
+*/
+class AllocationCounter::Exempt {
+    public:
+        explicit Exempt() noexcept;
+
+        /** @brief Copying is not allowed */
+        Exempt(const Exempt&) = delete;
+
+        ~Exempt();
+
+        /** @brief Copying is not allowed */
+        Exempt& operator=(const Exempt&) = delete;
+};
+
+}
+
+#endif
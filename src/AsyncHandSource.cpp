@@ -0,0 +1,73 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "AsyncHandSource.h"
+
+namespace Magnum {
+
+AsyncHandSource::AsyncHandSource(std::unique_ptr<AbstractHandSource> source, const std::chrono::microseconds pollInterval): _source{std::move(source)}, _pollInterval{pollInterval} {
+    /* Started last, after all state it uses is initialized */
+    _thread = std::thread{&AsyncHandSource::run, this};
+}
+
+AsyncHandSource::~AsyncHandSource() {
+    _stop.store(true, std::memory_order_relaxed);
+    _thread.join();
+}
+
+void AsyncHandSource::run() {
+    UnsignedLong lastTimestamp{};
+    bool lastTracked{};
+    while(!_stop.load(std::memory_order_relaxed)) {
+        _connected.store(_source->isConnected(), std::memory_order_relaxed);
+
+        /* Publish only new tracking frames and changes of the tracking
+           state, polling faster than the tracker runs would otherwise just
+           fill the dropped count */
+        Frame& frame = _buffer.writeBuffer();
+        frame.tracked = _source->frame(frame.hands);
+        if(frame.tracked != lastTracked || (frame.tracked && frame.hands.timestamp() != lastTimestamp)) {
+            lastTracked = frame.tracked;
+            lastTimestamp = frame.hands.timestamp();
+            _buffer.publish();
+        }
+
+        std::this_thread::sleep_for(_pollInterval);
+    }
+}
+
+bool AsyncHandSource::doIsConnected() const {
+    return _connected.load(std::memory_order_relaxed);
+}
+
+bool AsyncHandSource::doFrame(HandSnapshot& hands) {
+    if(_buffer.update()) _hasFrame = true;
+    if(!_hasFrame) return false;
+
+    const Frame& frame = _buffer.readBuffer();
+    hands = frame.hands;
+    return frame.tracked;
+}
+
+}
@@ -0,0 +1,112 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_AsyncHandSource_h
+#define Magnum_VrUi_AsyncHandSource_h
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "AbstractHandSource.h"
+#include "HandSnapshot.h"
+#include "TripleBuffer.h"
+
+namespace Magnum {
+
+/**
+@brief Asynchronous hand source
+
+Polls another hand source on a dedicated thread and hands complete
+snapshots over to the render thread through a @ref TripleBuffer, so a
+stall in the tracking SDK never stalls rendering. Only snapshots with a new
+timestamp get published. @ref frame() never blocks; it returns the latest
+published snapshot, which is the same as last time if the tracking thread
+didn't publish anything since.
+
+The wrapped source is accessed only from the tracking thread after
+construction. Sources that advance on every call, such as @ref HandReplay
+with zero speed, advance once per poll interval.
+*/
+class AsyncHandSource: public AbstractHandSource {
+    public:
+        /**
+         * @brief Constructor
+         * @param source        Source to poll
+         * @param pollInterval  Sleep between polls of the source
+         *
+         * Starts the tracking thread.
+         */
+        explicit AsyncHandSource(std::unique_ptr<AbstractHandSource> source, std::chrono::microseconds pollInterval = std::chrono::microseconds{1000});
+
+        /**
+         * @brief Destructor
+         *
+         * Stops and joins the tracking thread.
+         */
+        ~AsyncHandSource();
+
+        /** @brief Count of snapshots published by the tracking thread */
+        UnsignedLong publishedCount() const { return _buffer.publishedCount(); }
+
+        /**
+         * @brief Count of dropped snapshots
+         *
+         * Snapshots replaced by a newer one before the render thread picked
+         * them up. Expected to be non-zero if the tracker runs faster than
+         * rendering.
+         */
+        UnsignedLong droppedCount() const { return _buffer.droppedCount(); }
+
+        /**
+         * @brief Count of stale frames
+         *
+         * Calls to @ref frame() that got the same snapshot as the previous
+         * one because no new one was published in between.
+         */
+        UnsignedLong staleCount() const { return _buffer.staleCount(); }
+
+    private:
+        struct Frame {
+            HandSnapshot hands;
+            bool tracked;
+        };
+
+        bool doIsConnected() const override;
+        bool doFrame(HandSnapshot& hands) override;
+
+        void run();
+
+        std::unique_ptr<AbstractHandSource> _source;
+        std::chrono::microseconds _pollInterval;
+        TripleBuffer<Frame> _buffer;
+        bool _hasFrame{};
+        std::atomic<bool> _connected{false}, _stop{false};
+        std::thread _thread;
+};
+
+}
+
+#endif
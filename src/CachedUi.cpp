@@ -0,0 +1,96 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "CachedUi.h"
+
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Ui/UserInterface.h>
+
+namespace Magnum {
+
+namespace {
+
+struct Vertex {
+    Vector3 position;
+    Vector2 textureCoordinates;
+};
+
+constexpr const Vertex QuadVertices[]{
+    {{-1.0f, -1.0f, 0.0f}, {0.0f, 0.0f}},
+    {{ 1.0f, -1.0f, 0.0f}, {1.0f, 0.0f}},
+    {{-1.0f,  1.0f, 0.0f}, {0.0f, 1.0f}},
+    {{ 1.0f,  1.0f, 0.0f}, {1.0f, 1.0f}}
+};
+
+}
+
+CachedUi::CachedUi(Ui::UserInterface& ui, const Vector2i& textureSize): _ui(ui), _framebuffer{{{}, textureSize}}, _shader{Shaders::Flat3D::Flag::Textured} {
+    /* The quad is usually seen at an angle and from a distance, so it needs
+       mipmaps to not shimmer */
+    _texture.setMinificationFilter(GL::SamplerFilter::Linear, GL::SamplerMipmap::Linear)
+        .setMagnificationFilter(GL::SamplerFilter::Linear)
+        .setWrapping(GL::SamplerWrapping::ClampToEdge)
+        .setStorage(Math::log2(textureSize.max()) + 1, GL::TextureFormat::RGBA8, textureSize);
+
+    _framebuffer.attachTexture(GL::Framebuffer::ColorAttachment{0}, _texture, 0)
+        .mapForDraw(GL::Framebuffer::ColorAttachment{0});
+
+    _vertices.setData(QuadVertices, GL::BufferUsage::StaticDraw);
+    _quad.setPrimitive(GL::MeshPrimitive::TriangleStrip)
+        .setCount(4)
+        .addVertexBuffer(_vertices, 0, Shaders::Flat3D::Position{}, Shaders::Flat3D::TextureCoordinates{});
+
+    _shader.setColor(Color4{1.0f})
+        .bindTexture(_texture);
+}
+
+bool CachedUi::update() {
+    if(!_dirty) {
+        ++_hitCount;
+        return false;
+    }
+
+    /* Fully transparent background, with premultiplied alpha the texture
+       then blends over the scene the same as the UI drawn directly */
+    _framebuffer.clearColor(0, Color4{0.0f})
+        .bind();
+    _ui.setViewProjectionMatrix(Matrix4{});
+    _ui.draw();
+    _texture.generateMipmap();
+
+    _dirty = false;
+    ++_missCount;
+    return true;
+}
+
+CachedUi& CachedUi::draw(const Matrix4& transformationProjection) {
+    _shader.setTransformationProjectionMatrix(transformationProjection)
+        .bindTexture(_texture);
+    _quad.draw(_shader);
+    return *this;
+}
+
+}
@@ -0,0 +1,114 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_CachedUi_h
+#define Magnum_VrUi_CachedUi_h
+
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Shaders/Flat.h>
+#include <Magnum/Ui/Ui.h>
+
+namespace Magnum {
+
+/**
+@brief Render-to-texture cache of a UI
+
+Renders a @ref Ui::UserInterface into an offscreen texture and draws it as a
+single textured quad, so a UI that doesn't change between frames costs one
+draw call per eye instead of drawing all widget geometry again. The texture
+is rendered again on @ref update() only if the cache got invalidated with
+@ref invalidate() --- the UI library has no change notifications, so it's
+up to the user to invalidate the cache on every event passed to the UI and
+every widget or plane change.
+
+The UI is expected to fill the @f$ [-1, 1] @f$ square in its local space,
+the quad covers the same square. Colors in the texture are premultiplied by
+alpha.
+*/
+class CachedUi {
+    public:
+        /**
+         * @brief Constructor
+         * @param ui            UI to cache
+         * @param textureSize   Size of the cache texture
+         *
+         * The cache starts invalidated.
+         */
+        explicit CachedUi(Ui::UserInterface& ui, const Vector2i& textureSize);
+
+        /** @brief Mark the cache as out of date */
+        CachedUi& invalidate() {
+            _dirty = true;
+            return *this;
+        }
+
+        /** @brief Whether the cache is out of date */
+        bool isDirty() const { return _dirty; }
+
+        /**
+         * @brief Update the cache
+         *
+         * If invalidated, renders the UI into the cache texture, counted as
+         * a miss, otherwise does nothing, counted as a hit. Binds a
+         * different framebuffer in the first case, so call it before
+         * binding the framebuffer to draw the quad into. Returns
+         * @cpp true @ce if the texture was rendered.
+         */
+        bool update();
+
+        /**
+         * @brief Draw the cached UI
+         *
+         * @p transformationProjection is the same matrix as passed to
+         * @ref Ui::UserInterface::setViewProjectionMatrix() when drawing the
+         * UI directly.
+         */
+        CachedUi& draw(const Matrix4& transformationProjection);
+
+        /** @brief Count of updates that reused the cache */
+        UnsignedLong hitCount() const { return _hitCount; }
+
+        /** @brief Count of updates that rendered the UI */
+        UnsignedLong missCount() const { return _missCount; }
+
+    private:
+        Ui::UserInterface& _ui;
+        bool _dirty{true};
+        UnsignedLong _hitCount{}, _missCount{};
+
+        GL::Texture2D _texture;
+        GL::Framebuffer _framebuffer;
+        GL::Buffer _vertices;
+        GL::Mesh _quad;
+        Shaders::Flat3D _shader;
+};
+
+}
+
+#endif
@@ -0,0 +1,119 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "CapsuleImpostor.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Resource.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+
+#include "ShaderResources.h"
+#include "StartupCache.h"
+
+namespace Magnum {
+
+namespace {
+
+/* A perspective projection maps the eye to a point at infinity in clip
+   space, so the eye position is the inverse projection of that */
+Vector3 cameraPosition(const Matrix4& projectionMatrix) {
+    const Vector4 camera = projectionMatrix.inverted()*Vector4{0.0f, 0.0f, 1.0f, 0.0f};
+    return camera.xyz()/camera.w();
+}
+
+}
+
+CapsuleImpostor::CapsuleImpostor(const Flags flags, StartupCache* const cache): _flags{flags} {
+    MAGNUM_ASSERT_GL_VERSION_SUPPORTED(GL::Version::GL330);
+
+    importShaderResources();
+
+    Utility::Resource rs{"MagnumVrUi"};
+    const std::string define = flags & Flag::Stereo ? "#define STEREO\n" : "";
+    const std::string vertSource = rs.get("CapsuleImpostor.vert");
+    const std::string fragSource = rs.get("CapsuleImpostor.frag");
+
+    /* Compile only if there's no cached binary of the same sources or the
+       driver rejects it */
+    const std::string cacheName = StartupCache::programName("CapsuleImpostor", define + vertSource + define + fragSource);
+    if(!cache || !cache->loadProgram(cacheName, id())) {
+        GL::Shader vert{GL::Version::GL330, GL::Shader::Type::Vertex};
+        GL::Shader frag{GL::Version::GL330, GL::Shader::Type::Fragment};
+
+        vert.addSource(define)
+            .addSource(vertSource);
+        frag.addSource(define)
+            .addSource(fragSource);
+
+        CORRADE_INTERNAL_ASSERT_OUTPUT(GL::Shader::compile({vert, frag}));
+
+        attachShaders({vert, frag});
+
+        if(cache) cache->prepareProgram(id());
+        CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+        if(cache) cache->saveProgram(cacheName, id());
+    }
+
+    if(flags & Flag::Stereo) {
+        _projectionMatrixUniform = uniformLocation("projectionMatrices[0]");
+        _rightProjectionMatrixUniform = uniformLocation("projectionMatrices[1]");
+        _cameraPositionUniform = uniformLocation("cameraPositions[0]");
+        _rightCameraPositionUniform = uniformLocation("cameraPositions[1]");
+    } else {
+        _projectionMatrixUniform = uniformLocation("projectionMatrix");
+        _cameraPositionUniform = uniformLocation("cameraPosition");
+    }
+    _viewportSizeUniform = uniformLocation("viewportSize");
+    _lightPositionUniform = uniformLocation("lightPosition");
+    _ambientColorUniform = uniformLocation("ambientColor");
+    _specularColorUniform = uniformLocation("specularColor");
+    _shininessUniform = uniformLocation("shininess");
+
+    /* Same defaults as InstancedPhong */
+    setAmbientColor(Color3{0.0f});
+    setSpecularColor(Color3{1.0f});
+    setShininess(80.0f);
+}
+
+CapsuleImpostor& CapsuleImpostor::setProjectionMatrix(const Matrix4& matrix) {
+    CORRADE_ASSERT(!(_flags & Flag::Stereo),
+        "CapsuleImpostor::setProjectionMatrix(): the shader was created with stereo enabled", *this);
+    setUniform(_projectionMatrixUniform, matrix);
+    setUniform(_cameraPositionUniform, cameraPosition(matrix));
+    return *this;
+}
+
+CapsuleImpostor& CapsuleImpostor::setProjectionMatrices(const Matrix4& left, const Matrix4& right) {
+    CORRADE_ASSERT(_flags & Flag::Stereo,
+        "CapsuleImpostor::setProjectionMatrices(): the shader was not created with stereo enabled", *this);
+    setUniform(_projectionMatrixUniform, left);
+    setUniform(_rightProjectionMatrixUniform, right);
+    setUniform(_cameraPositionUniform, cameraPosition(left));
+    setUniform(_rightCameraPositionUniform, cameraPosition(right));
+    return *this;
+}
+
+}
@@ -0,0 +1,98 @@
+#ifdef STEREO
+uniform highp mat4 projectionMatrices[2];
+uniform highp vec3 cameraPositions[2];
+#else
+uniform highp mat4 projectionMatrix;
+uniform highp vec3 cameraPosition;
+#endif
+uniform highp vec3 lightPosition;
+uniform lowp vec3 ambientColor;
+uniform lowp vec3 specularColor;
+uniform mediump float shininess;
+
+in highp vec3 proxyPosition;
+flat in highp vec3 capsuleA;
+flat in highp vec3 capsuleB;
+flat in highp float capsuleRadius;
+flat in lowp vec3 capColor;
+flat in lowp int specular;
+#ifdef STEREO
+flat in lowp int eye;
+#endif
+
+layout(location = 0) out lowp vec4 color;
+
+/* Distance along the ray to the closest hit with a capsule, or a negative
+   value on a miss. First tests the infinite cylinder and then the sphere on
+   whichever side of it the hit fell, same as in Inigo Quilez's capsule
+   intersector. */
+highp float intersectCapsule(highp vec3 origin, highp vec3 direction, highp vec3 a, highp vec3 b, highp float r) {
+    highp vec3 ba = b - a;
+    highp vec3 oa = origin - a;
+    highp float baba = dot(ba, ba);
+    highp float bard = dot(ba, direction);
+    highp float baoa = dot(ba, oa);
+    highp float rdoa = dot(direction, oa);
+    highp float oaoa = dot(oa, oa);
+
+    /* Cylinder body. A ray parallel to the axis can hit only the caps. */
+    highp float k2 = baba - bard*bard;
+    highp float y = -1.0;
+    if(k2 > 1.0e-6*baba) {
+        highp float k1 = baba*rdoa - baoa*bard;
+        highp float k0 = baba*oaoa - baoa*baoa - r*r*baba;
+        highp float h = k1*k1 - k2*k0;
+        if(h < 0.0) return -1.0;
+        highp float t = (-k1 - sqrt(h))/k2;
+        y = baoa + t*bard;
+        if(y > 0.0 && y < baba) return t;
+    } else y = bard > 0.0 ? -1.0 : baba + 1.0;
+
+    /* Caps */
+    highp vec3 oc = y <= 0.0 ? oa : origin - b;
+    highp float k1 = dot(direction, oc);
+    highp float k0 = dot(oc, oc) - r*r;
+    highp float h = k1*k1 - k0;
+    if(h < 0.0) return -1.0;
+    return -k1 - sqrt(h);
+}
+
+void main() {
+    #ifdef STEREO
+    highp mat4 projection = projectionMatrices[eye];
+    highp vec3 camera = cameraPositions[eye];
+    #else
+    highp mat4 projection = projectionMatrix;
+    highp vec3 camera = cameraPosition;
+    #endif
+
+    highp vec3 rayDirection = normalize(proxyPosition - camera);
+    highp float t = intersectCapsule(camera, rayDirection, capsuleA, capsuleB, capsuleRadius);
+    if(t <= 0.0) discard;
+    highp vec3 position = camera + t*rayDirection;
+
+    /* Normal points away from the closest point on the axis, hits on the
+       caps are where the joints are */
+    highp vec3 axis = capsuleB - capsuleA;
+    highp float h = clamp(dot(position - capsuleA, axis)/max(dot(axis, axis), 1.0e-6), 0.0, 1.0);
+    mediump vec3 normal = (position - capsuleA - h*axis)/capsuleRadius;
+    lowp vec3 diffuseColor = h == 0.0 || h == 1.0 ? capColor : vec3(1.0);
+
+    /* Same lighting as InstancedPhong */
+    lowp vec3 finalColor = ambientColor;
+    highp vec3 lightDirection = normalize(lightPosition - position);
+    lowp float intensity = max(0.0, dot(normal, lightDirection));
+    finalColor += diffuseColor*intensity;
+    if(specular != 0 && intensity > 0.001) {
+        highp vec3 reflection = reflect(-lightDirection, normal);
+        mediump float specularity = pow(max(0.0, dot(-rayDirection, reflection)), shininess);
+        finalColor += specularColor*specularity;
+    }
+
+    color = vec4(finalColor, 1.0);
+
+    /* Depth of the actual surface instead of the proxy, so the hands
+       intersect correctly with each other and the rest of the scene */
+    highp vec4 clipPosition = projection*vec4(position, 1.0);
+    gl_FragDepth = 0.5*(gl_DepthRange.diff*clipPosition.z/clipPosition.w + gl_DepthRange.near + gl_DepthRange.far);
+}
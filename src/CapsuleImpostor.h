@@ -0,0 +1,161 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_CapsuleImpostor_h
+#define Magnum_VrUi_CapsuleImpostor_h
+
+#include <Corrade/Containers/EnumSet.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+namespace Magnum {
+
+class StartupCache;
+
+/**
+@brief Ray-traced capsule impostor shader
+
+Draws each instance as a capsule --- a cylinder between two points with a
+sphere of the same radius at each end --- ray-traced analytically in the
+fragment shader. The only geometry is a quad of four @ref Corner vertices
+drawn as @ref MeshPrimitive::TriangleStrip, which the vertex shader turns
+into a proxy perpendicular to the view direction just large enough to cover
+the capsule. The fragment shader discards pixels where the ray misses and
+writes depth of the actual surface, so impostors intersect correctly with
+each other and with regular geometry, at the cost of early depth test.
+
+The cylinder is white and the end spheres get the per-instance @ref Color,
+a capsule with both ends in the same point is a sphere of that color,
+lighting is the same as in @ref InstancedPhong. Resolution of the impostor
+is picked from its projected size in @ref setViewportSize() pixels:
+capsules smaller than a pixel get inflated so distant fingers don't break
+up into gaps and small capsules skip specular highlights.
+
+With @ref Flag::Stereo the shader renders both eyes in a single draw into a
+side-by-side target the same way as @ref InstancedPhong. Draw twice the
+instance count with per-instance attributes having a divisor of 2. Requires
+@cpp GL_CLIP_DISTANCE0 @ce to be enabled.
+*/
+class CapsuleImpostor: public GL::AbstractShaderProgram {
+    public:
+        /** @brief Proxy quad corner, from @cpp -1.0f @ce to @cpp 1.0f @ce */
+        typedef GL::Attribute<0, Vector2> Corner;
+
+        /** @brief Per-instance capsule start */
+        typedef GL::Attribute<3, Vector3> PointA;
+
+        /** @brief Per-instance capsule end */
+        typedef GL::Attribute<4, Vector3> PointB;
+
+        /** @brief Per-instance capsule radius */
+        typedef GL::Attribute<5, Float> Radius;
+
+        /** @brief Per-instance color of the end spheres */
+        typedef GL::Attribute<6, Color3> Color;
+
+        enum class Flag: UnsignedByte {
+            /** Single-pass side-by-side stereo rendering */
+            Stereo = 1 << 0
+        };
+
+        typedef Containers::EnumSet<Flag> Flags;
+
+        /**
+         * @brief Constructor
+         * @param flags     Flags
+         * @param cache     Cache to load the program binary from and save
+         *      it to, or @cpp nullptr @ce to always compile
+         */
+        explicit CapsuleImpostor(Flags flags = {}, StartupCache* cache = nullptr);
+
+        explicit CapsuleImpostor(NoCreateT) noexcept: GL::AbstractShaderProgram{NoCreate} {}
+
+        Flags flags() const { return _flags; }
+
+        /**
+         * @brief Set projection matrix
+         *
+         * The matrix is expected to be a perspective projection, the camera
+         * position the rays are cast from is extracted from it. Expects
+         * that @ref Flag::Stereo is not set.
+         */
+        CapsuleImpostor& setProjectionMatrix(const Matrix4& matrix);
+
+        /**
+         * @brief Set projection matrices for both eyes
+         *
+         * Expects that @ref Flag::Stereo is set.
+         */
+        CapsuleImpostor& setProjectionMatrices(const Matrix4& left, const Matrix4& right);
+
+        /**
+         * @brief Set viewport size of a single eye
+         *
+         * Used to pick the impostor resolution.
+         */
+        CapsuleImpostor& setViewportSize(const Vector2& size) {
+            setUniform(_viewportSizeUniform, size);
+            return *this;
+        }
+
+        CapsuleImpostor& setLightPosition(const Vector3& position) {
+            setUniform(_lightPositionUniform, position);
+            return *this;
+        }
+
+        CapsuleImpostor& setAmbientColor(const Color3& color) {
+            setUniform(_ambientColorUniform, color);
+            return *this;
+        }
+
+        CapsuleImpostor& setSpecularColor(const Color3& color) {
+            setUniform(_specularColorUniform, color);
+            return *this;
+        }
+
+        CapsuleImpostor& setShininess(Float shininess) {
+            setUniform(_shininessUniform, shininess);
+            return *this;
+        }
+
+    private:
+        Flags _flags;
+        Int _projectionMatrixUniform{0},
+            _rightProjectionMatrixUniform{1},
+            _cameraPositionUniform{2},
+            _rightCameraPositionUniform{3},
+            _viewportSizeUniform{4},
+            _lightPositionUniform{5},
+            _ambientColorUniform{6},
+            _specularColorUniform{7},
+            _shininessUniform{8};
+};
+
+CORRADE_ENUMSET_OPERATORS(CapsuleImpostor::Flags)
+
+}
+
+#endif
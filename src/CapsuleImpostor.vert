@@ -0,0 +1,92 @@
+#ifdef STEREO
+uniform highp mat4 projectionMatrices[2];
+uniform highp vec3 cameraPositions[2];
+#else
+uniform highp mat4 projectionMatrix;
+uniform highp vec3 cameraPosition;
+#endif
+uniform highp vec2 viewportSize;
+
+/* Capsules smaller than this get inflated so they never drop below a pixel
+   and break up into flickering gaps, capsules smaller than the second value
+   skip specular highlights, which would be just noise at that size */
+const highp float MinPixelRadius = 0.75;
+const highp float SpecularPixelRadius = 4.0;
+
+/* Corner of the proxy quad, from -1 to 1 in both coordinates */
+layout(location = 0) in mediump vec2 corner;
+
+/* Per-instance attributes, see CapsuleImpostor::PointA and friends for the
+   locations */
+layout(location = 3) in highp vec3 pointA;
+layout(location = 4) in highp vec3 pointB;
+layout(location = 5) in highp float radius;
+layout(location = 6) in lowp vec3 instanceColor;
+
+out highp vec3 proxyPosition;
+flat out highp vec3 capsuleA;
+flat out highp vec3 capsuleB;
+flat out highp float capsuleRadius;
+flat out lowp vec3 capColor;
+flat out lowp int specular;
+#ifdef STEREO
+flat out lowp int eye;
+#endif
+
+void main() {
+    #ifdef STEREO
+    /* Even instances are for the left eye, odd for the right one. The
+       per-instance attributes have a divisor of 2, so both eyes get the same
+       data. */
+    eye = gl_InstanceID & 1;
+    highp mat4 projection = projectionMatrices[eye];
+    highp vec3 camera = cameraPositions[eye];
+    #else
+    highp mat4 projection = projectionMatrix;
+    highp vec3 camera = cameraPosition;
+    #endif
+
+    highp vec3 center = 0.5*(pointA + pointB);
+    highp vec3 toCenter = center - camera;
+    highp float centerDistance = length(toCenter);
+    highp vec3 view = toCenter/centerDistance;
+
+    /* The proxy is a quad perpendicular to the view direction, with one side
+       along the projected capsule axis. If the capsule points straight at
+       the camera it projects to a circle and any perpendicular direction
+       works. */
+    highp vec3 axis = pointB - pointA;
+    highp vec3 projectedAxis = axis - dot(axis, view)*view;
+    highp float projectedLength = length(projectedAxis);
+    highp vec3 u = projectedLength > 1.0e-3*radius ? projectedAxis/projectedLength :
+        normalize(cross(view, abs(view.x) < 0.9 ? vec3(1.0, 0.0, 0.0) : vec3(0.0, 1.0, 0.0)));
+    highp vec3 v = cross(view, u);
+
+    /* Projected radius in pixels picks the impostor resolution */
+    highp vec4 clipCenter = projection*vec4(center, 1.0);
+    highp vec4 clipEdge = projection*vec4(center + v*radius, 1.0);
+    highp float pixelRadius = clipCenter.w > 0.0 && clipEdge.w > 0.0 ?
+        length((clipEdge.xy/clipEdge.w - clipCenter.xy/clipCenter.w)*0.5*viewportSize) : SpecularPixelRadius;
+    capsuleRadius = radius*max(1.0, MinPixelRadius/max(pixelRadius, 1.0e-3));
+    specular = pixelRadius >= SpecularPixelRadius ? 1 : 0;
+
+    /* Parts of the capsule closer to the camera than the center project
+       larger, scale the quad so it covers them as well */
+    highp float depthExtent = 0.5*abs(dot(axis, view)) + capsuleRadius;
+    highp float scale = centerDistance/max(centerDistance - depthExtent, 0.05*centerDistance);
+    highp vec2 extent = vec2(0.5*projectedLength + capsuleRadius, capsuleRadius)*scale;
+
+    proxyPosition = center + corner.x*extent.x*u + corner.y*extent.y*v;
+    capsuleA = pointA;
+    capsuleB = pointB;
+    capColor = instanceColor;
+
+    gl_Position = projection*vec4(proxyPosition, 1.0);
+
+    #ifdef STEREO
+    /* Squeeze into the eye's half of the side-by-side target and clip away
+       everything that would leak into the other half */
+    gl_Position.x = gl_Position.x*0.5 + (eye == 0 ? -0.5 : 0.5)*gl_Position.w;
+    gl_ClipDistance[0] = eye == 0 ? -gl_Position.x : gl_Position.x;
+    #endif
+}
@@ -0,0 +1,76 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "FingertipTouch.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Constants.h>
+#include <Magnum/Math/Functions.h>
+
+namespace Magnum {
+
+FingertipTouch::FingertipTouch(): _filter{3.0f, 30.0f, 1.0f} {}
+
+FingertipTouch& FingertipTouch::setDistances(const Float press, const Float release) {
+    CORRADE_ASSERT(release >= press,
+        "FingertipTouch::setDistances(): release distance" << release << "is smaller than press distance" << press, *this);
+    _pressDistance = press;
+    _releaseDistance = release;
+    return *this;
+}
+
+FingertipTouch::Event FingertipTouch::update(const Vector3& position, const UnsignedLong timestamp) {
+    if(_filter.hasValue() && timestamp > _lastTimestamp)
+        _sampleInterval = (timestamp - _lastTimestamp)*1.0e-6f;
+    _lastTimestamp = timestamp;
+
+    _position = _filter.filter(position, timestamp*1.0e-6) + _filter.velocity()*_prediction;
+
+    const Float distance = Math::abs(_position.z());
+    if(!_pressed) {
+        if(distance >= _pressDistance) return Event::None;
+        _pressed = true;
+        ++_pressCount;
+        return Event::Press;
+    }
+
+    if(distance <= _releaseDistance) return Event::Move;
+    _pressed = false;
+    return Event::Release;
+}
+
+FingertipTouch::Event FingertipTouch::lose() {
+    _filter.reset();
+    _sampleInterval = 0.0f;
+    if(!_pressed) return Event::None;
+    _pressed = false;
+    return Event::Release;
+}
+
+Float FingertipTouch::estimatedLatency() const {
+    const Float filterLag = 1.0f/(2.0f*Constants::pi()*_filter.cutoff());
+    return Math::max(_sampleInterval + filterLag - _prediction, 0.0f);
+}
+
+}
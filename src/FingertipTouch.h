@@ -0,0 +1,149 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_FingertipTouch_h
+#define Magnum_VrUi_FingertipTouch_h
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "OneEuroFilter.h"
+
+namespace Magnum {
+
+/**
+@brief Fingertip touch detection
+
+Turns raw fingertip positions relative to a UI plane into press, move and
+release events. Positions are smoothed with a @ref OneEuroFilter and then
+extrapolated along the filtered velocity by @ref prediction() to compensate
+for the time between the tracking sample and the frame being displayed.
+
+The fingertip touches the plane if its predicted distance from it is below
+@ref pressDistance() and stops touching it only once the distance is above
+@ref releaseDistance(), so jitter around the threshold doesn't produce
+double presses.
+
+The class doesn't depend on rendering or the UI library, so it can be run
+offline against recorded hand data, see @ref HandReplay.
+*/
+class FingertipTouch {
+    public:
+        /** @brief Touch event */
+        enum class Event: UnsignedByte {
+            None,       /**< Not touching */
+            Press,      /**< Started touching */
+            Move,       /**< Still touching */
+            Release     /**< Stopped touching */
+        };
+
+        /**
+         * @brief Constructor
+         *
+         * Default parameters are tuned for fingertip positions in meters
+         * from a tracker running at roughly 100 Hz.
+         */
+        explicit FingertipTouch();
+
+        /** @brief Position filter */
+        OneEuroFilter& filter() { return _filter; }
+
+        /** @brief Prediction time, in seconds */
+        Float prediction() const { return _prediction; }
+
+        /**
+         * @brief Set prediction time
+         *
+         * Expected time from a tracking sample to the frame using it being
+         * displayed. Default is @cpp 0.015f @ce, set to @cpp 0.0f @ce to
+         * disable the prediction.
+         */
+        FingertipTouch& setPrediction(Float seconds) {
+            _prediction = seconds;
+            return *this;
+        }
+
+        /** @brief Distance from the plane under which a press starts */
+        Float pressDistance() const { return _pressDistance; }
+
+        /** @brief Distance from the plane over which a press ends */
+        Float releaseDistance() const { return _releaseDistance; }
+
+        /**
+         * @brief Set press and release distance
+         *
+         * Default is @cpp 0.008f @ce and @cpp 0.012f @ce. The release
+         * distance is expected to be not smaller than the press distance.
+         */
+        FingertipTouch& setDistances(Float press, Float release);
+
+        /**
+         * @brief Update with a new fingertip sample
+         * @param position      Fingertip position relative to the plane, with
+         *      Z being the distance from it
+         * @param timestamp     Sample timestamp, in microseconds
+         */
+        Event update(const Vector3& position, UnsignedLong timestamp);
+
+        /**
+         * @brief Fingertip got lost
+         *
+         * Resets the filter. Returns @ref Event::Release if the fingertip was
+         * touching, @ref Event::None otherwise.
+         */
+        Event lose();
+
+        /** @brief Filtered and predicted position from last @ref update() */
+        const Vector3& position() const { return _position; }
+
+        /** @brief Whether the fingertip is touching the plane */
+        bool isPressed() const { return _pressed; }
+
+        /** @brief Count of presses so far */
+        UnsignedLong pressCount() const { return _pressCount; }
+
+        /**
+         * @brief Estimated motion-to-UI latency
+         *
+         * In seconds. Sum of the sample interval, as the UI reacts no earlier
+         * than on the frame following the sample, and of the lag of the
+         * filter at its current cutoff frequency, minus the prediction time.
+         * Never negative.
+         */
+        Float estimatedLatency() const;
+
+    private:
+        OneEuroFilter _filter;
+        Float _prediction{0.015f};
+        Float _pressDistance{0.008f}, _releaseDistance{0.012f};
+        bool _pressed{};
+        UnsignedLong _lastTimestamp{};
+        Float _sampleInterval{};
+        Vector3 _position;
+        UnsignedLong _pressCount{};
+};
+
+}
+
+#endif
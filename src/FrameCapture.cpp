@@ -0,0 +1,176 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "FrameCapture.h"
+
+#include <cstring>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+
+namespace Magnum {
+
+FrameCapture::FrameCapture(const std::string& filename, const Vector2i& sourceSize, const UnsignedInt interval, const UnsignedInt downscale): _sourceSize{sourceSize}, _size{sourceSize/Int(downscale ? downscale : 1)}, _interval{interval}, _downscale{downscale}, _frameSize{std::size_t(_size.product())*4}, _start{std::chrono::steady_clock::now()}, _queue{Containers::NoInit, QueueCapacity*(sizeof(FrameHeader) + _frameSize)}, _file{filename, std::ios::binary|std::ios::trunc} {
+    CORRADE_ASSERT(interval && downscale,
+        "FrameCapture: expected non-zero interval and downscale factor", );
+    CORRADE_ASSERT(_size.x() > 0 && _size.y() > 0 && _size.x() <= 0xffff && _size.y() <= 0xffff,
+        "FrameCapture: can't capture frames of size" << _size, );
+
+    _open = _file.good();
+    if(!_open) {
+        Error() << "FrameCapture: can't open" << filename << "for writing";
+        return;
+    }
+
+    const FileHeader header{{'M', 'V', 'R', 'U', 'I', 'F', 'R', 'M'}, Version, UnsignedShort(_size.x()), UnsignedShort(_size.y())};
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if(downscale != 1) {
+        _downscaledColor = GL::Renderbuffer{};
+        _downscaledColor.setStorage(GL::RenderbufferFormat::RGBA8, _size);
+        _downscaled = GL::Framebuffer{{{}, _size}};
+        _downscaled.attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, _downscaledColor)
+            .mapForRead(GL::Framebuffer::ColorAttachment{0});
+    }
+
+    /* Started last, after all state it uses is initialized */
+    _thread = std::thread{&FrameCapture::run, this};
+}
+
+FrameCapture::~FrameCapture() { finish(); }
+
+void FrameCapture::finish() {
+    if(!_open || _stop) return;
+
+    /* The only place allowed to block, everything in flight gets written */
+    collect(true);
+
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _stop = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+}
+
+void FrameCapture::capture(GL::Framebuffer& source) {
+    if(!_open || _stop) return;
+
+    collect(false);
+
+    const UnsignedInt frame = _frame++;
+    if(frame % _interval) return;
+
+    /* All read-backs still in flight, the GPU is too far behind */
+    Readback& readback = _readbacks[_nextReadback];
+    if(readback.fence) {
+        ++_droppedCount;
+        return;
+    }
+
+    GL::Framebuffer* read = &source;
+    if(_downscale != 1) {
+        GL::Framebuffer::blit(source, _downscaled,
+            {{}, _sourceSize}, {{}, _size},
+            GL::FramebufferBlit::Color, GL::FramebufferBlitFilter::Linear);
+        read = &_downscaled;
+    }
+
+    /* Reads into the pixel pack buffer, which doesn't wait for the GPU */
+    read->read({{}, _size}, readback.image, GL::BufferUsage::StreamRead);
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.header = {UnsignedLong(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start).count()), frame, 0};
+    _nextReadback = (_nextReadback + 1) % ReadbackCount;
+}
+
+void FrameCapture::collect(const bool wait) {
+    const std::size_t stride = sizeof(FrameHeader) + _frameSize;
+
+    /* Fences signal in order, so stop at the first unfinished read-back */
+    while(_readbacks[_oldestReadback].fence) {
+        Readback& readback = _readbacks[_oldestReadback];
+        if(glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? 1000000 : 0) == GL_TIMEOUT_EXPIRED) {
+            if(wait) continue;
+            break;
+        }
+        glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+        _oldestReadback = (_oldestReadback + 1) % ReadbackCount;
+
+        /* Wait for the writer thread only when draining on destruction */
+        std::size_t slot;
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+            if(wait) _condition.wait(lock, [this]{ return _queueCount != QueueCapacity; });
+            if(_queueCount == QueueCapacity) {
+                ++_droppedCount;
+                continue;
+            }
+            slot = (_queueBegin + _queueCount) % QueueCapacity;
+        }
+
+        /* The slot isn't visible to the writer thread until counted, so it
+           can be filled outside of the lock */
+        const Containers::ArrayView<char> pixels = readback.image.buffer().map(0, _frameSize, GL::Buffer::MapFlag::Read);
+        if(!pixels) {
+            ++_droppedCount;
+            continue;
+        }
+        char* const out = _queue + slot*stride;
+        std::memcpy(out, &readback.header, sizeof(FrameHeader));
+        std::memcpy(out + sizeof(FrameHeader), pixels.data(), _frameSize);
+        readback.image.buffer().unmap();
+
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            ++_queueCount;
+        }
+        _condition.notify_all();
+    }
+}
+
+void FrameCapture::run() {
+    const std::size_t stride = sizeof(FrameHeader) + _frameSize;
+    for(;;) {
+        std::size_t slot;
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+            _condition.wait(lock, [this]{ return _queueCount || _stop; });
+            if(!_queueCount) return;
+            slot = _queueBegin;
+        }
+
+        _file.write(_queue + slot*stride, stride);
+        _writtenCount.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            _queueBegin = (_queueBegin + 1) % QueueCapacity;
+            --_queueCount;
+        }
+        _condition.notify_all();
+    }
+}
+
+}
@@ -0,0 +1,204 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_FrameCapture_h
+#define Magnum_VrUi_FrameCapture_h
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/BufferImage.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/PixelFormat.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/Math/Vector2.h>
+
+namespace Magnum {
+
+/**
+@brief Asynchronous frame capture
+
+Records frames of a framebuffer, such as the compositor mirror, into a file
+without ever blocking the render loop. Each captured frame is read into one
+of a ring of @ref ReadbackCount pixel pack buffers and guarded by a fence.
+Later frames poll the fences and map only buffers the GPU is already done
+with, copy them into a queue of @ref QueueCapacity frames and a writer
+thread streams the queue to disk.
+
+A capture is dropped instead of waiting if all pixel pack buffers are still
+in flight or the writer thread can't keep up and the queue is full. Only
+every @p interval -th frame is captured, and frames can be downscaled on
+the GPU by an integer factor before the read-back to reduce bandwidth.
+
+The file starts with a @ref FileHeader, followed by frames, each being a
+@ref FrameHeader followed by RGBA8 pixels with rows from bottom to top, as
+read by GL. Everything is in native byte order.
+
+@code{.cpp}
+FrameCapture capture{"capture.raw", mirrorSize, 2, 2};
+
+// after each frame
+capture.capture(mirrorFramebuffer);
+@endcode
+*/
+class FrameCapture {
+    public:
+        enum: std::size_t {
+            /** Count of pixel pack buffers in flight */
+            ReadbackCount = 4,
+
+            /** Count of frames the writer thread can lag behind */
+            QueueCapacity = 8
+        };
+
+        /** @brief File header */
+        struct FileHeader {
+            char magic[8];
+            UnsignedInt version;
+            UnsignedShort width;
+            UnsignedShort height;
+        };
+
+        /** @brief Frame header */
+        struct FrameHeader {
+            /** Microseconds since the capture was created */
+            UnsignedLong timestamp;
+            /** Index of the captured frame, counting skipped ones too */
+            UnsignedInt frame;
+            UnsignedInt reserved;
+        };
+
+        static_assert(sizeof(FileHeader) == 16 && sizeof(FrameHeader) == 16, "unexpected padding in frame capture headers");
+
+        enum: UnsignedInt { Version = 1 };
+
+        /**
+         * @brief Constructor
+         * @param filename      File to write, overwritten if it exists
+         * @param sourceSize    Size of the captured framebuffer
+         * @param interval      Capture only every n-th frame
+         * @param downscale     Integer factor to downscale the frames by
+         *
+         * Allocates all pixel pack buffers and the frame queue and starts
+         * the writer thread. Expects a GL context to be current.
+         */
+        explicit FrameCapture(const std::string& filename, const Vector2i& sourceSize, UnsignedInt interval = 1, UnsignedInt downscale = 1);
+
+        /** @brief Copying is not allowed */
+        FrameCapture(const FrameCapture&) = delete;
+
+        /** @brief Copying is not allowed */
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+        /**
+         * @brief Destructor
+         *
+         * Calls @ref finish().
+         */
+        ~FrameCapture();
+
+        /** @brief Whether the file was successfully opened */
+        bool isOpen() const { return _open; }
+
+        /** @brief Size of captured frames */
+        Vector2i size() const { return _size; }
+
+        /**
+         * @brief Capture a frame
+         *
+         * Queues a read-back of the first color attachment of @p source,
+         * which is expected to have the size passed to the constructor and
+         * to be mapped for reading, and hands read-backs finished on the GPU
+         * to the writer thread. Never blocks. Does nothing after
+         * @ref finish().
+         */
+        void capture(GL::Framebuffer& source);
+
+        /**
+         * @brief Finish the capture
+         *
+         * Waits for all captures in flight, writes the queue to disk and
+         * joins the writer thread. Blocks, meant to be called only on
+         * shutdown.
+         */
+        void finish();
+
+        /** @brief Count of frames written to disk so far */
+        UnsignedLong writtenCount() const { return _writtenCount.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Count of dropped captures
+         *
+         * Frames that should have been captured but weren't because all
+         * pixel pack buffers were still in flight or the queue was full.
+         */
+        UnsignedLong droppedCount() const { return _droppedCount; }
+
+    private:
+        struct Readback {
+            GL::BufferImage2D image{GL::PixelFormat::RGBA, GL::PixelType::UnsignedByte};
+            GLsync fence{};
+            FrameHeader header;
+        };
+
+        void collect(bool wait);
+        void run();
+
+        Vector2i _sourceSize, _size;
+        UnsignedInt _interval, _downscale;
+        std::size_t _frameSize;
+        std::chrono::steady_clock::time_point _start;
+        UnsignedInt _frame{};
+        UnsignedLong _droppedCount{};
+
+        GL::Renderbuffer _downscaledColor{NoCreate};
+        GL::Framebuffer _downscaled{NoCreate};
+        Readback _readbacks[ReadbackCount];
+        std::size_t _oldestReadback{}, _nextReadback{};
+
+        /* Written by the render thread outside of the lock, the writer
+           thread touches only the first _queueCount frames from
+           _queueBegin */
+        Containers::Array<char> _queue;
+        std::size_t _queueBegin{}, _queueCount{};
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stop{};
+
+        std::ofstream _file;
+        bool _open;
+        std::atomic<UnsignedLong> _writtenCount{0};
+        std::thread _thread;
+};
+
+}
+
+#endif
@@ -0,0 +1,243 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "FrameProfiler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <Corrade/Utility/Assert.h>
+
+namespace Magnum {
+
+namespace {
+
+/* Same order as the Stage enum */
+const char* const StageNames[]{
+    "FrameWait",
+    "HandPoll",
+    "PosePoll",
+    "TouchInput",
+    "UiDraw",
+    "HandDraw",
+    "Resolve",
+    "Commit",
+    "Submit",
+    "MirrorBlit",
+    "UiUpdate",
+    "Capture"
+};
+
+const char* eyeName(const Byte eye) {
+    switch(eye) {
+        case 0: return "left";
+        case 1: return "right";
+        case FrameProfiler::BothEyes: return "both";
+    }
+    return "";
+}
+
+}
+
+const char* FrameProfiler::stageName(const Stage stage) {
+    return StageNames[UnsignedByte(stage)];
+}
+
+FrameProfiler::FrameProfiler(const std::size_t capacity): _capacity{capacity} {
+    CORRADE_ASSERT(capacity > QueryLatency,
+        "FrameProfiler: expected capacity larger than" << QueryLatency << "but got" << capacity, );
+}
+
+FrameProfiler::~FrameProfiler() = default;
+
+FrameProfiler& FrameProfiler::setEnabled(const bool enabled) {
+    if(enabled == _enabled) return *this;
+
+    if(enabled) {
+        if(_frames.empty()) {
+            _frames = Containers::Array<Frame>{_capacity};
+            _queries.reserve(QueryLatency*MaxStagesPerFrame*2);
+            for(std::size_t i = 0; i != QueryLatency*MaxStagesPerFrame*2; ++i)
+                _queries.emplace_back(GL::TimeQuery::Target::Timestamp);
+        }
+
+        _frameCount = 0;
+        _epoch = std::chrono::steady_clock::now();
+    } else {
+        if(_inFrame) endFrame();
+
+        /* Frames that still have timestamps in flight */
+        const UnsignedLong pending = _frameCount < QueryLatency ? _frameCount : QueryLatency;
+        for(UnsignedLong frame = _frameCount - pending; frame != _frameCount; ++frame)
+            collectGpuTimestamps(frame, true);
+    }
+
+    _enabled = enabled;
+    return *this;
+}
+
+UnsignedLong FrameProfiler::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _epoch).count();
+}
+
+void FrameProfiler::beginFrame() {
+    if(!_enabled) return;
+
+    /* The query set is going to be reused for this frame, get the results
+       of the frame that used it before */
+    if(_frameCount >= QueryLatency)
+        collectGpuTimestamps(_frameCount - QueryLatency, false);
+
+    Frame& frame = _frames[_frameCount % _capacity];
+    frame.index = _frameCount;
+    frame.eventCount = 0;
+    _inFrame = true;
+}
+
+void FrameProfiler::endFrame() {
+    if(!_enabled || !_inFrame) return;
+
+    if(_inStage) end();
+    _inFrame = false;
+    ++_frameCount;
+}
+
+void FrameProfiler::begin(const Stage stage, const Int eye) {
+    if(!_enabled || !_inFrame) return;
+    CORRADE_ASSERT(!_inStage, "FrameProfiler::begin(): stage" << stageName(stage) << "begun while another is in progress", );
+
+    Frame& frame = _frames[_frameCount % _capacity];
+    if(frame.eventCount == MaxStagesPerFrame) return;
+
+    Event& event = frame.events[frame.eventCount];
+    event.stage = stage;
+    event.eye = Byte(eye);
+    event.gpuBegin = event.gpuEnd = 0;
+    query(_frameCount, frame.eventCount, 0).timestamp();
+    event.cpuBegin = now();
+    _inStage = true;
+}
+
+void FrameProfiler::end() {
+    if(!_enabled || !_inStage) return;
+
+    Frame& frame = _frames[_frameCount % _capacity];
+    Event& event = frame.events[frame.eventCount];
+    event.cpuEnd = now();
+    query(_frameCount, frame.eventCount, 1).timestamp();
+    ++frame.eventCount;
+    _inStage = false;
+}
+
+void FrameProfiler::collectGpuTimestamps(const UnsignedLong frameIndex, const bool wait) {
+    Frame& frame = _frames[frameIndex % _capacity];
+    if(frame.index != frameIndex) return;
+
+    for(std::size_t i = 0; i != frame.eventCount; ++i) {
+        GL::TimeQuery& begin = query(frameIndex, i, 0);
+        GL::TimeQuery& end = query(frameIndex, i, 1);
+
+        /* Leave the GPU timing empty instead of stalling */
+        if(!wait && !end.resultAvailable()) continue;
+
+        frame.events[i].gpuBegin = begin.result<UnsignedLong>();
+        frame.events[i].gpuEnd = end.result<UnsignedLong>();
+    }
+}
+
+std::size_t FrameProfiler::oldestFrame(std::size_t& count) const {
+    count = _frameCount < _capacity ? std::size_t(_frameCount) : _capacity;
+    return _frameCount < _capacity ? 0 : _frameCount % _capacity;
+}
+
+bool FrameProfiler::exportCsv(const std::string& filename) const {
+    std::ofstream out{filename};
+    if(!out.good()) return false;
+
+    out << std::fixed << std::setprecision(3)
+        << "frame,stage,eye,cpu_start_us,cpu_us,gpu_us\n";
+
+    std::size_t count;
+    const std::size_t oldest = oldestFrame(count);
+    const UnsignedLong start = count && _frames[oldest].eventCount ? _frames[oldest].events[0].cpuBegin : 0;
+    for(std::size_t i = 0; i != count; ++i) {
+        const Frame& frame = _frames[(oldest + i) % _capacity];
+        for(std::size_t j = 0; j != frame.eventCount; ++j) {
+            const Event& event = frame.events[j];
+            out << frame.index << ',' << stageName(event.stage) << ','
+                << eyeName(event.eye) << ','
+                << (event.cpuBegin - start)/1000.0 << ','
+                << (event.cpuEnd - event.cpuBegin)/1000.0 << ',';
+            if(event.gpuEnd) out << (event.gpuEnd - event.gpuBegin)/1000.0;
+            out << '\n';
+        }
+    }
+
+    return out.good();
+}
+
+bool FrameProfiler::exportChromeTrace(const std::string& filename) const {
+    std::ofstream out{filename};
+    if(!out.good()) return false;
+
+    out << std::fixed << std::setprecision(3)
+        << "{\"traceEvents\":[\n"
+        << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n"
+        << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+    std::size_t count;
+    const std::size_t oldest = oldestFrame(count);
+    for(std::size_t i = 0; i != count; ++i) {
+        const Frame& frame = _frames[(oldest + i) % _capacity];
+        if(!frame.eventCount) continue;
+
+        /* Align the GPU clock to the CPU one at the first stage with GPU
+           timing in the frame */
+        const Event* gpuOrigin = nullptr;
+        for(std::size_t j = 0; j != frame.eventCount && !gpuOrigin; ++j)
+            if(frame.events[j].gpuEnd) gpuOrigin = frame.events + j;
+
+        for(std::size_t j = 0; j != frame.eventCount; ++j) {
+            const Event& event = frame.events[j];
+            const char* const eye = eyeName(event.eye);
+
+            out << ",\n{\"name\":\"" << stageName(event.stage) << (*eye ? " " : "") << eye
+                << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":"
+                << event.cpuBegin/1000.0 << ",\"dur\":" << (event.cpuEnd - event.cpuBegin)/1000.0
+                << ",\"args\":{\"frame\":" << frame.index << "}}";
+
+            if(!gpuOrigin || !event.gpuEnd) continue;
+
+            const Long ts = Long(gpuOrigin->cpuBegin) + Long(event.gpuBegin) - Long(gpuOrigin->gpuBegin);
+            out << ",\n{\"name\":\"" << stageName(event.stage) << (*eye ? " " : "") << eye
+                << "\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":"
+                << ts/1000.0 << ",\"dur\":" << (event.gpuEnd - event.gpuBegin)/1000.0
+                << ",\"args\":{\"frame\":" << frame.index << "}}";
+        }
+    }
+
+    out << "\n]}\n";
+    return out.good();
+}
+
+}
@@ -0,0 +1,190 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_FrameProfiler_h
+#define Magnum_VrUi_FrameProfiler_h
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/TimeQuery.h>
+
+namespace Magnum {
+
+/**
+@brief Per-stage CPU and GPU frame profiler
+
+Times stages of the frame loop with CPU timers and GL timestamp queries and
+records them into a ring buffer of a fixed amount of most recent frames.
+Everything is allocated when the profiler gets enabled, recording a frame
+doesn't allocate. GPU timestamps are read back a few frames later to avoid
+stalling the pipeline.
+
+Recorded frames can be exported as CSV with @ref exportCsv() or as a
+Chrome trace with @ref exportChromeTrace(), which can be opened in
+`chrome://tracing` or Perfetto. When disabled, which is the default, all
+recording functions return immediately.
+
+@code{.cpp}
+profiler.beginFrame();
+profiler.begin(FrameProfiler::Stage::UiDraw, eye);
+ui.draw();
+profiler.end();
+// ...
+profiler.endFrame();
+@endcode
+*/
+class FrameProfiler {
+    public:
+        /** @brief Frame loop stage */
+        enum class Stage: UnsignedByte {
+            FrameWait,      /**< Waiting for the compositor frame boundary */
+            HandPoll,       /**< Polling hand tracking */
+            PosePoll,       /**< Polling head tracking */
+            TouchInput,     /**< Handling fingertip touches on the UI */
+            UiDraw,         /**< Drawing the UI */
+            HandDraw,       /**< Drawing hands */
+            Resolve,        /**< Resolving a multisampled eye buffer */
+            Commit,         /**< Committing a swap chain */
+            Submit,         /**< Submitting the frame to the compositor */
+            MirrorBlit,     /**< Blitting the mirror texture to the window */
+            UiUpdate,       /**< Updating the UI after submit */
+            Capture         /**< Queueing a frame capture read-back */
+        };
+
+        enum: std::size_t {
+            /** Max count of stages recorded in a frame */
+            MaxStagesPerFrame = 32,
+
+            /** Count of frames after which GPU timestamps are read back */
+            QueryLatency = 4
+        };
+
+        /** @brief Eye value for stages not specific to an eye */
+        enum: Byte { NoEye = -1, BothEyes = 2 };
+
+        /** @brief Stage name */
+        static const char* stageName(Stage stage);
+
+        /**
+         * @brief Constructor
+         * @param capacity  Count of most recent frames to keep, expected to
+         *      be larger than @ref QueryLatency
+         *
+         * Doesn't allocate anything until enabled. GL queries are created
+         * when enabled, so a GL context is expected to be current then.
+         */
+        explicit FrameProfiler(std::size_t capacity = 1024);
+
+        ~FrameProfiler();
+
+        /** @brief Whether the profiler is enabled */
+        bool isEnabled() const { return _enabled; }
+
+        /**
+         * @brief Enable or disable the profiler
+         *
+         * On disabling, waits for all pending GPU timestamps so the
+         * recorded data are complete for export. Enabling again discards
+         * previously recorded frames.
+         */
+        FrameProfiler& setEnabled(bool enabled);
+
+        /** @brief Begin a frame */
+        void beginFrame();
+
+        /** @brief End a frame */
+        void endFrame();
+
+        /**
+         * @brief Begin a stage
+         * @param stage     Stage
+         * @param eye       Eye index, @ref NoEye or @ref BothEyes
+         *
+         * Stages can't nest, stages past @ref MaxStagesPerFrame in a frame
+         * are ignored.
+         */
+        void begin(Stage stage, Int eye = NoEye);
+
+        /** @brief End the current stage */
+        void end();
+
+        /** @brief Count of frames recorded since enabled */
+        UnsignedLong frameCount() const { return _frameCount; }
+
+        /**
+         * @brief Export recorded frames as CSV
+         *
+         * One row per stage, with frame index, stage name, eye, CPU start
+         * time relative to the first exported frame and CPU and GPU
+         * duration, all in microseconds. GPU duration is empty if not
+         * available. Returns @cpp false @ce if the file can't be written.
+         */
+        bool exportCsv(const std::string& filename) const;
+
+        /**
+         * @brief Export recorded frames as a Chrome trace
+         *
+         * CPU and GPU timings are two separate threads in the trace. The GPU
+         * timeline is aligned to the CPU one at the start of each frame, so
+         * only durations and gaps within a frame are exact. Returns
+         * @cpp false @ce if the file can't be written.
+         */
+        bool exportChromeTrace(const std::string& filename) const;
+
+    private:
+        struct Event {
+            Stage stage;
+            Byte eye;
+            /* Nanoseconds, CPU since profiler start, GPU in the GL
+               timestamp clock, zero if not available */
+            UnsignedLong cpuBegin, cpuEnd, gpuBegin, gpuEnd;
+        };
+
+        struct Frame {
+            UnsignedLong index;
+            std::size_t eventCount;
+            Event events[MaxStagesPerFrame];
+        };
+
+        UnsignedLong now() const;
+        void collectGpuTimestamps(UnsignedLong frame, bool wait);
+        GL::TimeQuery& query(UnsignedLong frame, std::size_t event, std::size_t i) {
+            return _queries[((frame % QueryLatency)*MaxStagesPerFrame + event)*2 + i];
+        }
+        std::size_t oldestFrame(std::size_t& count) const;
+
+        std::size_t _capacity;
+        bool _enabled{}, _inFrame{}, _inStage{};
+        UnsignedLong _frameCount{};
+        std::chrono::steady_clock::time_point _epoch;
+        Containers::Array<Frame> _frames;
+        std::vector<GL::TimeQuery> _queries;
+};
+
+}
+
+#endif
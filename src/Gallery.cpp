@@ -0,0 +1,823 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "Gallery.h"
+
+#include <chrono>
+#include <Corrade/Interconnect/Receiver.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Math/DualQuaternion.h>
+#include <Magnum/Math/Functions.h>
+
+#include "AbstractHandSource.h"
+#include "AbstractHmd.h"
+#include "AllocationCounter.h"
+#include "StereoFrustum.h"
+#include "TelemetryExporter.h"
+
+namespace Magnum {
+
+using namespace Math::Literals;
+
+namespace {
+
+const Matrix4 GalleryPanelTransformation = Matrix4::translation({0.2f, -0.6f, -0.4f});
+
+/* Magnum::Ui projects its screen to [-1, 1], panels span [-0.5, 0.5] */
+const Matrix4 UiScaling = Matrix4::scaling(Vector3{0.5f});
+
+/* Fingertips further than this from any panel can't touch it, but it's
+   large enough to keep following a fingertip approaching a panel */
+constexpr Float TouchQueryRadius = 0.05f;
+
+/* Max reach of the pointing rays, in meters */
+constexpr Float PointerDistance = 10.0f;
+
+Range3D transformBox(const Matrix4& transformation, const Range3D& box) {
+    Range3D out;
+    for(Int i = 0; i != 8; ++i) {
+        const Vector3 corner = transformation.transformPoint({
+            (i & 1 ? box.max() : box.min()).x(),
+            (i & 2 ? box.max() : box.min()).y(),
+            (i & 4 ? box.max() : box.min()).z()});
+        out = i ? Range3D{Math::min(out.min(), corner), Math::max(out.max(), corner)} : Range3D{corner, corner};
+    }
+    return out;
+}
+
+Int sampleCountFor(const Int count) {
+    if(count < 2) return 0;
+
+    const Int max = GL::Renderbuffer::maxSamples();
+    if(count <= max) return count;
+
+    Warning() << "Gallery: sample count" << count << "not supported, using" << max;
+    return max;
+}
+
+}
+
+Gallery::Gallery(AbstractHmd& hmd, std::unique_ptr<AbstractHandSource> handSource, const Configuration& configuration): _hmd(hmd), _jobs{configuration.jobSystem()}, _pipelined{configuration.isPipelined()}, _lateLatching{configuration.isLateLatching()}, _telemetryExporter{configuration.telemetryExporter()}, _frameReuse{configuration.isFrameReuse()}, _maxReusedFrames{configuration.maxReusedFrames()}, _reuseRotationThreshold{configuration.reuseRotationThreshold()}, _reuseTranslationThreshold{configuration.reuseTranslationThreshold()}, _handSource{std::move(handSource)}, _singlePassStereo{configuration.isSinglePassStereo()} {
+    GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
+    // FIXME: Magnum::Ui does not support sRGB yet
+    // GL::Renderer::enable(GL::Renderer::Feature::FramebufferSRGB);
+
+    /* Setup per-eye views */
+    Vector2i textureSize[2];
+    for(Int eye: {0, 1}) {
+        _projectionMatrix[eye] = _hmd.projectionMatrix(eye, 0.001f, 25.0f);
+        textureSize[eye] = _eyeTextureSize[eye] = _hmd.eyeTextureSize(eye);
+    }
+
+    /* In single-pass stereo mode both eyes share one texture side by side.
+       The stereo shaders split the viewport exactly in half, so both eyes
+       get the larger of the two sizes. The compositor maps the whole eye
+       viewport to the eye field of view, so a few extra pixels in one
+       eye only make it sharper. */
+    if(_singlePassStereo) {
+        _eyeTextureSize[0] = _eyeTextureSize[1] = Math::max(_eyeTextureSize[0], _eyeTextureSize[1]);
+        textureSize[0] = {2*_eyeTextureSize[0].x(), _eyeTextureSize[0].y()};
+    }
+
+    for(Int target = 0; target != (_singlePassStereo ? 1 : 2); ++target) {
+        _hmd.createEyeTarget(target, textureSize[target]);
+        _targetSize[target] = textureSize[target];
+    }
+
+    _sampleCount = sampleCountFor(configuration.sampleCount());
+    createEyeFramebuffers();
+
+    /* The eye textures are allocated for the full resolution, only the
+       rendered part of them gets scaled */
+    _resolution.setScaleRange(configuration.minResolutionScale(), configuration.maxResolutionScale())
+        .setTargetFrameTime(configuration.targetFrameTime());
+
+    /* Ui setup */
+
+    /* Enable blending with premultiplied alpha for Ui rendering */
+    GL::Renderer::enable(GL::Renderer::Feature::Blending);
+    GL::Renderer::setBlendFunction(GL::Renderer::BlendFunction::One, GL::Renderer::BlendFunction::OneMinusSourceAlpha);
+    GL::Renderer::setBlendEquation(GL::Renderer::BlendEquation::Add, GL::Renderer::BlendEquation::Add);
+
+    Ui::StyleConfiguration style = Ui::mcssDarkStyleConfiguration();
+    GL::Renderer::setClearColor(0x22272e_rgbf);
+
+    /* Create the UI. It should get at least some screen space, but also
+       shouldn't be tucked away into a small corner on ultra-dense displays. */
+    _ui.emplace(Vector2{1024.0f, 1024.0f}, Vector2i(1024, 1024), style, "»");
+
+    /* The cache texture has the same size as the UI framebuffer */
+    if(configuration.isUiCached()) _cachedUi.emplace(*_ui, Vector2i{1024});
+
+    /* Place it in the world */
+    _panels.add(GalleryPanelTransformation, _ui->screenSize());
+    _panelUis.push_back(&*_ui);
+    _panelEyeMasks.push_back(0);
+
+    /* Create base UI plane */
+    _baseUiPlane.emplace(*_ui);
+
+    /* Register modals, their planes are created on first use unless
+       configured otherwise. IDs are in the order of the buttons. */
+    _modals.emplace(*_ui, configuration.modalPoolCapacity());
+    Ui::Button* const modalButtons[]{
+        &_baseUiPlane->modalDefault,
+        &_baseUiPlane->modalDanger,
+        &_baseUiPlane->modalSuccess,
+        &_baseUiPlane->modalWarning,
+        &_baseUiPlane->modalInfo};
+    for(const Ui::Style style: {Ui::Style::Default, Ui::Style::Danger, Ui::Style::Success, Ui::Style::Warning, Ui::Style::Info}) {
+        const UnsignedInt id = _modals->add(style);
+        Interconnect::connect(*modalButtons[id], &Ui::Button::tapped, [this, id]() { _tappedModal = Int(id); });
+    }
+    if(!configuration.isModalsLazy())
+        _modals->setCapacity(_modals->count())
+            .createAll();
+
+    /* Fingertip position telemetry, in order of the set() calls in
+       updateUi() */
+    _telemetry.addField(_baseUiPlane->inputDefault, 6);
+    _telemetry.addField(_baseUiPlane->inputDanger, 6);
+    _telemetry.addField(_baseUiPlane->inputSuccess, 6);
+    _telemetry.addField(_baseUiPlane->inputWarning, 6);
+    _telemetry.addField(_baseUiPlane->inputFlat, 6);
+    _telemetry.addField(_baseUiPlane->inputDefaultDisabled, 6);
+    _telemetry.setMaxRefreshRate(configuration.telemetryRefreshRate());
+
+    /* Hands rendering */
+    _handRenderer.emplace(configuration.handRendererMode(), configuration.startupCache());
+    _handRenderer->setStereo(_singlePassStereo);
+
+    updateEyeViewports();
+}
+
+Gallery::~Gallery() {
+    /* Jobs reference the gallery */
+    waitForJobs();
+}
+
+HandRenderer& Gallery::handRenderer() {
+    if(_jobs) _jobs->wait(_handsPrepared);
+    return *_handRenderer;
+}
+
+void Gallery::waitForJobs() {
+    if(!_jobs) return;
+    _jobs->wait(_handsPrepared);
+    _jobs->wait(_touchesDetected);
+    _jobs->wait(_telemetryFormatted);
+}
+
+void Gallery::prepareHandsJob(void* const gallery) {
+    static_cast<Gallery*>(gallery)->prepareHands();
+}
+
+void Gallery::detectTouchesJob(void* const gallery) {
+    static_cast<Gallery*>(gallery)->detectTouches();
+}
+
+void Gallery::formatTelemetryJob(void* const gallery) {
+    static_cast<Gallery*>(gallery)->_telemetry.format(std::chrono::steady_clock::now());
+}
+
+UnsignedInt Gallery::addPanel(Ui::UserInterface& ui, const Matrix4& transformation) {
+    _panelUis.push_back(&ui);
+    _panelEyeMasks.push_back(0);
+    return _panels.add(transformation, ui.screenSize());
+}
+
+Gallery& Gallery::setSampleCount(Int count) {
+    count = sampleCountFor(count);
+    if(count == _sampleCount) return *this;
+
+    _sampleCount = count;
+    createEyeFramebuffers();
+
+    /* New framebuffers have the full size viewport */
+    if(!_singlePassStereo)
+        for(Int eye: {0, 1}) _framebuffer[eye].setViewport(_eyeViewport[eye]);
+    return *this;
+}
+
+CachedUi& Gallery::cachedUi() {
+    CORRADE_ASSERT(_cachedUi, "Gallery::cachedUi(): the UI is not cached", *_cachedUi);
+    return *_cachedUi;
+}
+
+void Gallery::drawFrame() {
+    _frameStats = {};
+    _profiler.beginFrame();
+
+    /* Start the frame right at the compositor frame boundary, so
+       everything after is as fresh as possible when displayed */
+    _profiler.begin(FrameProfiler::Stage::FrameWait);
+    _hmd.waitForFrame();
+    _profiler.end();
+    _frameStart = std::chrono::steady_clock::now();
+    ++_frameIndex;
+
+    /* Push telemetry formatted on a worker after the previous frame */
+    if(_telemetryPending) {
+        _profiler.begin(FrameProfiler::Stage::UiUpdate);
+        _jobs->wait(_telemetryFormatted);
+        const UnsignedLong telemetryUpdates = _telemetry.updateCount();
+        _telemetry.apply();
+        if(_cachedUi && _telemetry.updateCount() != telemetryUpdates)
+            _cachedUi->invalidate();
+        _telemetryPending = false;
+        _profiler.end();
+    }
+
+    /* Apply a new resolution scale picked at the end of previous frame */
+    if(_resolution.scaleChanged()) {
+        updateEyeViewports();
+        _sceneChanged = true;
+    }
+
+    /* Hands are polled and prepared on a worker while the head poses are
+       polled here, unless that already happened while the previous frame
+       was being submitted */
+    if(_jobs && !_handsPending) _jobs->run(_handsPrepared, prepareHandsJob, this);
+
+    /* Get orientation and position of the hmd. With late latching these
+       are used only for touch input, drawing polls them again. */
+    _profiler.begin(FrameProfiler::Stage::PosePoll);
+    _hmd.pollPoses();
+    _profiler.end();
+    const Matrix4 invertedHeadPose = _hmd.headPose().toMatrix();
+
+    /* Leap Motion bones are always relative to view */
+    const Matrix4 leapToView = Matrix4::rotationX(-90.0_degf)*Matrix4::scaling(0.001f*Vector3{-1.0f, 1.0f, -1.0f});
+    Matrix4 toWorldSpace = invertedHeadPose*leapToView;
+
+    /* Extract bones, joints and fingertips of both hands once for both eyes
+       and the UI. Only fingertips depend on the head pose. */
+    _profiler.begin(FrameProfiler::Stage::HandPoll);
+    if(_jobs) _jobs->wait(_handsPrepared);
+    else prepareHands();
+    _handsPending = false;
+    const bool tracked = _tracked;
+    _hands.computeWorldFingertips(toWorldSpace);
+    _headPosition = invertedHeadPose.translation();
+
+    /* Touch detection needs just the hands, so it runs on a worker while
+       the instance data get uploaded */
+    if(_jobs) _jobs->run(_touchesDetected, detectTouchesJob, this);
+    _handRenderer->prepare();
+    _profiler.end();
+
+    _profiler.begin(FrameProfiler::Stage::TouchInput);
+    if(_jobs) _jobs->wait(_touchesDetected);
+    else detectTouches();
+    dispatchTouches();
+    _profiler.end();
+
+    /* Nothing to render, let the compositor reproject the previous frame.
+       Hands for the next frame can be prepared already. */
+    if(_frameReuse && canReuseFrame()) {
+        ++_reusedInRow;
+        ++_reuseStats.reused;
+        _frameStats.reused = true;
+        _frameStats.poseAge = UnsignedInt(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _renderedPoseTime).count());
+        if(_telemetryExporter) exportTelemetry();
+
+        if(_jobs && _pipelined) {
+            _jobs->run(_handsPrepared, prepareHandsJob, this);
+            _handsPending = true;
+        }
+
+        _profiler.begin(FrameProfiler::Stage::Submit);
+        _hmd.resubmitFrame();
+        _profiler.end();
+        return;
+    }
+
+    /* GPU time of everything rendered for this frame drives the
+       resolution scale */
+    _resolution.beginFrame();
+
+    /* Render the UI into the cache if anything changed, before any eye
+       target is bound */
+    if(_cachedUi) {
+        _profiler.begin(FrameProfiler::Stage::UiDraw);
+        if(_cachedUi->update()) {
+            _frameStats.drawCalls += 1;
+            _frameStats.estimatedStateChanges += 3;
+        }
+        _profiler.end();
+    }
+
+    /* Everything up to here didn't depend on where the head looks, poll the
+       poses again as late as possible and draw with those */
+    if(_lateLatching) {
+        _profiler.begin(FrameProfiler::Stage::PosePoll);
+        _hmd.pollPoses();
+        _profiler.end();
+        toWorldSpace = _hmd.headPose().toMatrix()*leapToView;
+    }
+
+    Matrix4 viewProjMatrix[2];
+    for(Int eye: {0, 1})
+        viewProjMatrix[eye] = _projectionMatrix[eye]*_hmd.eyePose(eye).inverted().toMatrix();
+
+    /* Cull panels and hands once against a frustum enclosing both eyes,
+       only the survivors get tested for each eye */
+    const StereoFrustum frustum{viewProjMatrix[0], viewProjMatrix[1]};
+    _panels.cull(frustum, {_panelEyeMasks.data(), _panelEyeMasks.size()});
+    UnsignedByte handEyes{};
+    if(tracked && _handRenderer->boneCount()) {
+        const Range3D handBounds = transformBox(toWorldSpace, _handRenderer->bounds());
+        if(frustum.test(handBounds) != StereoFrustum::Test::Outside)
+            handEyes = frustum.eyeMask(handBounds);
+        if(handEyes) ++_frameStats.visibleObjects;
+        else ++_frameStats.culledObjects;
+    }
+    _frameStats.visibleObjects += _panels.cullStats().visible;
+    _frameStats.culledObjects += _panels.cullStats().culled;
+
+    /* Draw the scene for both eyes in a single pass into a side-by-side
+       target */
+    if(_singlePassStereo) {
+        bindEyeTarget(0);
+
+        /* Magnum::Ui has no stereo-aware shaders, so it's drawn into each
+           half separately */
+        GL::Renderer::setDepthFunction(GL::Renderer::DepthFunction::Always);
+        for(Int eye: {0, 1}) {
+            _profiler.begin(FrameProfiler::Stage::UiDraw, eye);
+            _framebuffer[0].setViewport(_eyeViewport[eye]);
+            drawUi(eye, viewProjMatrix[eye]);
+            _profiler.end();
+            _frameStats.estimatedStateChanges += 1;
+        }
+        GL::Renderer::setDepthFunction(GL::Renderer::DepthFunction::Less);
+        _frameStats.estimatedStateChanges += 2;
+
+        /* Render hands for both eyes at once */
+        _profiler.begin(FrameProfiler::Stage::HandDraw, FrameProfiler::BothEyes);
+        _framebuffer[0].setViewport(_stereoViewport);
+        _frameStats.estimatedStateChanges += 1;
+        if(handEyes) {
+            /* Clips away what the stereo shaders would leak into the other
+               eye. Shaders not writing gl_ClipDistance[0] get undefined
+               clipping with it enabled, so it's on only for this draw. */
+            glEnable(GL_CLIP_DISTANCE0);
+            _handRenderer->drawStereo(viewProjMatrix[0]*toWorldSpace, viewProjMatrix[1]*toWorldSpace);
+            glDisable(GL_CLIP_DISTANCE0);
+            _frameStats.estimatedStateChanges += 2;
+        }
+        _profiler.end();
+
+        if(_sampleCount) {
+            _profiler.begin(FrameProfiler::Stage::Resolve, FrameProfiler::BothEyes);
+            resolveEyeTarget(0);
+            _profiler.end();
+        }
+
+        _profiler.begin(FrameProfiler::Stage::Commit, FrameProfiler::BothEyes);
+        commitEyeTarget(0);
+        _profiler.end();
+
+    /* Draw the scene for both eyes separately */
+    } else for(Int eye: {0, 1}) {
+        bindEyeTarget(eye);
+
+        _profiler.begin(FrameProfiler::Stage::UiDraw, eye);
+        GL::Renderer::setDepthFunction(GL::Renderer::DepthFunction::Always);
+        drawUi(eye, viewProjMatrix[eye]);
+        GL::Renderer::setDepthFunction(GL::Renderer::DepthFunction::Less);
+        _profiler.end();
+        _frameStats.estimatedStateChanges += 2;
+
+        /* Render hands */
+        _profiler.begin(FrameProfiler::Stage::HandDraw, eye);
+        if(handEyes & (1 << eye)) _handRenderer->draw(viewProjMatrix[eye]*toWorldSpace);
+        _profiler.end();
+
+        if(_sampleCount) {
+            _profiler.begin(FrameProfiler::Stage::Resolve, eye);
+            resolveEyeTarget(eye);
+            _profiler.end();
+        }
+
+        _profiler.begin(FrameProfiler::Stage::Commit, eye);
+        commitEyeTarget(eye);
+        _profiler.end();
+    }
+
+    _resolution.endFrame();
+
+    _frameStats.drawCalls += _handRenderer->drawCallCount();
+    _frameStats.estimatedStateChanges += _handRenderer->estimatedStateChangeCount();
+    _frameStats.uploadedBytes = _handRenderer->uploadedBytes();
+    _frameStats.fenceWaits = _handRenderer->fenceWaitCount();
+    _frameStats.poseAge = UnsignedInt(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _hmd.poseTime()).count());
+
+    /* What the next frames get compared against to be reused. Telemetry
+       applied after this frame counts as a change. Recorded before the
+       next hands start being prepared into the same snapshot on a
+       worker. */
+    _sceneChanged = false;
+    _renderedHands = _hands.handCount() != 0;
+    _renderedHeadPose = _hmd.headPose();
+    _renderedPoseTime = _hmd.poseTime();
+    _renderedTelemetryUpdates = _telemetry.updateCount();
+    _renderedPanelChanges = _panels.changeCount();
+    _reusedInRow = 0;
+
+    /* Exported before the next hands get prepared as well */
+    if(_telemetryExporter) exportTelemetry();
+
+    /* Nothing reads the hands anymore, so the next ones can be prepared
+       while this frame is being submitted */
+    if(_jobs && _pipelined) {
+        _jobs->run(_handsPrepared, prepareHandsJob, this);
+        _handsPending = true;
+    }
+
+    _profiler.begin(FrameProfiler::Stage::Submit);
+    _hmd.submitFrame();
+    _profiler.end();
+}
+
+void Gallery::exportTelemetry() {
+    if(!_telemetryExporter->isOpen()) return;
+
+    /* Filled in place in the shared memory, nothing here allocates */
+    const auto now = std::chrono::steady_clock::now();
+    SharedTelemetry::Frame& frame = _telemetryExporter->beginFrame();
+    frame.frameIndex = _frameIndex;
+    frame.timestamp = UnsignedLong(std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count());
+    frame.handTimestamp = _hands.timestamp();
+
+    const auto writePose = [](Float(&out)[8], const DualQuaternion& pose) {
+        const Quaternion& real = pose.real();
+        const Quaternion& dual = pose.dual();
+        out[0] = real.vector().x();
+        out[1] = real.vector().y();
+        out[2] = real.vector().z();
+        out[3] = real.scalar();
+        out[4] = dual.vector().x();
+        out[5] = dual.vector().y();
+        out[6] = dual.vector().z();
+        out[7] = dual.scalar();
+    };
+    writePose(frame.headPose, _hmd.headPose());
+    for(Int eye: {0, 1}) writePose(frame.eyePoses[eye], _hmd.eyePose(eye));
+
+    frame.cpuTime = UnsignedInt(std::chrono::duration_cast<std::chrono::microseconds>(now - _frameStart).count());
+    frame.poseAge = _frameStats.poseAge;
+    frame.drawCalls = _frameStats.drawCalls;
+    frame.estimatedStateChanges = _frameStats.estimatedStateChanges;
+    frame.resolutionScale = _resolution.scale();
+    frame.flags = (_tracked ? SharedTelemetry::HandsTracked : 0)|
+        (_frameStats.reused ? SharedTelemetry::FrameReused : 0);
+
+    for(Int i: {0, 1}) {
+        const Vector3& position = _touch[i].position();
+        frame.touchPanel[i] = _touchPanel[i];
+        frame.touchEvent[i] = UnsignedInt(_touchEvent[i]);
+        frame.touchPosition[i][0] = position.x();
+        frame.touchPosition[i][1] = position.y();
+        frame.touchPosition[i][2] = position.z();
+    }
+
+    frame.handCount = _hands.handCount();
+    frame.jointCount = _hands.jointCount();
+    frame.rightHandMask = 0;
+    for(UnsignedInt hand = 0; hand != _hands.handCount(); ++hand)
+        if(_hands.isRight(hand)) frame.rightHandMask |= 1 << hand;
+    frame.reserved = 0;
+    for(UnsignedInt joint = 0; joint != _hands.jointCount(); ++joint) {
+        const Vector3 position = _hands.jointPosition(joint);
+        frame.jointHand[joint] = UnsignedByte(_hands.jointHand(joint));
+        frame.joints[joint][0] = position.x();
+        frame.joints[joint][1] = position.y();
+        frame.joints[joint][2] = position.z();
+    }
+
+    _telemetryExporter->endFrame();
+}
+
+bool Gallery::canReuseFrame() {
+    /* With the UI cached, its dirty flag covers touches and telemetry as
+       well, without it they're checked separately */
+    if(_sceneChanged || (_cachedUi && _cachedUi->isDirty()) ||
+       _telemetry.updateCount() != _renderedTelemetryUpdates ||
+       _panels.changeCount() != _renderedPanelChanges) {
+        ++_reuseStats.sceneChanged;
+        return false;
+    }
+
+    /* Hands that just disappeared are still in the previous frame */
+    if(_hands.handCount() || _renderedHands) {
+        ++_reuseStats.handsVisible;
+        return false;
+    }
+
+    const DualQuaternion& headPose = _hmd.headPose();
+    const Float cosHalfAngle = Math::min(Math::abs(Math::dot(headPose.rotation(), _renderedHeadPose.rotation())), 1.0f);
+    if(2.0f*Math::acos(cosHalfAngle) > _reuseRotationThreshold ||
+       (headPose.translation() - _renderedHeadPose.translation()).dot() > _reuseTranslationThreshold*_reuseTranslationThreshold) {
+        ++_reuseStats.headMoved;
+        return false;
+    }
+
+    if(_reusedInRow >= _maxReusedFrames) {
+        ++_reuseStats.capReached;
+        return false;
+    }
+
+    return true;
+}
+
+void Gallery::drawUi(const Int eye, const Matrix4& viewProjection) {
+    /* Panels hidden or culled for this eye have an empty mask */
+    if(_panelEyeMasks[GalleryPanel] & (1 << eye)) {
+        const Matrix4 transformationProjection = viewProjection*_panels.transformation(GalleryPanel)*UiScaling;
+        if(_cachedUi) {
+            _cachedUi->draw(transformationProjection);
+            _frameStats.estimatedStateChanges += 2;
+        } else {
+            _ui->setViewProjectionMatrix(transformationProjection);
+            _ui->draw();
+        }
+        _frameStats.drawCalls += 1;
+    }
+
+    /* Additional panels are drawn directly */
+    for(UnsignedInt id = GalleryPanel + 1; id != _panelUis.size(); ++id) {
+        if(!(_panelEyeMasks[id] & (1 << eye))) continue;
+        _panelUis[id]->setViewProjectionMatrix(viewProjection*_panels.transformation(id)*UiScaling);
+        _panelUis[id]->draw();
+        _frameStats.drawCalls += 1;
+    }
+}
+
+void Gallery::prepareHands() {
+    _tracked = _handSource->frame(_hands);
+    _hands.computeBoneTransformations();
+    _handRenderer->setHands(_hands);
+}
+
+void Gallery::detectTouches() {
+    /* Query all fingertips of both hands at once. The pointing rays go from
+       the head through the fingertips. */
+    const UnsignedInt fingertipCount = _hands.handCount()*HandSnapshot::FingerCount;
+    Vector3 fingertips[HandSnapshot::MaxFingertips];
+    for(UnsignedInt i = 0; i != fingertipCount; ++i)
+        fingertips[i] = _hands.worldFingertip(i/HandSnapshot::FingerCount, i%HandSnapshot::FingerCount);
+    _panels.querySpheres({fingertips, fingertipCount}, TouchQueryRadius, {_fingertipHits, fingertipCount});
+    for(UnsignedInt i = 0; i != fingertipCount; ++i)
+        _pointerHits[i] = _panels.queryRay(_headPosition, (fingertips[i] - _headPosition).normalized(), PointerDistance);
+    for(UnsignedInt i = fingertipCount; i != HandSnapshot::MaxFingertips; ++i)
+        _fingertipHits[i] = _pointerHits[i] = {};
+
+    for(const Int i: {0, 1}) {
+        FingertipTouch& touch = _touch[i];
+        Int& panel = _touchPanel[i];
+        const Int hand = _hands.hand(i == 0);
+
+        _handLost[i] = hand == -1;
+        if(hand == -1) {
+            _touchEvent[i] = touch.lose();
+            continue;
+        }
+
+        /* A press stays on its panel until released, even if the fingertip
+           slides off it. Otherwise the touch follows the nearest panel,
+           restarting the filter so it doesn't smooth across two unrelated
+           panels. */
+        if(!touch.isPressed()) {
+            const Int hit = fingertipHit(hand, HandSnapshot::Index).panel;
+            if(hit != panel) {
+                touch.lose();
+                panel = hit;
+            }
+        }
+
+        _touchEvent[i] = panel == -1 ? FingertipTouch::Event::None :
+            touch.update(_panels.project(panel, _hands.worldFingertip(hand, HandSnapshot::Index)).position, _hands.timestamp());
+    }
+}
+
+void Gallery::dispatchTouches() {
+    for(const Int i: {0, 1}) {
+        Int& panel = _touchPanel[i];
+        if(panel == -1) continue;
+
+        /* Every event can change hover or press state of some widget, or
+           show or hide a plane */
+        const FingertipTouch::Event event = _touchEvent[i];
+        if(event != FingertipTouch::Event::None) _sceneChanged = true;
+        if(_cachedUi && panel == GalleryPanel && event != FingertipTouch::Event::None)
+            _cachedUi->invalidate();
+
+        Ui::UserInterface& ui = *_panelUis[panel];
+        const Vector2i screenPos = _panels.pixelPosition(panel, _touch[i].position().xy());
+
+        /* Widgets re-layout their text in response to events inside the
+           UI library */
+        {
+            AllocationCounter::Exempt exempt;
+            switch(event) {
+                case FingertipTouch::Event::Press:
+                    ui.handlePressEvent(screenPos);
+                    break;
+                case FingertipTouch::Event::Move:
+                    ui.handleMoveEvent(screenPos);
+                    break;
+                case FingertipTouch::Event::Release:
+                    ui.handleReleaseEvent(screenPos);
+                    break;
+                case FingertipTouch::Event::None:
+                    break;
+            }
+        }
+
+        if(_handLost[i]) panel = -1;
+    }
+
+    /* Modal planes are ours, so a tapped modal is activated only after the
+       event handling and creating its plane counts as an allocation of the
+       frame loop */
+    if(_tappedModal != -1) {
+        _modals->activate(UnsignedInt(_tappedModal));
+        _tappedModal = -1;
+    }
+}
+
+void Gallery::updateUi() {
+    _profiler.begin(FrameProfiler::Stage::UiUpdate);
+    const Vector3& screenSpace = _touch[0].position();
+    const Vector2i screenPos = _touchPanel[0] == -1 ? Vector2i{} :
+        _panels.pixelPosition(_touchPanel[0], screenSpace.xy());
+    const UnsignedLong telemetryUpdates = _telemetry.updateCount();
+    _telemetry
+        .set(0, screenPos.x())
+        .set(1, screenPos.y())
+        .set(2, screenSpace.x())
+        .set(3, screenSpace.y())
+        .set(4, screenSpace.z())
+        .set(5, _resolution.scale());
+
+    /* With a job system the values are formatted on a worker and pushed to
+       the widgets at the beginning of the next frame */
+    if(_jobs) {
+        _jobs->run(_telemetryFormatted, formatTelemetryJob, this);
+        _telemetryPending = true;
+    } else {
+        _telemetry.flush();
+        if(_cachedUi && _telemetry.updateCount() != telemetryUpdates)
+            _cachedUi->invalidate();
+    }
+
+    /* Modals closed during touch dispatch can be destroyed only now, outside
+       of their own signal handlers */
+    _modals->collect();
+    _profiler.end();
+
+    _profiler.endFrame();
+}
+
+void Gallery::updateEyeViewports() {
+    Vector2i size[2];
+    for(Int eye: {0, 1})
+        size[eye] = Math::max(Vector2i{Vector2{_eyeTextureSize[eye]}*_resolution.scale()}, Vector2i{1});
+
+    /* In single-pass stereo mode the eyes have the same size and stay next
+       to each other so the stereo shaders can split the viewport in half */
+    _eyeViewport[0] = {{}, size[0]};
+    if(_singlePassStereo) {
+        _eyeViewport[1] = Range2Di::fromSize({size[0].x(), 0}, size[1]);
+        _stereoViewport = {{}, {2*size[0].x(), size[0].y()}};
+    } else {
+        _eyeViewport[1] = {{}, size[1]};
+        for(Int eye: {0, 1}) _framebuffer[eye].setViewport(_eyeViewport[eye]);
+    }
+
+    for(Int eye: {0, 1})
+        _hmd.setEyeViewport(eye, _singlePassStereo ? 0 : eye, _eyeViewport[eye]);
+
+    _handRenderer->setViewportSize(size[0]);
+}
+
+void Gallery::createEyeFramebuffers() {
+    for(Int target = 0; target != (_singlePassStereo ? 1 : 2); ++target) {
+        const Vector2i& size = _targetSize[target];
+
+        /* Create the framebuffer which will be used to render to the current
+           texture of the texture set later. */
+        _framebuffer[target] = GL::Framebuffer{{{}, size}};
+        _framebuffer[target].mapForDraw(GL::Framebuffer::ColorAttachment(0));
+
+        /* Without multisampling, the swap chain texture and the depth
+           texture get attached every frame */
+        if(!_sampleCount) {
+            _multisampledColor[target] = GL::Renderbuffer{NoCreate};
+            _multisampledDepth[target] = GL::Renderbuffer{NoCreate};
+            _resolveFramebuffer[target] = GL::Framebuffer{NoCreate};
+
+            /* Setup depth attachment */
+            _depth[target] = GL::Texture2D{};
+            _depth[target].setMinificationFilter(GL::SamplerFilter::Linear)
+                          .setWrapping(GL::SamplerWrapping::ClampToEdge)
+                          .setStorage(1, GL::TextureFormat::DepthComponent32F, size);
+            continue;
+        }
+
+        /* Otherwise the multisampled buffers stay attached and only the
+           resolve target changes. The swap chain textures may be sRGB, but
+           with sRGB conversion disabled the resolve copies values as-is. */
+        _depth[target] = GL::Texture2D{NoCreate};
+        _multisampledColor[target] = GL::Renderbuffer{};
+        _multisampledColor[target].setStorageMultisample(_sampleCount, GL::RenderbufferFormat::RGBA8, size);
+        _multisampledDepth[target] = GL::Renderbuffer{};
+        _multisampledDepth[target].setStorageMultisample(_sampleCount, GL::RenderbufferFormat::DepthComponent32F, size);
+        _framebuffer[target]
+            .attachRenderbuffer(GL::Framebuffer::ColorAttachment(0), _multisampledColor[target])
+            .attachRenderbuffer(GL::Framebuffer::BufferAttachment::Depth, _multisampledDepth[target]);
+        _resolveFramebuffer[target] = GL::Framebuffer{{{}, size}};
+    }
+}
+
+void Gallery::bindEyeTarget(const Int target) {
+    if(_sampleCount) {
+        _framebuffer[target]
+            .clear(GL::FramebufferClear::Color|GL::FramebufferClear::Depth)
+            .bind();
+        _frameStats.estimatedStateChanges += 1;
+        return;
+    }
+
+    /* Switch to eye render target and bind render textures */
+    _framebuffer[target]
+        .attachTexture(GL::Framebuffer::ColorAttachment(0), _hmd.activeTexture(target), 0)
+        .attachTexture(GL::Framebuffer::BufferAttachment::Depth, _depth[target], 0)
+        /* Clear with the standard grey so that at least that will be visible in
+        case the scene is not correctly set up */
+        .clear(GL::FramebufferClear::Color|GL::FramebufferClear::Depth)
+        .bind();
+    _frameStats.estimatedStateChanges += 3;
+}
+
+void Gallery::resolveEyeTarget(const Int target) {
+    /* Resolve only the rendered part, which is the current viewport. The
+       multisampled contents aren't needed afterwards, which saves a
+       write-back on tiled GPUs. */
+    const Range2Di viewport = _framebuffer[target].viewport();
+    _resolveFramebuffer[target].attachTexture(GL::Framebuffer::ColorAttachment(0), _hmd.activeTexture(target), 0);
+    GL::Framebuffer::blit(_framebuffer[target], _resolveFramebuffer[target],
+        viewport, viewport,
+        GL::FramebufferBlit::Color, GL::FramebufferBlitFilter::Nearest);
+    _framebuffer[target].invalidate({GL::Framebuffer::ColorAttachment(0),
+                                     GL::Framebuffer::BufferAttachment::Depth});
+    _frameStats.estimatedStateChanges += 2;
+}
+
+void Gallery::commitEyeTarget(const Int target) {
+    /* Commit changes and use next texture in chain */
+    _hmd.commit(target);
+
+    if(_sampleCount) {
+        _resolveFramebuffer[target].detach(GL::Framebuffer::ColorAttachment(0));
+        _frameStats.estimatedStateChanges += 1;
+        return;
+    }
+
+    /* Reasoning for the next two lines, taken from the Oculus SDK examples
+       code: Without this, [during the next frame, this method] would bind a
+       framebuffer with an invalid COLOR_ATTACHMENT0 because the texture ID
+       associated with COLOR_ATTACHMENT0 had been unlocked by calling
+       wglDXUnlockObjectsNV(). */
+    _framebuffer[target].detach(GL::Framebuffer::ColorAttachment(0))
+                        .detach(GL::Framebuffer::BufferAttachment::Depth);
+    _frameStats.estimatedStateChanges += 2;
+}
+
+}
@@ -0,0 +1,715 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_Gallery_h
+#define Magnum_VrUi_Gallery_h
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Math/DualQuaternion.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
+
+#include "CachedUi.h"
+#include "FingertipTouch.h"
+#include "FrameProfiler.h"
+#include "GalleryUi.h"
+#include "HandRenderer.h"
+#include "HandSnapshot.h"
+#include "JobSystem.h"
+#include "ModalPool.h"
+#include "PanelRegistry.h"
+#include "ResolutionController.h"
+#include "TelemetryPanel.h"
+
+namespace Magnum {
+
+class AbstractHandSource;
+class AbstractHmd;
+class StartupCache;
+class TelemetryExporter;
+
+/**
+@brief UI gallery scene
+
+The whole per-frame pipeline of the gallery --- polling hand tracking and
+head poses, rendering the UI and hands for both eyes, submitting the frame
+and handling fingertip touches on the UI --- independent of the windowing
+toolkit and the VR runtime, so it can run both in the app and in headless
+benchmarks.
+
+With a @ref JobSystem set in @ref Configuration::setJobSystem(), per-frame
+CPU work that doesn't need GL is done on worker threads --- hand polling,
+bone transformations and instance data while head poses are polled, touch
+detection while the instance data are uploaded and telemetry formatting
+after the frame got submitted. With @ref Configuration::setPipelined(),
+hands for the next frame are prepared already while the current frame is
+being submitted.
+
+The gallery UI and any panels added with @ref addPanel() are placed in
+world space through a @ref PanelRegistry, which is queried every frame for
+all fingertips of both hands. Touches of the index fingertips are delivered
+to whichever panel they hit. Panels and hands are culled once per frame
+against a @ref StereoFrustum enclosing both eyes, and the survivors are
+then drawn only in the eyes that see them.
+
+With a sample count set in @ref Configuration::setSampleCount() or
+@ref setSampleCount(), eyes are rendered into multisampled color and depth
+renderbuffers and only the rendered part gets resolved into the swap chain
+texture before each commit. The resolve is recorded as a separate
+@ref FrameProfiler::Stage::Resolve stage.
+
+Each frame starts by waiting for the compositor frame boundary through
+@ref AbstractHmd::waitForFrame(). Work that doesn't depend on where the
+head is looking --- hands, touches and the UI cache --- is done first, with
+head poses polled early only for touch input. With
+@ref Configuration::setLateLatching() enabled, which is the default, the
+poses are then polled again right before culling and drawing the eyes, and
+view matrices are updated from them, so the rendered frame is as close to
+the head pose at display time as possible. Age of the poses at submit is
+recorded in @ref FrameStats::poseAge.
+
+With @ref Configuration::setFrameReuse() enabled, a frame in which no hands
+are visible, nothing in the scene changed since the last rendered frame and
+the head moved less than a threshold isn't rendered at all. The previous
+eye textures are submitted again instead and the compositor reprojects them
+to the current head pose. At most
+@ref Configuration::maxReusedFrames() frames in a row are reused. Changes
+the gallery can't see, such as widget changes in panels added with
+@ref addPanel(), have to be signalled with @ref invalidateFrame().
+
+With a @ref TelemetryExporter set in
+@ref Configuration::setTelemetryExporter(), head and eye poses, hands,
+touches and frame statistics of every frame, rendered or reused, are written
+into shared memory right before submit, for external tools to read through
+a @ref TelemetryReader.
+*/
+class Gallery {
+    public:
+        class Configuration;
+
+        /** @brief Panel ID of the gallery UI in @ref panels() */
+        enum: UnsignedInt { GalleryPanel = 0 };
+
+        /**
+         * @brief Per-frame statistics
+         *
+         * Counted on the application side, so a single UI draw counts as
+         * one draw call regardless of how many meshes it consists of.
+         * State changes aren't measured, they're an estimate counted by
+         * hand next to the framebuffer binds, attachments, viewport, depth
+         * function and clip distance changes and shader uniform and buffer
+         * updates of the hand renderer, useful only for comparing code
+         * paths of the same build. Uploaded bytes and fence waits are of the
+         * per-frame hand instance data, see @ref StreamingBuffer. Visible
+         * and culled objects are panels and both hands together, see
+         * @ref PanelRegistry::cullStats() for details about the panels.
+         * Pose age is time in microseconds from polling the head poses used
+         * for rendering to submitting the frame. A reused frame has no draw
+         * calls and state changes and its pose age is of the frame it
+         * reuses.
+         */
+        struct FrameStats {
+            UnsignedInt drawCalls;
+            UnsignedInt estimatedStateChanges;
+            std::size_t uploadedBytes;
+            UnsignedInt fenceWaits;
+            UnsignedInt visibleObjects;
+            UnsignedInt culledObjects;
+            UnsignedInt poseAge;
+            bool reused;
+        };
+
+        /**
+         * @brief Frame reuse statistics
+         *
+         * Count of reused frames and of rendered frames by the first
+         * reason they couldn't be reused --- the scene changed, hands were
+         * visible in this or the last rendered frame, the head moved too
+         * much or too many frames were reused in a row. Counted only with
+         * frame reuse enabled.
+         */
+        struct FrameReuseStats {
+            UnsignedLong reused;
+            UnsignedLong sceneChanged;
+            UnsignedLong handsVisible;
+            UnsignedLong headMoved;
+            UnsignedLong capReached;
+        };
+
+        /**
+         * @brief Constructor
+         *
+         * Expects that a GL context is created and current.
+         */
+        explicit Gallery(AbstractHmd& hmd, std::unique_ptr<AbstractHandSource> handSource, const Configuration& configuration);
+
+        ~Gallery();
+
+        /**
+         * @brief Hand renderer
+         *
+         * If hands of the next frame are being prepared on a worker, waits
+         * for it to finish first.
+         */
+        HandRenderer& handRenderer();
+
+        /** @brief Telemetry display of fingertip position */
+        TelemetryPanel& telemetry() { return _telemetry; }
+
+        /**
+         * @brief Frame profiler
+         *
+         * A frame spans from @ref drawFrame() to the end of
+         * @ref updateUi(), anything the application does in between can
+         * be recorded as well.
+         */
+        FrameProfiler& profiler() { return _profiler; }
+
+        /**
+         * @brief Eye buffer resolution controller
+         *
+         * The current scale is shown in the telemetry.
+         */
+        ResolutionController& resolutionController() { return _resolution; }
+
+        /**
+         * @brief Eye buffer sample count
+         *
+         * @cpp 0 @ce if the eyes are rendered directly into the swap chain
+         * textures without multisampling.
+         */
+        Int sampleCount() const { return _sampleCount; }
+
+        /**
+         * @brief Set eye buffer sample count
+         *
+         * Recreates the eye framebuffers. Counts below @cpp 2 @ce disable
+         * multisampling, counts above what the driver supports are clamped
+         * with a warning.
+         */
+        Gallery& setSampleCount(Int count);
+
+        /** @brief Whether unchanged frames are reused */
+        bool isFrameReuse() const { return _frameReuse; }
+
+        /**
+         * @brief Enable or disable frame reuse
+         *
+         * See @ref Configuration::setFrameReuse().
+         */
+        Gallery& setFrameReuse(bool enabled) {
+            _frameReuse = enabled;
+            return *this;
+        }
+
+        /** @brief Frame reuse statistics */
+        const FrameReuseStats& frameReuseStats() const { return _reuseStats; }
+
+        /**
+         * @brief Force the next frame to be rendered
+         *
+         * For changes the gallery doesn't know about, such as widget
+         * changes in panels added with @ref addPanel().
+         */
+        Gallery& invalidateFrame() {
+            _sceneChanged = true;
+            return *this;
+        }
+
+        /** @brief Whether head poses are polled again before drawing */
+        bool isLateLatching() const { return _lateLatching; }
+
+        /**
+         * @brief Enable or disable late latching of head poses
+         *
+         * See @ref Configuration::setLateLatching().
+         */
+        Gallery& setLateLatching(bool enabled) {
+            _lateLatching = enabled;
+            return *this;
+        }
+
+        /**
+         * @brief Modal dialogs of the gallery UI
+         *
+         * Dialog IDs are in the order of the modal buttons --- default,
+         * danger, success, warning and info.
+         */
+        ModalPool& modals() { return *_modals; }
+
+        /** @brief Whether the UI is drawn through a @ref CachedUi */
+        bool isUiCached() const { return !!_cachedUi; }
+
+        /**
+         * @brief UI cache
+         *
+         * Expects that the UI is cached.
+         */
+        CachedUi& cachedUi();
+
+        /**
+         * @brief World-space UI panels
+         *
+         * Use it to move or hide panels. The gallery UI is
+         * @ref GalleryPanel.
+         */
+        PanelRegistry& panels() { return _panels; }
+
+        /**
+         * @brief Add a UI panel
+         * @return Panel ID in @ref panels()
+         *
+         * The @p ui is drawn in both eyes with the same mapping of its
+         * screen to the @ref PanelRegistry unit square as the gallery UI
+         * and receives fingertip touches. It's expected to stay alive for
+         * the whole lifetime of the gallery.
+         */
+        UnsignedInt addPanel(Ui::UserInterface& ui, const Matrix4& transformation);
+
+        /**
+         * @brief Panel touched by a fingertip in last frame
+         *
+         * Nearest panel at most @cpp 5 @ce centimeters from the fingertip.
+         * Hand @cpp 0 @ce is the first hand in the @ref HandSnapshot, not
+         * necessarily the right one.
+         */
+        const PanelRegistry::Hit& fingertipHit(UnsignedInt hand, UnsignedInt finger) const {
+            return _fingertipHits[hand*HandSnapshot::FingerCount + finger];
+        }
+
+        /**
+         * @brief Panel pointed at by a fingertip in last frame
+         *
+         * First panel hit by a ray from the head through the fingertip.
+         * Hand indexing is the same as in @ref fingertipHit().
+         */
+        const PanelRegistry::Hit& pointerHit(UnsignedInt hand, UnsignedInt finger) const {
+            return _pointerHits[hand*HandSnapshot::FingerCount + finger];
+        }
+
+        /** @brief Statistics of the last drawn frame */
+        const FrameStats& frameStats() const { return _frameStats; }
+
+        /**
+         * @brief Fingertip touch detection
+         *
+         * Hand @cpp 0 @ce is the right one, @cpp 1 @ce the left one.
+         */
+        FingertipTouch& touch(Int hand) { return _touch[hand]; }
+
+        /**
+         * @brief Draw a frame
+         *
+         * Waits for the compositor frame boundary, polls hand tracking and
+         * head poses, handles fingertip touches on the UI, renders both
+         * eyes and submits the frame to the HMD. The touches are handled
+         * before drawing, so the UI reacts to them already in the same
+         * frame. If the frame can be reused, submits the previous one
+         * again instead of rendering.
+         */
+        void drawFrame();
+
+        /**
+         * @brief Update the UI after a frame got submitted
+         *
+         * Pushes fingertip telemetry to the UI, changes get visible in the
+         * next frame. Ends the frame in @ref profiler().
+         */
+        void updateUi();
+
+    private:
+        void drawUi(Int eye, const Matrix4& viewProjection);
+        bool canReuseFrame();
+        void exportTelemetry();
+        void updateEyeViewports();
+        void createEyeFramebuffers();
+
+        /* Parts of the frame that can run on a worker, the static
+           functions are the job entry points */
+        static void prepareHandsJob(void* gallery);
+        static void detectTouchesJob(void* gallery);
+        static void formatTelemetryJob(void* gallery);
+        void prepareHands();
+        void detectTouches();
+        void dispatchTouches();
+        void waitForJobs();
+
+        /* Target is the eye index, or always 0 in single-pass stereo mode */
+        void bindEyeTarget(Int target);
+        void resolveEyeTarget(Int target);
+        void commitEyeTarget(Int target);
+
+        AbstractHmd& _hmd;
+        JobSystem* _jobs;
+        bool _pipelined;
+        bool _lateLatching;
+        FrameStats _frameStats{};
+
+        /* Shared memory telemetry. The frame start is right after the
+           compositor frame boundary. */
+        TelemetryExporter* _telemetryExporter;
+        UnsignedLong _frameIndex{};
+        std::chrono::steady_clock::time_point _frameStart;
+
+        /* Frame reuse. State of the last rendered frame is recorded also
+           with reuse disabled, so it can be enabled any time. */
+        bool _frameReuse;
+        bool _sceneChanged{true};
+        bool _renderedHands{};
+        UnsignedInt _maxReusedFrames, _reusedInRow{};
+        Rad _reuseRotationThreshold;
+        Float _reuseTranslationThreshold;
+        DualQuaternion _renderedHeadPose;
+        std::chrono::steady_clock::time_point _renderedPoseTime;
+        UnsignedLong _renderedTelemetryUpdates{}, _renderedPanelChanges{};
+        FrameReuseStats _reuseStats{};
+        FrameProfiler _profiler;
+        ResolutionController _resolution;
+
+        /* Hand tracking and rendering */
+        std::unique_ptr<AbstractHandSource> _handSource;
+        HandSnapshot _hands;
+        Containers::Optional<HandRenderer> _handRenderer;
+        FingertipTouch _touch[2];
+
+        /* Job state. Hands are prepared for the next frame if
+           _handsPrepared was submitted during the previous one. */
+        JobSystem::Counter _handsPrepared, _touchesDetected, _telemetryFormatted;
+        bool _handsPending{}, _telemetryPending{};
+        bool _tracked{};
+        Vector3 _headPosition;
+        FingertipTouch::Event _touchEvent[2]{};
+        bool _handLost[2]{};
+
+        /* Per eye view members. In single-pass stereo mode only the first
+           texture and framebuffer is used for both eyes. The viewports are
+           the scaled part of the full eye texture size that gets rendered
+           into. With multisampling, the framebuffers have the multisampled
+           renderbuffers attached permanently and get resolved into the
+           swap chain textures through the resolve framebuffers. */
+        bool _singlePassStereo;
+        Int _sampleCount{};
+        Vector2i _eyeTextureSize[2], _targetSize[2];
+        Range2Di _eyeViewport[2];
+        Range2Di _stereoViewport;
+        GL::Texture2D _depth[2]{GL::Texture2D{NoCreate},
+                                GL::Texture2D{NoCreate}};
+        GL::Framebuffer _framebuffer[2]{GL::Framebuffer{NoCreate},
+                                        GL::Framebuffer{NoCreate}};
+        GL::Renderbuffer _multisampledColor[2]{GL::Renderbuffer{NoCreate},
+                                               GL::Renderbuffer{NoCreate}};
+        GL::Renderbuffer _multisampledDepth[2]{GL::Renderbuffer{NoCreate},
+                                               GL::Renderbuffer{NoCreate}};
+        GL::Framebuffer _resolveFramebuffer[2]{GL::Framebuffer{NoCreate},
+                                               GL::Framebuffer{NoCreate}};
+        Matrix4 _projectionMatrix[2];
+
+        /* Ui */
+        Containers::Optional<Ui::UserInterface> _ui;
+        Containers::Optional<CachedUi> _cachedUi;
+        Containers::Optional<BaseUiPlane> _baseUiPlane;
+        Containers::Optional<ModalPool> _modals;
+        Int _tappedModal{-1};
+        TelemetryPanel _telemetry;
+
+        /* World-space panels, UIs indexed by panel ID. Touches stay on the
+           panel they started at until released, -1 if none. */
+        PanelRegistry _panels;
+        std::vector<Ui::UserInterface*> _panelUis;
+        std::vector<UnsignedByte> _panelEyeMasks;
+        Int _touchPanel[2]{-1, -1};
+        PanelRegistry::Hit _fingertipHits[HandSnapshot::MaxFingertips],
+            _pointerHits[HandSnapshot::MaxFingertips];
+};
+
+/**
+@brief Gallery configuration
+
+@see @ref Gallery::Gallery()
+*/
+class Gallery::Configuration {
+    public:
+        HandRenderer::Mode handRendererMode() const { return _handRendererMode; }
+
+        /** @brief Set hand rendering path, default is instanced */
+        Configuration& setHandRendererMode(HandRenderer::Mode mode) {
+            _handRendererMode = mode;
+            return *this;
+        }
+
+        bool isSinglePassStereo() const { return _singlePassStereo; }
+
+        /**
+         * @brief Render both eyes in a single pass
+         *
+         * Both eyes share one side-by-side eye target. Disabled by default.
+         */
+        Configuration& setSinglePassStereo(bool enabled) {
+            _singlePassStereo = enabled;
+            return *this;
+        }
+
+        bool isUiCached() const { return _uiCached; }
+
+        /**
+         * @brief Draw the UI through a render-to-texture cache
+         *
+         * Enabled by default. See @ref CachedUi for details.
+         */
+        Configuration& setUiCached(bool enabled) {
+            _uiCached = enabled;
+            return *this;
+        }
+
+        Float telemetryRefreshRate() const { return _telemetryRefreshRate; }
+
+        /**
+         * @brief Set max telemetry refresh rate
+         *
+         * In Hz, default is @cpp 30.0f @ce. Set to @cpp 0.0f @ce to update
+         * the telemetry every frame. See @ref TelemetryPanel for details.
+         */
+        Configuration& setTelemetryRefreshRate(Float rate) {
+            _telemetryRefreshRate = rate;
+            return *this;
+        }
+
+        Float minResolutionScale() const { return _minResolutionScale; }
+        Float maxResolutionScale() const { return _maxResolutionScale; }
+
+        /**
+         * @brief Set eye buffer resolution scale range
+         *
+         * Default is @cpp 1.0f @ce for both, which disables the adaptive
+         * resolution. See @ref ResolutionController::setScaleRange() for
+         * details.
+         */
+        Configuration& setResolutionScaleRange(Float min, Float max) {
+            _minResolutionScale = min;
+            _maxResolutionScale = max;
+            return *this;
+        }
+
+        Float targetFrameTime() const { return _targetFrameTime; }
+
+        /**
+         * @brief Set target GPU frame time for the adaptive resolution
+         *
+         * In milliseconds, default is @cpp 11.1f @ce.
+         */
+        Configuration& setTargetFrameTime(Float milliseconds) {
+            _targetFrameTime = milliseconds;
+            return *this;
+        }
+
+        StartupCache* startupCache() const { return _startupCache; }
+
+        /**
+         * @brief Set startup cache
+         *
+         * Hand meshes and shader binaries are loaded from and saved into
+         * it. The cache is expected to stay alive until the constructor
+         * finishes, saving it is up to the caller. Default is
+         * @cpp nullptr @ce, meaning everything is generated and compiled
+         * from scratch.
+         */
+        Configuration& setStartupCache(StartupCache* cache) {
+            _startupCache = cache;
+            return *this;
+        }
+
+        JobSystem* jobSystem() const { return _jobSystem; }
+
+        /**
+         * @brief Set job system for frame preparation
+         *
+         * Expected to stay alive for the whole lifetime of the gallery.
+         * Default is @cpp nullptr @ce, meaning everything is done on the
+         * thread calling @ref Gallery::drawFrame().
+         */
+        Configuration& setJobSystem(JobSystem* jobs) {
+            _jobSystem = jobs;
+            return *this;
+        }
+
+        Int sampleCount() const { return _sampleCount; }
+
+        /**
+         * @brief Set eye buffer sample count
+         *
+         * Default is @cpp 0 @ce, rendering directly into the swap chain
+         * textures. See @ref Gallery::setSampleCount() for details.
+         */
+        Configuration& setSampleCount(Int count) {
+            _sampleCount = count;
+            return *this;
+        }
+
+        bool isPipelined() const { return _pipelined; }
+
+        /**
+         * @brief Prepare hands of the next frame while submitting
+         *
+         * Hands of the next frame are polled and their instance data built
+         * on a worker while the current frame is being submitted. The
+         * tracking data are then a bit older when the frame gets drawn.
+         * Only has an effect with a job system set. Enabled by default.
+         */
+        Configuration& setPipelined(bool enabled) {
+            _pipelined = enabled;
+            return *this;
+        }
+
+        bool isModalsLazy() const { return _modalsLazy; }
+
+        /**
+         * @brief Create modal dialogs on first use
+         *
+         * Enabled by default. If disabled, all modal dialog planes are
+         * created in the constructor and never destroyed. See
+         * @ref ModalPool for details.
+         */
+        Configuration& setModalsLazy(bool enabled) {
+            _modalsLazy = enabled;
+            return *this;
+        }
+
+        std::size_t modalPoolCapacity() const { return _modalPoolCapacity; }
+
+        /**
+         * @brief Set max count of closed modal dialogs kept alive
+         *
+         * Default is @cpp 2 @ce. Only has an effect with lazy modals. See
+         * @ref ModalPool::setCapacity() for details.
+         */
+        Configuration& setModalPoolCapacity(std::size_t capacity) {
+            _modalPoolCapacity = capacity;
+            return *this;
+        }
+
+        bool isFrameReuse() const { return _frameReuse; }
+
+        /**
+         * @brief Reuse unchanged frames
+         *
+         * Instead of rendering a frame with no hands visible, no scene
+         * changes and the head moved less than
+         * @ref setFrameReuseThreshold(), the previous one is submitted
+         * again and left to compositor reprojection. Saves GPU power when
+         * nobody interacts with the UI. Disabled by default.
+         */
+        Configuration& setFrameReuse(bool enabled) {
+            _frameReuse = enabled;
+            return *this;
+        }
+
+        UnsignedInt maxReusedFrames() const { return _maxReusedFrames; }
+
+        /**
+         * @brief Set max count of frames reused in a row
+         *
+         * Default is @cpp 8 @ce, after which a frame is rendered even if
+         * nothing changed, so reprojection artifacts don't accumulate.
+         */
+        Configuration& setMaxReusedFrames(UnsignedInt count) {
+            _maxReusedFrames = count;
+            return *this;
+        }
+
+        Rad reuseRotationThreshold() const { return _reuseRotationThreshold; }
+        Float reuseTranslationThreshold() const { return _reuseTranslationThreshold; }
+
+        /**
+         * @brief Set max head motion for frame reuse
+         *
+         * Rotation and translation of the head since the last rendered
+         * frame, translation in meters. Default is @cpp 0.5_degf @ce and
+         * @cpp 0.002f @ce.
+         */
+        Configuration& setFrameReuseThreshold(Rad rotation, Float translation) {
+            _reuseRotationThreshold = rotation;
+            _reuseTranslationThreshold = translation;
+            return *this;
+        }
+
+        bool isLateLatching() const { return _lateLatching; }
+
+        /**
+         * @brief Poll head poses again right before drawing the eyes
+         *
+         * Head poses polled for touch input at the start of the frame are
+         * replaced with fresh ones after all pose-independent work is
+         * done, shortening the time from polling to submit. Enabled by
+         * default.
+         */
+        Configuration& setLateLatching(bool enabled) {
+            _lateLatching = enabled;
+            return *this;
+        }
+
+        TelemetryExporter* telemetryExporter() const { return _telemetryExporter; }
+
+        /**
+         * @brief Set shared memory telemetry exporter
+         *
+         * A record of every frame is written into it right before submit.
+         * Expected to stay alive for the whole lifetime of the gallery.
+         * Default is @cpp nullptr @ce, meaning no telemetry is exported.
+         */
+        Configuration& setTelemetryExporter(TelemetryExporter* exporter) {
+            _telemetryExporter = exporter;
+            return *this;
+        }
+
+    private:
+        HandRenderer::Mode _handRendererMode{HandRenderer::Mode::Instanced};
+        bool _singlePassStereo{};
+        bool _uiCached{true};
+        Float _telemetryRefreshRate{30.0f};
+        Float _minResolutionScale{1.0f}, _maxResolutionScale{1.0f};
+        Float _targetFrameTime{11.1f};
+        Int _sampleCount{};
+        StartupCache* _startupCache{};
+        JobSystem* _jobSystem{};
+        TelemetryExporter* _telemetryExporter{};
+        bool _pipelined{true};
+        bool _lateLatching{true};
+        bool _modalsLazy{true};
+        bool _frameReuse{};
+        UnsignedInt _maxReusedFrames{8};
+        Rad _reuseRotationThreshold{Deg{0.5f}};
+        Float _reuseTranslationThreshold{0.002f};
+        std::size_t _modalPoolCapacity{2};
+};
+
+}
+
+#endif
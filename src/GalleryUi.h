@@ -0,0 +1,192 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_GalleryUi_h
+#define Magnum_VrUi_GalleryUi_h
+
+#include <Corrade/Interconnect/Receiver.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Text/Alignment.h>
+#include <Magnum/Ui/Anchor.h>
+#include <Magnum/Ui/Button.h>
+#include <Magnum/Ui/Input.h>
+#include <Magnum/Ui/Label.h>
+#include <Magnum/Ui/Modal.h>
+#include <Magnum/Ui/Plane.h>
+#include <Magnum/Ui/UserInterface.h>
+
+#include "UiPanel.h"
+
+namespace Magnum {
+
+constexpr const Float WidgetHeight{36.0f};
+constexpr const Float LabelHeight{24.0f};
+constexpr const Vector2 ButtonSize{96.0f, WidgetHeight};
+constexpr const Vector2 LabelSize{72.0f, LabelHeight};
+
+/* Indices of widgets in the base plane, in the same order as in
+   BaseUiPlane::widgets() */
+namespace BaseUi { enum: Int {
+    ButtonDefault, ButtonPrimary, ButtonDanger, ButtonSuccess, ButtonWarning, ButtonFlat,
+    InputDefault, InputDanger, InputSuccess, InputWarning, InputFlat,
+    ModalDefault, ModalDanger, ModalSuccess, ModalWarning, ModalInfo,
+    ButtonDefaultDisabled, ButtonPrimaryDisabled, ButtonDangerDisabled, ButtonSuccessDisabled, ButtonWarningDisabled, ButtonFlatDisabled,
+    LabelDefault, LabelPrimary, LabelDanger, LabelSuccess, LabelWarning, LabelInfo, LabelDim,
+    LabelDefaultDisabled, LabelPrimaryDisabled, LabelDangerDisabled, LabelSuccessDisabled, LabelWarningDisabled, LabelInfoDisabled, LabelDimDisabled,
+    InputDefaultDisabled, InputDangerDisabled, InputSuccessDisabled, InputWarningDisabled, InputFlatDisabled,
+    ButtonsHeading, LabelsHeading, InputsHeading, ModalsHeading
+}; }
+
+struct BaseUiPlane: UiPanel {
+    static Containers::ArrayView<const WidgetDescription> widgets() {
+        using namespace BaseUi;
+        constexpr Ui::Snaps Right = Ui::Snap::Right;
+        constexpr Ui::Snaps Bottom = Ui::Snap::Bottom;
+        constexpr Ui::Snaps TopLeft = Ui::Snap::Top|Ui::Snap::Left;
+        constexpr Ui::Snaps Heading = Ui::Snap::Top|Ui::Snap::Left|Ui::Snap::InsideX;
+        constexpr Text::Alignment Center = Text::Alignment::LineCenterIntegral;
+        const Range2D buttonRect{{}, ButtonSize};
+        const Range2D labelRect{{}, LabelSize};
+
+        static const WidgetDescription widgets[]{
+            UiPanel::button(TopLeft, RelativeToPlane, Range2D::fromSize(Vector2::yAxis(-36.0f), ButtonSize), "Default", Ui::Style::Default),
+            UiPanel::button(Right, ButtonDefault, buttonRect, "Primary", Ui::Style::Primary),
+            UiPanel::button(Right, ButtonPrimary, buttonRect, "Danger", Ui::Style::Danger),
+            UiPanel::button(Right, ButtonDanger, buttonRect, "Success", Ui::Style::Success),
+            UiPanel::button(Right, ButtonSuccess, buttonRect, "Warning", Ui::Style::Warning),
+            UiPanel::button(Right, ButtonWarning, {{}, {60.0f, WidgetHeight}}, "Flat", Ui::Style::Flat),
+
+            UiPanel::input(TopLeft, RelativeToPlane, Range2D::fromSize(Vector2::yAxis(-282.0f), ButtonSize), "Default", 8, Ui::Style::Default),
+            UiPanel::input(Right, InputDefault, buttonRect, "Danger", 8, Ui::Style::Danger),
+            UiPanel::input(Right, InputDanger, buttonRect, "Success", 8, Ui::Style::Success),
+            UiPanel::input(Right, InputSuccess, buttonRect, "Warning", 8, Ui::Style::Warning),
+            UiPanel::input(Right, InputWarning, buttonRect, "Flat", 8, Ui::Style::Flat),
+
+            UiPanel::button(TopLeft, RelativeToPlane, Range2D::fromSize(Vector2::yAxis(-414.0f), ButtonSize), "Default »"),
+            UiPanel::button(Right, ModalDefault, buttonRect, "Danger »"),
+            UiPanel::button(Right, ModalDanger, buttonRect, "Success »"),
+            UiPanel::button(Right, ModalSuccess, buttonRect, "Warning »"),
+            UiPanel::button(Right, ModalWarning, buttonRect, "Info »"),
+
+            UiPanel::button(Bottom, ButtonDefault, buttonRect, "Default", Ui::Style::Default, true),
+            UiPanel::button(Bottom, ButtonPrimary, buttonRect, "Primary", Ui::Style::Primary, true),
+            UiPanel::button(Bottom, ButtonDanger, buttonRect, "Danger", Ui::Style::Danger, true),
+            UiPanel::button(Bottom, ButtonSuccess, buttonRect, "Success", Ui::Style::Success, true),
+            UiPanel::button(Bottom, ButtonWarning, buttonRect, "Warning", Ui::Style::Warning, true),
+            UiPanel::button(Bottom, ButtonFlat, buttonRect, "Flat", Ui::Style::Flat, true),
+
+            UiPanel::label(TopLeft, RelativeToPlane, Range2D::fromSize(Vector2::yAxis(-172.0f), LabelSize), "Default", Center, Ui::Style::Default),
+            UiPanel::label(Right, LabelDefault, labelRect, "Primary", Center, Ui::Style::Primary),
+            UiPanel::label(Right, LabelPrimary, labelRect, "Danger", Center, Ui::Style::Danger),
+            UiPanel::label(Right, LabelDanger, labelRect, "Success", Center, Ui::Style::Success),
+            UiPanel::label(Right, LabelSuccess, labelRect, "Warning", Center, Ui::Style::Warning),
+            UiPanel::label(Right, LabelWarning, labelRect, "Info", Center, Ui::Style::Info),
+            UiPanel::label(Right, LabelInfo, labelRect, "Dim", Center, Ui::Style::Dim),
+
+            UiPanel::label(Bottom, LabelDefault, labelRect, "Default", Center, Ui::Style::Default, true),
+            UiPanel::label(Bottom, LabelPrimary, labelRect, "Primary", Center, Ui::Style::Primary, true),
+            UiPanel::label(Bottom, LabelDanger, labelRect, "Danger", Center, Ui::Style::Danger, true),
+            UiPanel::label(Bottom, LabelSuccess, labelRect, "Success", Center, Ui::Style::Success, true),
+            UiPanel::label(Bottom, LabelWarning, labelRect, "Warning", Center, Ui::Style::Warning, true),
+            UiPanel::label(Bottom, LabelInfo, labelRect, "Info", Center, Ui::Style::Info, true),
+            UiPanel::label(Bottom, LabelDim, labelRect, "Dim", Center, Ui::Style::Dim, true),
+
+            UiPanel::input(Bottom, InputDefault, buttonRect, "Default", 32, Ui::Style::Default, true),
+            UiPanel::input(Bottom, InputDanger, buttonRect, "Danger", 32, Ui::Style::Danger, true),
+            UiPanel::input(Bottom, InputSuccess, buttonRect, "Success", 32, Ui::Style::Success, true),
+            UiPanel::input(Bottom, InputWarning, buttonRect, "Warning", 32, Ui::Style::Warning, true),
+            UiPanel::input(Bottom, InputFlat, buttonRect, "Flat", 32, Ui::Style::Flat, true),
+
+            UiPanel::label(Heading, ButtonDefault, labelRect, "Buttons", Text::Alignment::LineLeft, Ui::Style::Dim),
+            UiPanel::label(Heading, LabelDefault, labelRect, "Labels", Text::Alignment::LineLeft, Ui::Style::Dim),
+            UiPanel::label(Heading, InputDefault, labelRect, "Inputs", Text::Alignment::LineLeft, Ui::Style::Dim),
+            UiPanel::label(Heading, ModalDefault, labelRect, "Modals", Text::Alignment::LineLeft, Ui::Style::Dim)
+        };
+
+        return widgets;
+    }
+
+    explicit BaseUiPlane(Ui::UserInterface& ui):
+        UiPanel{ui, Ui::Snap::Top|Ui::Snap::Bottom|Ui::Snap::Left|Ui::Snap::Right, widgets()},
+        buttonDefault(button(BaseUi::ButtonDefault)),
+        buttonPrimary(button(BaseUi::ButtonPrimary)),
+        buttonDanger(button(BaseUi::ButtonDanger)),
+        buttonSuccess(button(BaseUi::ButtonSuccess)),
+        buttonWarning(button(BaseUi::ButtonWarning)),
+        buttonFlat(button(BaseUi::ButtonFlat)),
+        inputDefault(input(BaseUi::InputDefault)),
+        inputDanger(input(BaseUi::InputDanger)),
+        inputSuccess(input(BaseUi::InputSuccess)),
+        inputWarning(input(BaseUi::InputWarning)),
+        inputFlat(input(BaseUi::InputFlat)),
+        inputDefaultDisabled(input(BaseUi::InputDefaultDisabled)),
+        modalDefault(button(BaseUi::ModalDefault)),
+        modalDanger(button(BaseUi::ModalDanger)),
+        modalSuccess(button(BaseUi::ModalSuccess)),
+        modalWarning(button(BaseUi::ModalWarning)),
+        modalInfo(button(BaseUi::ModalInfo)) {}
+
+    Ui::Button &buttonDefault,
+        &buttonPrimary,
+        &buttonDanger,
+        &buttonSuccess,
+        &buttonWarning,
+        &buttonFlat;
+
+    Ui::Input &inputDefault,
+        &inputDanger,
+        &inputSuccess,
+        &inputWarning,
+        &inputFlat,
+        &inputDefaultDisabled;
+
+    Ui::Button &modalDefault,
+        &modalDanger,
+        &modalSuccess,
+        &modalWarning,
+        &modalInfo;
+};
+
+struct ModalUiPlane: Ui::Plane, Interconnect::Receiver {
+    explicit ModalUiPlane(Ui::UserInterface& ui, Ui::Style style):
+        Ui::Plane{ui, {{}, {320.0f, 240.0f}}, 2, 3, 128},
+        message{*this, {{}, Range2D::fromSize(Vector2::yAxis(20.0f), {})},
+            "This is a modal dialog.", Text::Alignment::LineCenterIntegral, style},
+        close{*this, {Ui::Snap::Bottom|Ui::Snap::Right, ButtonSize},
+            "Close", style == Ui::Style::Info ? Ui::Style::Default : style}
+    {
+        Ui::Modal{*this, Ui::Snap::Top|Ui::Snap::Bottom|Ui::Snap::Left|Ui::Snap::Right|Ui::Snap::NoSpaceX|Ui::Snap::NoSpaceY, style};
+
+        Ui::Label{*this, {Ui::Snap::Left|Ui::Snap::Top, Range2D::fromSize(Vector2::xAxis(10.0f), {{}, WidgetHeight})},
+            "Modal", Text::Alignment::LineLeft, style};
+    }
+
+    Ui::Label message;
+    Ui::Button close;
+};
+
+}
+
+#endif
@@ -0,0 +1,166 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "HandCapture.h"
+
+#include <cstring>
+#include <Corrade/Utility/Assert.h>
+
+namespace Magnum { namespace HandCapture {
+
+namespace {
+
+constexpr const char Magic[8]{'V', 'R', 'U', 'I', 'H', 'A', 'N', 'D'};
+
+struct Writer {
+    void write(const void* data, std::size_t size) {
+        std::memcpy(out, data, size);
+        out += size;
+    }
+
+    void write(const Vector3& vector) { write(vector.data(), sizeof(Vector3)); }
+    void write(Float value) { write(&value, sizeof(Float)); }
+    void write(UnsignedByte value) { *out++ = value; }
+
+    char* out;
+};
+
+struct Reader {
+    Vector3 readVector3() {
+        Vector3 out;
+        std::memcpy(out.data(), in, sizeof(Vector3));
+        in += sizeof(Vector3);
+        return out;
+    }
+
+    Float readFloat() {
+        Float out;
+        std::memcpy(&out, in, sizeof(Float));
+        in += sizeof(Float);
+        return out;
+    }
+
+    const char* in;
+};
+
+}
+
+FileHeader fileHeader() {
+    FileHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    return header;
+}
+
+bool checkFileHeader(Containers::ArrayView<const char> data) {
+    if(data.size() < sizeof(FileHeader)) return false;
+
+    FileHeader header;
+    std::memcpy(&header, data.data(), sizeof(FileHeader));
+    return std::memcmp(header.magic, Magic, sizeof(Magic)) == 0 && header.version == Version;
+}
+
+std::size_t serialize(const HandSnapshot& hands, Containers::ArrayView<char> out) {
+    CORRADE_ASSERT(out.size() >= MaxFrameSize,
+        "HandCapture::serialize(): output buffer too small", 0);
+
+    FrameHeader header{};
+    header.timestamp = hands.timestamp();
+    header.size = frameSize(hands.handCount(), hands.boneCount(), hands.jointCount());
+    header.handCount = hands.handCount();
+    header.boneCount = hands.boneCount();
+    header.jointCount = hands.jointCount();
+    for(UnsignedInt i = 0; i != hands.handCount(); ++i)
+        if(hands.isRight(i)) header.rightHandMask |= 1 << i;
+
+    Writer writer{out.data()};
+    writer.write(&header, sizeof(FrameHeader));
+    for(UnsignedInt i = 0; i != hands.handCount(); ++i)
+        for(UnsignedInt finger = 0; finger != HandSnapshot::FingerCount; ++finger)
+            writer.write(hands.fingertip(i, finger));
+    for(UnsignedInt i = 0; i != hands.boneCount(); ++i) {
+        writer.write(hands.boneCenter(i));
+        writer.write(hands.boneXBasis(i));
+        writer.write(hands.boneYBasis(i));
+        writer.write(hands.boneZBasis(i));
+        writer.write(hands.boneLength(i));
+    }
+    for(UnsignedInt i = 0; i != hands.jointCount(); ++i)
+        writer.write(hands.jointPosition(i));
+    for(UnsignedInt i = 0; i != hands.boneCount(); ++i)
+        writer.write(UnsignedByte(hands.boneHand(i)));
+    for(UnsignedInt i = 0; i != hands.jointCount(); ++i)
+        writer.write(UnsignedByte(hands.jointHand(i)));
+
+    /* Zero the padding so captures are reproducible */
+    std::memset(writer.out, 0, out.data() + header.size - writer.out);
+
+    return header.size;
+}
+
+std::size_t deserialize(Containers::ArrayView<const char> data, HandSnapshot& hands) {
+    if(data.size() < sizeof(FrameHeader)) return 0;
+
+    FrameHeader header;
+    std::memcpy(&header, data.data(), sizeof(FrameHeader));
+    if(header.handCount > HandSnapshot::MaxHands ||
+       header.boneCount > HandSnapshot::MaxBones ||
+       header.jointCount > HandSnapshot::MaxJoints ||
+       header.size != frameSize(header.handCount, header.boneCount, header.jointCount) ||
+       header.size > data.size())
+        return 0;
+
+    /* Hand indices of bones and joints are after all the floats */
+    const char* const boneHands = data.data() + sizeof(FrameHeader) +
+        sizeof(Float)*(header.handCount*HandSnapshot::FingerCount*3 + header.boneCount*13 + header.jointCount*3);
+    const char* const jointHands = boneHands + header.boneCount;
+    for(UnsignedInt i = 0; i != header.boneCount; ++i)
+        if(UnsignedByte(boneHands[i]) >= header.handCount) return 0;
+    for(UnsignedInt i = 0; i != header.jointCount; ++i)
+        if(UnsignedByte(jointHands[i]) >= header.handCount) return 0;
+
+    hands.clear();
+    hands.setTimestamp(header.timestamp);
+
+    Reader reader{data.data() + sizeof(FrameHeader)};
+    for(UnsignedInt i = 0; i != header.handCount; ++i) {
+        hands.addHand(header.rightHandMask & (1 << i));
+        for(UnsignedInt finger = 0; finger != HandSnapshot::FingerCount; ++finger)
+            hands.setFingertip(i, finger, reader.readVector3());
+    }
+    for(UnsignedInt i = 0; i != header.boneCount; ++i) {
+        const Vector3 center = reader.readVector3();
+        const Vector3 xBasis = reader.readVector3();
+        const Vector3 yBasis = reader.readVector3();
+        const Vector3 zBasis = reader.readVector3();
+        const Float length = reader.readFloat();
+        hands.addBone(UnsignedByte(boneHands[i]), center, xBasis, yBasis, zBasis, length);
+    }
+    for(UnsignedInt i = 0; i != header.jointCount; ++i)
+        hands.addJoint(UnsignedByte(jointHands[i]), reader.readVector3());
+
+    return header.size;
+}
+
+}}
@@ -0,0 +1,110 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_HandCapture_h
+#define Magnum_VrUi_HandCapture_h
+
+#include <cstddef>
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Magnum.h>
+
+#include "HandSnapshot.h"
+
+namespace Magnum { namespace HandCapture {
+
+/**
+@brief Hand capture file format
+
+A capture file starts with a @ref FileHeader, followed by frames recorded by
+@ref HandRecorder. Each frame is a @ref FrameHeader followed by:
+
+-   3 floats for each finger tip position of every hand
+-   13 floats for each bone --- center, X, Y and Z basis and length
+-   3 floats for each joint position
+-   one byte with hand index for each bone, then for each joint
+-   zero padding to a multiple of 8 bytes
+
+All values are in native byte order, frames can be read directly from a
+memory-mapped file without any allocation.
+*/
+struct FileHeader {
+    char magic[8];
+    UnsignedInt version;
+    UnsignedInt reserved;
+};
+
+/** @brief Frame header */
+struct FrameHeader {
+    UnsignedLong timestamp;
+    /** Size of the whole frame including the header, in bytes */
+    UnsignedInt size;
+    UnsignedByte handCount;
+    UnsignedByte boneCount;
+    UnsignedByte jointCount;
+    /** Bit @cpp i @ce is set if hand @cpp i @ce is a right hand */
+    UnsignedByte rightHandMask;
+};
+
+static_assert(sizeof(FileHeader) == 16 && sizeof(FrameHeader) == 16, "unexpected padding in capture headers");
+
+enum: UnsignedInt { Version = 1 };
+
+/** @brief Size of a frame with given hand, bone and joint count */
+constexpr std::size_t frameSize(UnsignedInt handCount, UnsignedInt boneCount, UnsignedInt jointCount) {
+    return (sizeof(FrameHeader) +
+        sizeof(Float)*(handCount*HandSnapshot::FingerCount*3 + boneCount*13 + jointCount*3) +
+        boneCount + jointCount + 7) & ~std::size_t(7);
+}
+
+enum: std::size_t {
+    /** Size of the largest possible frame */
+    MaxFrameSize = frameSize(HandSnapshot::MaxHands, HandSnapshot::MaxBones, HandSnapshot::MaxJoints)
+};
+
+/** @brief Fill a file header */
+FileHeader fileHeader();
+
+/** @brief Check that the data start with a valid file header */
+bool checkFileHeader(Containers::ArrayView<const char> data);
+
+/**
+ * @brief Serialize a frame
+ *
+ * Expects that @p out is at least @ref MaxFrameSize bytes. Returns count of
+ * bytes written.
+ */
+std::size_t serialize(const HandSnapshot& hands, Containers::ArrayView<char> out);
+
+/**
+ * @brief Deserialize a frame
+ *
+ * Reads the frame at the start of @p data into @p hands. Returns size of the
+ * frame or @cpp 0 @ce if the data are truncated or invalid. Doesn't compute
+ * transformations.
+ */
+std::size_t deserialize(Containers::ArrayView<const char> data, HandSnapshot& hands);
+
+}}
+
+#endif
@@ -0,0 +1,57 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "HandRecorder.h"
+
+#include <Corrade/Utility/Debug.h>
+
+namespace Magnum {
+
+HandRecorder::HandRecorder(std::unique_ptr<AbstractHandSource> source, const std::string& filename): _source{std::move(source)}, _file{filename, std::ios::binary|std::ios::trunc} {
+    if(!_file.good()) {
+        Error() << "HandRecorder: can't open" << filename << "for writing";
+        return;
+    }
+
+    const HandCapture::FileHeader header = HandCapture::fileHeader();
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+bool HandRecorder::doIsConnected() const {
+    return _source->isConnected();
+}
+
+bool HandRecorder::doFrame(HandSnapshot& hands) {
+    if(!_source->frame(hands)) return false;
+
+    if(_file.good()) {
+        const std::size_t size = HandCapture::serialize(hands, _buffer);
+        _file.write(_buffer, size);
+        ++_recordedFrameCount;
+    }
+
+    return true;
+}
+
+}
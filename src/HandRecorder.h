@@ -0,0 +1,72 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_HandRecorder_h
+#define Magnum_VrUi_HandRecorder_h
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "AbstractHandSource.h"
+#include "HandCapture.h"
+
+namespace Magnum {
+
+/**
+@brief Hand source recorder
+
+Passes frames of another hand source through and appends each of them to a
+capture file in the @ref HandCapture format, which can be then played back
+with @ref HandReplay. Frames are serialized into a preallocated buffer, so
+recording doesn't allocate.
+*/
+class HandRecorder: public AbstractHandSource {
+    public:
+        /**
+         * @brief Constructor
+         * @param source    Source to record
+         * @param filename  Capture file to write, overwritten if it exists
+         */
+        explicit HandRecorder(std::unique_ptr<AbstractHandSource> source, const std::string& filename);
+
+        /** @brief Whether the capture file was successfully opened */
+        bool isOpen() const { return _file.good(); }
+
+        /** @brief Count of frames recorded so far */
+        UnsignedInt recordedFrameCount() const { return _recordedFrameCount; }
+
+    private:
+        bool doIsConnected() const override;
+        bool doFrame(HandSnapshot& hands) override;
+
+        std::unique_ptr<AbstractHandSource> _source;
+        std::ofstream _file;
+        UnsignedInt _recordedFrameCount{};
+        char _buffer[HandCapture::MaxFrameSize];
+};
+
+}
+
+#endif
@@ -0,0 +1,409 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "HandRenderer.h"
+
+#include <cstring>
+#include <tuple>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Mesh.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/MeshTools/CompressIndices.h>
+#include <Magnum/MeshTools/Interleave.h>
+#include <Magnum/Primitives/Cylinder.h>
+#include <Magnum/Primitives/UVSphere.h>
+#include <Magnum/Trade/MeshData3D.h>
+
+#include "StartupCache.h"
+
+namespace Magnum {
+
+namespace {
+
+/* Size of the cylinders and spheres, in millimeters */
+constexpr const Float BoneRadius{6.0f};
+constexpr const Float JointRadius{8.0f};
+
+struct MeshLayout {
+    MeshPrimitive primitive;
+    Int count;
+    MeshIndexType indexType;
+    UnsignedInt indexStart, indexEnd;
+};
+
+/* Cached mesh blob is this header followed by the vertex and index data */
+struct MeshBlobHeader {
+    MeshLayout layout;
+    UnsignedInt vertexSize, indexSize;
+};
+
+MeshLayout uploadMesh(StartupCache* const cache, const std::string& name, Trade::MeshData3D(*const generate)(), GL::Buffer& vertices, GL::Buffer& indices) {
+    vertices = GL::Buffer{};
+    indices = GL::Buffer{};
+
+    /* Upload straight from the mapped cache file if possible */
+    const Containers::ArrayView<const char> blob = cache ? cache->get(name) : nullptr;
+    MeshBlobHeader header;
+    if(blob.size() >= sizeof(MeshBlobHeader)) {
+        std::memcpy(&header, blob.data(), sizeof(MeshBlobHeader));
+        if(blob.size() == sizeof(MeshBlobHeader) + header.vertexSize + header.indexSize) {
+            vertices.setData(blob.slice(sizeof(MeshBlobHeader), sizeof(MeshBlobHeader) + header.vertexSize), GL::BufferUsage::StaticDraw);
+            indices.setData(blob.suffix(sizeof(MeshBlobHeader) + header.vertexSize), GL::BufferUsage::StaticDraw);
+            return header.layout;
+        }
+    }
+
+    const Trade::MeshData3D data = generate();
+    const Containers::Array<char> vertexData = MeshTools::interleave(data.positions(0), data.normals(0));
+    vertices.setData(vertexData, GL::BufferUsage::StaticDraw);
+
+    MeshLayout& layout = header.layout;
+    layout.primitive = data.primitive();
+    layout.count = data.indices().size();
+
+    Containers::Array<char> indexData;
+    std::tie(indexData, layout.indexType, layout.indexStart, layout.indexEnd) = MeshTools::compressIndices(data.indices());
+    indices.setData(indexData, GL::BufferUsage::StaticDraw);
+
+    if(cache) {
+        header.vertexSize = vertexData.size();
+        header.indexSize = indexData.size();
+        Containers::Array<char> out{Containers::NoInit, sizeof(MeshBlobHeader) + vertexData.size() + indexData.size()};
+        std::memcpy(out.data(), &header, sizeof(MeshBlobHeader));
+        std::memcpy(out + sizeof(MeshBlobHeader), vertexData.data(), vertexData.size());
+        std::memcpy(out + sizeof(MeshBlobHeader) + vertexData.size(), indexData.data(), indexData.size());
+        cache->set(name, out);
+    }
+
+    return layout;
+}
+
+GL::Mesh setupMesh(const MeshLayout& layout, GL::Buffer& vertices, GL::Buffer& indices) {
+    GL::Mesh mesh{layout.primitive};
+    mesh.setCount(layout.count)
+        .addVertexBuffer(vertices, 0, Shaders::Phong::Position{}, Shaders::Phong::Normal{})
+        .setIndexBuffer(indices, 0, layout.indexType, layout.indexStart, layout.indexEnd);
+    return mesh;
+}
+
+}
+
+HandRenderer::HandRenderer(const Mode mode, StartupCache* const cache): _mode{mode} {
+    static_assert(sizeof(Instance) == 112, "unexpected padding in instance data");
+    static_assert(sizeof(Capsule) == 40, "unexpected padding in capsule data");
+
+    _cylinderInstances.reserve(HandSnapshot::MaxBones);
+    _sphereInstances.reserve(HandSnapshot::MaxJoints);
+    _capsuleInstances.reserve(HandSnapshot::MaxBones + HandSnapshot::MaxJoints);
+
+    /* Blob names contain the parameters so changing them doesn't pick up
+       a stale mesh */
+    const MeshLayout cylinder = uploadMesh(cache, "HandRenderer.cylinderSolid(2, 16, 0.5)",
+        [] { return Primitives::cylinderSolid(2, 16, 0.5f); }, _buffers[0], _buffers[1]);
+    const MeshLayout sphere = uploadMesh(cache, "HandRenderer.uvSphereSolid(16, 16)",
+        [] { return Primitives::uvSphereSolid(16, 16); }, _buffers[2], _buffers[3]);
+    _cylinder = setupMesh(cylinder, _buffers[0], _buffers[1]);
+    _sphere = setupMesh(sphere, _buffers[2], _buffers[3]);
+
+    /* Instance data of all meshes are streamed through one buffer if the
+       draws can pick them by base instance. The capacity is enough for the
+       largest possible snapshot, plus alignment of each upload to the
+       instance stride. */
+    _streamed = GL::Context::current().isExtensionSupported<GL::Extensions::ARB::base_instance>();
+    if(_streamed) _stream = StreamingBuffer{
+        (HandSnapshot::MaxBones + HandSnapshot::MaxJoints + 2)*sizeof(Instance) +
+        (HandSnapshot::MaxBones + HandSnapshot::MaxJoints + 1)*sizeof(Capsule)};
+    _buffers[4] = GL::Buffer{};
+    _buffers[5] = GL::Buffer{};
+    _buffers[7] = GL::Buffer{};
+    GL::Buffer& cylinderInstances = _streamed ? _stream.buffer() : _buffers[4];
+    GL::Buffer& sphereInstances = _streamed ? _stream.buffer() : _buffers[5];
+    GL::Buffer& capsuleInstances = _streamed ? _stream.buffer() : _buffers[7];
+
+    /* The instanced meshes share vertex and index buffers with the ones
+       above and add the per-instance attributes */
+    _cylinderInstanced = setupMesh(cylinder, _buffers[0], _buffers[1]);
+    _cylinderInstanced.addVertexBufferInstanced(cylinderInstances, 1, 0,
+        InstancedPhong::TransformationMatrix{},
+        InstancedPhong::NormalMatrix{},
+        InstancedPhong::Color{});
+    _sphereInstanced = setupMesh(sphere, _buffers[2], _buffers[3]);
+    _sphereInstanced.addVertexBufferInstanced(sphereInstances, 1, 0,
+        InstancedPhong::TransformationMatrix{},
+        InstancedPhong::NormalMatrix{},
+        InstancedPhong::Color{});
+
+    /* Same for single-pass stereo, just with each instance drawn twice */
+    _cylinderStereo = setupMesh(cylinder, _buffers[0], _buffers[1]);
+    _cylinderStereo.addVertexBufferInstanced(cylinderInstances, 2, 0,
+        InstancedPhong::TransformationMatrix{},
+        InstancedPhong::NormalMatrix{},
+        InstancedPhong::Color{});
+    _sphereStereo = setupMesh(sphere, _buffers[2], _buffers[3]);
+    _sphereStereo.addVertexBufferInstanced(sphereInstances, 2, 0,
+        InstancedPhong::TransformationMatrix{},
+        InstancedPhong::NormalMatrix{},
+        InstancedPhong::Color{});
+
+    /* Impostors are a single quad per bone, expanded to cover the capsule
+       in the shader */
+    constexpr const Vector2 corners[]{
+        {-1.0f, -1.0f}, {1.0f, -1.0f}, {-1.0f, 1.0f}, {1.0f, 1.0f}};
+    _buffers[6] = GL::Buffer{};
+    _buffers[6].setData(corners, GL::BufferUsage::StaticDraw);
+    _impostor = GL::Mesh{MeshPrimitive::TriangleStrip};
+    _impostor.setCount(4)
+        .addVertexBuffer(_buffers[6], 0, CapsuleImpostor::Corner{})
+        .addVertexBufferInstanced(capsuleInstances, 1, 0,
+            CapsuleImpostor::PointA{},
+            CapsuleImpostor::PointB{},
+            CapsuleImpostor::Radius{},
+            CapsuleImpostor::Color{});
+    _impostorStereo = GL::Mesh{MeshPrimitive::TriangleStrip};
+    _impostorStereo.setCount(4)
+        .addVertexBuffer(_buffers[6], 0, CapsuleImpostor::Corner{})
+        .addVertexBufferInstanced(capsuleInstances, 2, 0,
+            CapsuleImpostor::PointA{},
+            CapsuleImpostor::PointB{},
+            CapsuleImpostor::Radius{},
+            CapsuleImpostor::Color{});
+
+    _shader = Shaders::Phong{};
+    _shader.setSpecularColor(Color3(1.0f))
+           .setShininess(20)
+           .setLightPosition({0.0f, 5.0f, 5.0f});
+
+    _instancedShader = InstancedPhong{{}, cache};
+    _instancedShader.setSpecularColor(Color3(1.0f))
+                    .setShininess(20)
+                    .setLightPosition({0.0f, 5.0f, 5.0f});
+
+    _stereoShader = InstancedPhong{InstancedPhong::Flag::Stereo, cache};
+    _stereoShader.setSpecularColor(Color3(1.0f))
+                 .setShininess(20)
+                 .setLightPosition({0.0f, 5.0f, 5.0f});
+
+    _impostorShader = CapsuleImpostor{{}, cache};
+    _impostorShader.setSpecularColor(Color3(1.0f))
+                   .setShininess(20)
+                   .setLightPosition({0.0f, 5.0f, 5.0f});
+
+    _impostorStereoShader = CapsuleImpostor{CapsuleImpostor::Flag::Stereo, cache};
+    _impostorStereoShader.setSpecularColor(Color3(1.0f))
+                         .setShininess(20)
+                         .setLightPosition({0.0f, 5.0f, 5.0f});
+}
+
+HandRenderer& HandRenderer::setViewportSize(const Vector2i& size) {
+    _impostorShader.setViewportSize(Vector2{size});
+    _impostorStereoShader.setViewportSize(Vector2{size});
+    return *this;
+}
+
+HandRenderer& HandRenderer::setHands(const HandSnapshot& hands) {
+    _cylinderInstances.clear();
+    _sphereInstances.clear();
+    _capsuleInstances.clear();
+    _bounds = {};
+
+    /* The snapshot has bones with unit radius, scale them to the cylinder
+       size */
+    for(UnsignedInt i = 0; i != hands.boneCount(); ++i) {
+        const Matrix4 bone = hands.boneTransformation(i);
+        const Matrix4 transformation{bone[0]*BoneRadius, bone[1], bone[2]*BoneRadius, bone[3]};
+        _cylinderInstances.push_back({transformation, transformation.rotationScaling(), Color3{1.0f}});
+
+        /* Bone caps end up inside the joint spheres, so they're white like
+           the cylinders */
+        const Vector3 halfAxis = bone[1].xyz()*0.5f;
+        _capsuleInstances.push_back({bone[3].xyz() - halfAxis, bone[3].xyz() + halfAxis, BoneRadius, Color3{1.0f}});
+    }
+
+    /* Joints are zero-length capsules of the same radius as the spheres
+       drawn by the mesh paths, so all modes produce the same image */
+    for(UnsignedInt i = 0; i != hands.jointCount(); ++i) {
+        const Color3 color = hands.isRight(hands.jointHand(i)) ? Color3{1.0f, 0.0f, 0.0f} : Color3{0.0f, 1.0f, 1.0f};
+        const Matrix4 transformation = Matrix4::translation(hands.jointPosition(i))*Matrix4::scaling(Vector3{JointRadius});
+        _sphereInstances.push_back({transformation, transformation.rotationScaling(), color});
+        _capsuleInstances.push_back({hands.jointPosition(i), hands.jointPosition(i), JointRadius, color});
+    }
+
+    /* Padding every capsule by its radius encloses bones and joints of all
+       modes */
+    for(std::size_t i = 0; i != _capsuleInstances.size(); ++i) {
+        const Capsule& capsule = _capsuleInstances[i];
+        const Range3D bounds{Math::min(capsule.a, capsule.b) - Vector3{capsule.radius},
+                             Math::max(capsule.a, capsule.b) + Vector3{capsule.radius}};
+        _bounds = i ? Range3D{Math::min(_bounds.min(), bounds.min()), Math::max(_bounds.max(), bounds.max())} : bounds;
+    }
+
+    return *this;
+}
+
+StreamingBuffer& HandRenderer::streamingBuffer() {
+    CORRADE_ASSERT(_streamed, "HandRenderer::streamingBuffer(): instance data are not streamed", _stream);
+    return _stream;
+}
+
+HandRenderer& HandRenderer::prepare() {
+    _drawCallCount = _estimatedStateChangeCount = 0;
+    _uploadedBytes = 0;
+
+    const bool capsules = _mode == Mode::Impostor;
+    const bool instances = !capsules && (_mode == Mode::Instanced || _stereo);
+    const Containers::ArrayView<const Capsule> capsuleData{_capsuleInstances.data(), _capsuleInstances.size()};
+    const Containers::ArrayView<const Instance> cylinderData{_cylinderInstances.data(), _cylinderInstances.size()};
+    const Containers::ArrayView<const Instance> sphereData{_sphereInstances.data(), _sphereInstances.size()};
+
+    /* Offsets are aligned to the instance stride, so they're whole base
+       instances. Orphaning the buffer and each subdata upload are state
+       changes, writes to a persistent mapping are not. */
+    if(_streamed) {
+        _stream.beginFrame();
+        if(capsules) {
+            _capsuleBaseInstance = _stream.upload(capsuleData, sizeof(Capsule))/sizeof(Capsule);
+        } else if(instances) {
+            _cylinderBaseInstance = _stream.upload(cylinderData, sizeof(Instance))/sizeof(Instance);
+            _sphereBaseInstance = _stream.upload(sphereData, sizeof(Instance))/sizeof(Instance);
+        }
+        _uploadedBytes = _stream.frameUploadedBytes();
+        if(_stream.mode() == StreamingBuffer::Mode::Orphaning)
+            _estimatedStateChangeCount += 1 + (capsules ? 1 : instances ? 2 : 0);
+        return *this;
+    }
+
+    if(capsules) {
+        _buffers[7].setData(capsuleData, GL::BufferUsage::StreamDraw);
+        _uploadedBytes = capsuleData.size()*sizeof(Capsule);
+        ++_estimatedStateChangeCount;
+    } else if(instances) {
+        _buffers[4].setData(cylinderData, GL::BufferUsage::StreamDraw);
+        _buffers[5].setData(sphereData, GL::BufferUsage::StreamDraw);
+        _uploadedBytes = (cylinderData.size() + sphereData.size())*sizeof(Instance);
+        _estimatedStateChangeCount += 2;
+    }
+
+    return *this;
+}
+
+HandRenderer& HandRenderer::draw(const Matrix4& projectionMatrix) {
+    if(_mode == Mode::Impostor) {
+        _impostorShader.setProjectionMatrix(projectionMatrix);
+        if(!_capsuleInstances.empty()) {
+            _impostor.setInstanceCount(_capsuleInstances.size())
+                .setBaseInstance(_capsuleBaseInstance);
+            _impostor.draw(_impostorShader);
+            ++_drawCallCount;
+        }
+        /* Camera position is a separate uniform */
+        ++_estimatedStateChangeCount;
+    } else if(_mode == Mode::Instanced) {
+        _instancedShader.setProjectionMatrix(projectionMatrix);
+        drawInstanced();
+    } else {
+        _shader.setProjectionMatrix(projectionMatrix);
+        drawPerBone();
+    }
+    ++_estimatedStateChangeCount;
+
+    return *this;
+}
+
+HandRenderer& HandRenderer::drawStereo(const Matrix4& leftProjectionMatrix, const Matrix4& rightProjectionMatrix) {
+    CORRADE_ASSERT(_stereo, "HandRenderer::drawStereo(): stereo not enabled", *this);
+
+    if(_mode == Mode::Impostor) {
+        _impostorStereoShader.setProjectionMatrices(leftProjectionMatrix, rightProjectionMatrix);
+        _estimatedStateChangeCount += 4;
+
+        if(!_capsuleInstances.empty()) {
+            _impostorStereo.setInstanceCount(2*_capsuleInstances.size())
+                .setBaseInstance(_capsuleBaseInstance);
+            _impostorStereo.draw(_impostorStereoShader);
+            ++_drawCallCount;
+        }
+
+        return *this;
+    }
+
+    _stereoShader.setProjectionMatrices(leftProjectionMatrix, rightProjectionMatrix);
+    _estimatedStateChangeCount += 2;
+
+    if(!_cylinderInstances.empty()) {
+        _cylinderStereo.setInstanceCount(2*_cylinderInstances.size())
+            .setBaseInstance(_cylinderBaseInstance);
+        _cylinderStereo.draw(_stereoShader);
+        ++_drawCallCount;
+    }
+
+    if(!_sphereInstances.empty()) {
+        _sphereStereo.setInstanceCount(2*_sphereInstances.size())
+            .setBaseInstance(_sphereBaseInstance);
+        _sphereStereo.draw(_stereoShader);
+        ++_drawCallCount;
+    }
+
+    return *this;
+}
+
+void HandRenderer::drawPerBone() {
+    for(const Instance& instance: _cylinderInstances) {
+        _shader.setDiffuseColor(instance.color)
+               .setTransformationMatrix(instance.transformationMatrix)
+               .setNormalMatrix(instance.normalMatrix);
+        _cylinder.draw(_shader);
+        ++_drawCallCount;
+        _estimatedStateChangeCount += 3;
+    }
+
+    for(const Instance& instance: _sphereInstances) {
+        _shader.setDiffuseColor(instance.color)
+               .setTransformationMatrix(instance.transformationMatrix)
+               .setNormalMatrix(instance.normalMatrix);
+        _sphere.draw(_shader);
+        ++_drawCallCount;
+        _estimatedStateChangeCount += 3;
+    }
+}
+
+void HandRenderer::drawInstanced() {
+    if(!_cylinderInstances.empty()) {
+        _cylinderInstanced.setInstanceCount(_cylinderInstances.size())
+            .setBaseInstance(_cylinderBaseInstance);
+        _cylinderInstanced.draw(_instancedShader);
+        ++_drawCallCount;
+    }
+
+    if(!_sphereInstances.empty()) {
+        _sphereInstanced.setInstanceCount(_sphereInstances.size())
+            .setBaseInstance(_sphereBaseInstance);
+        _sphereInstanced.draw(_instancedShader);
+        ++_drawCallCount;
+    }
+}
+
+}
@@ -0,0 +1,257 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_HandRenderer_h
+#define Magnum_VrUi_HandRenderer_h
+
+#include <vector>
+#include <Corrade/Containers/StaticArray.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Shaders/Phong.h>
+
+#include "CapsuleImpostor.h"
+#include "InstancedPhong.h"
+#include "HandSnapshot.h"
+#include "StreamingBuffer.h"
+
+namespace Magnum {
+
+class StartupCache;
+
+/**
+@brief Hand renderer
+
+Renders hand bones as cylinders and joints as spheres. Bones and joints are
+taken once per frame from a @ref HandSnapshot with @ref setHands(), then
+@ref draw() can be called for each eye.
+
+In @ref Mode::PerBone every bone and joint is drawn with its own
+@ref Shaders::Phong uniform update and draw call. In @ref Mode::Instanced
+the whole frame is uploaded into one instance buffer in @ref prepare() and
+each @ref draw() is just one instanced draw for all cylinders and one for
+all spheres. In @ref Mode::Impostor every bone and joint is a ray-traced
+@ref CapsuleImpostor, joints being zero-length capsules with the same radius
+as the spheres, uploaded in @ref prepare() as well and drawn with a single
+instanced draw of a quad per bone and joint. In addition,
+@ref drawStereo() renders both eyes into a side-by-side target with the
+same draw calls.
+
+If `GL_ARB_base_instance` is supported, instance data of all meshes go
+through a single @ref StreamingBuffer and the draws pick the current
+frame's data with a base instance, otherwise each instance buffer is
+re-uploaded with @ref GL::Buffer::setData() every frame.
+*/
+class HandRenderer {
+    public:
+        enum class Mode: UnsignedByte {
+            PerBone,    /**< One draw call per bone and joint */
+            Instanced,  /**< One draw call per mesh */
+            Impostor    /**< One draw call of ray-traced capsules */
+        };
+
+        /**
+         * @brief Constructor
+         * @param mode      Rendering path
+         * @param cache     Cache to load preprocessed meshes and shader
+         *      binaries from and save them to, or @cpp nullptr @ce to
+         *      always generate and compile them
+         */
+        explicit HandRenderer(Mode mode = Mode::Instanced, StartupCache* cache = nullptr);
+
+        Mode mode() const { return _mode; }
+        HandRenderer& setMode(Mode mode) {
+            _mode = mode;
+            return *this;
+        }
+
+        /**
+         * @brief Set hands to draw
+         *
+         * Replaces bones and joints from the previous frame. Expects that
+         * @ref HandSnapshot::computeBoneTransformations() was called on the
+         * snapshot. Does no GL calls, so it can run on a different thread,
+         * as long as no other function is called at the same time.
+         */
+        HandRenderer& setHands(const HandSnapshot& hands);
+
+        std::size_t boneCount() const { return _cylinderInstances.size(); }
+        std::size_t jointCount() const { return _sphereInstances.size(); }
+
+        /**
+         * @brief Bounding box of the hands
+         *
+         * Encloses all bones and joints from the last @ref setHands(), in
+         * the hand tracking space of the snapshot. Zero if there are no
+         * joints or bones.
+         */
+        const Range3D& bounds() const { return _bounds; }
+
+        /**
+         * @brief Set viewport size of a single eye
+         *
+         * Used to pick resolution of the impostors in @ref Mode::Impostor.
+         */
+        HandRenderer& setViewportSize(const Vector2i& size);
+
+        /**
+         * @brief Enable single-pass stereo rendering
+         *
+         * Makes @ref prepare() upload instance data for @ref drawStereo()
+         * regardless of @ref mode().
+         */
+        HandRenderer& setStereo(bool stereo) {
+            _stereo = stereo;
+            return *this;
+        }
+
+        /**
+         * @brief Prepare bones and joints for drawing
+         *
+         * Uploads the instance data in @ref Mode::Instanced,
+         * @ref Mode::Impostor or with stereo enabled, does nothing
+         * otherwise, and resets @ref drawCallCount(). Call once per frame
+         * after all bones and joints were added.
+         */
+        HandRenderer& prepare();
+
+        /**
+         * @brief Draw the hands
+         * @param projectionMatrix  Transformation from hand tracking space
+         *      to clip space
+         */
+        HandRenderer& draw(const Matrix4& projectionMatrix);
+
+        /**
+         * @brief Draw the hands for both eyes in a single pass
+         * @param leftProjectionMatrix  Transformation from hand tracking
+         *      space to clip space of the left eye
+         * @param rightProjectionMatrix Transformation from hand tracking
+         *      space to clip space of the right eye
+         *
+         * Expects that the bound framebuffer viewport covers both eyes of
+         * the same size side by side and that @cpp GL_CLIP_DISTANCE0 @ce is
+         * enabled, which is better disabled again right after, as other
+         * shaders don't write the clip distance. In @ref Mode::Impostor the impostors are drawn, otherwise
+         * the instanced path is always used, so @ref prepare() uploads the
+         * instance data in this case too.
+         */
+        HandRenderer& drawStereo(const Matrix4& leftProjectionMatrix, const Matrix4& rightProjectionMatrix);
+
+        /** @brief Count of draw calls issued since last @ref prepare() */
+        UnsignedInt drawCallCount() const { return _drawCallCount; }
+
+        /** @brief Whether instance data go through a @ref StreamingBuffer */
+        bool isStreamed() const { return _streamed; }
+
+        /**
+         * @brief Instance data streaming buffer
+         *
+         * Expects that instance data are streamed.
+         */
+        StreamingBuffer& streamingBuffer();
+
+        /** @brief Bytes of instance data uploaded in last @ref prepare() */
+        std::size_t uploadedBytes() const { return _uploadedBytes; }
+
+        /**
+         * @brief Fence waits in last @ref prepare()
+         *
+         * See @ref StreamingBuffer::frameFenceWaits(). Always @cpp 0 @ce if
+         * instance data are not streamed.
+         */
+        UnsignedInt fenceWaitCount() const {
+            return _streamed ? _stream.frameFenceWaits() : 0;
+        }
+
+        /**
+         * @brief Estimated count of state changes since last @ref prepare()
+         *
+         * Shader uniform updates and instance buffer uploads, counted by
+         * hand next to the calls and not measured on the GL side.
+         */
+        UnsignedInt estimatedStateChangeCount() const { return _estimatedStateChangeCount; }
+
+    private:
+        struct Instance {
+            Matrix4 transformationMatrix;
+            Matrix3x3 normalMatrix;
+            Color3 color;
+        };
+
+        struct Capsule {
+            Vector3 a, b;
+            Float radius;
+            Color3 color;
+        };
+
+        void drawPerBone();
+        void drawInstanced();
+
+        Mode _mode;
+        bool _stereo{};
+        UnsignedInt _drawCallCount{}, _estimatedStateChangeCount{};
+        std::size_t _uploadedBytes{};
+        Range3D _bounds;
+
+        std::vector<Instance> _cylinderInstances;
+        std::vector<Instance> _sphereInstances;
+        std::vector<Capsule> _capsuleInstances;
+
+        /* Vertex and index buffers of the cylinder and sphere, followed by
+           instance buffers of both, impostor quad vertices and capsule
+           instances */
+        Containers::StaticArray<8, GL::Buffer> _buffers{Containers::DirectInit, NoCreate};
+
+        /* If streamed, all instance data are in a single buffer instead of
+           the instance buffers above and the draws pick them with these
+           base instances */
+        bool _streamed{};
+        StreamingBuffer _stream{NoCreate};
+        UnsignedInt _cylinderBaseInstance{},
+            _sphereBaseInstance{},
+            _capsuleBaseInstance{};
+        GL::Mesh _cylinder{NoCreate},
+            _sphere{NoCreate},
+            _cylinderInstanced{NoCreate},
+            _sphereInstanced{NoCreate},
+            _cylinderStereo{NoCreate},
+            _sphereStereo{NoCreate},
+            _impostor{NoCreate},
+            _impostorStereo{NoCreate};
+
+        Shaders::Phong _shader{NoCreate};
+        InstancedPhong _instancedShader{NoCreate},
+            _stereoShader{NoCreate};
+        CapsuleImpostor _impostorShader{NoCreate},
+            _impostorStereoShader{NoCreate};
+};
+
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "HandReplay.h"
+
+#include <cstring>
+#include <Corrade/Utility/Debug.h>
+
+#include "HandCapture.h"
+#include "HandSnapshot.h"
+
+namespace Magnum {
+
+HandReplay::HandReplay(const std::string& filename) {
+    if(!Utility::Directory::fileExists(filename)) {
+        Error() << "HandReplay: file" << filename << "doesn't exist";
+        return;
+    }
+
+    Containers::Array<const char, Utility::Directory::MapDeleter> data = Utility::Directory::mapRead(filename);
+    if(!HandCapture::checkFileHeader(data)) {
+        Error() << "HandReplay:" << filename << "is not a valid hand capture";
+        return;
+    }
+
+    /* Validate all frames upfront so playback doesn't need to deal with
+       corrupted data, a truncated last frame is ignored. Frames are
+       validated into a scratch snapshot so nothing has to be allocated. */
+    HandSnapshot scratch;
+    std::size_t offset = sizeof(HandCapture::FileHeader);
+    UnsignedLong lastTimestamp{};
+    while(const std::size_t size = HandCapture::deserialize(data.suffix(offset), scratch)) {
+        if(!_frameCount) _firstTimestamp = scratch.timestamp();
+        else if(scratch.timestamp() < lastTimestamp) {
+            Warning() << "HandReplay: timestamps in" << filename << "go back in time at frame" << _frameCount << Debug::nospace << ", ignoring the rest";
+            break;
+        }
+
+        lastTimestamp = scratch.timestamp();
+        offset += size;
+        ++_frameCount;
+    }
+
+    if(offset != data.size())
+        Warning() << "HandReplay: ignoring" << data.size() - offset << "bytes of trailing data in" << filename;
+
+    _data = std::move(data);
+    _dataEnd = offset;
+    _lastTimestamp = lastTimestamp;
+    rewind();
+}
+
+HandReplay& HandReplay::setSpeed(const Float speed) {
+    _speed = speed;
+    _started = false;
+    return *this;
+}
+
+HandReplay& HandReplay::rewind() {
+    _offset = sizeof(HandCapture::FileHeader);
+    _currentFrame = 0;
+    _started = _finished = false;
+    return *this;
+}
+
+bool HandReplay::doIsConnected() const {
+    return _frameCount && (_looping || !_finished);
+}
+
+HandCapture::FrameHeader HandReplay::frameHeader(const std::size_t offset) const {
+    HandCapture::FrameHeader header;
+    std::memcpy(&header, _data.data() + offset, sizeof(header));
+    return header;
+}
+
+bool HandReplay::doFrame(HandSnapshot& hands) {
+    /* Stays at the end until rewind() */
+    if(!_frameCount || _finished) return false;
+
+    /* Deterministic stepping, one recorded frame per call */
+    if(_speed <= 0.0f) {
+        if(_started) {
+            _offset += frameHeader(_offset).size;
+            ++_currentFrame;
+        }
+
+        if(_offset == _dataEnd) {
+            if(!_looping) {
+                _finished = true;
+                return false;
+            }
+            rewind();
+        }
+
+        _started = true;
+
+    /* Timed playback, skip to the last frame that's not in the future */
+    } else {
+        const auto now = std::chrono::steady_clock::now();
+        if(!_started) {
+            _startTime = now;
+            _started = true;
+        }
+
+        const UnsignedLong playbackTime = _firstTimestamp + UnsignedLong(
+            std::chrono::duration<Double, std::micro>(now - _startTime).count()*_speed);
+
+        /* Past the last frame */
+        if(playbackTime > _lastTimestamp) {
+            if(!_looping) {
+                _finished = true;
+                return false;
+            }
+
+            rewind();
+            _startTime = now;
+            _started = true;
+        } else for(;;) {
+            const std::size_t next = _offset + frameHeader(_offset).size;
+            if(next == _dataEnd || frameHeader(next).timestamp > playbackTime)
+                break;
+
+            _offset = next;
+            ++_currentFrame;
+        }
+    }
+
+    /* All frames were validated on open, so this can't fail */
+    HandCapture::deserialize(_data.suffix(_offset), hands);
+    return true;
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_HandReplay_h
+#define Magnum_VrUi_HandReplay_h
+
+#include <chrono>
+#include <string>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
+
+#include "AbstractHandSource.h"
+#include "HandCapture.h"
+
+namespace Magnum {
+
+/**
+@brief Hand capture replay
+
+Plays back a capture written by @ref HandRecorder. The file is memory-mapped
+and frames are deserialized straight from the mapping, so captures of any
+length can be replayed without any per-frame allocation.
+
+With the default speed of @cpp 0.0f @ce every call to @ref frame() advances
+by exactly one recorded frame, independently of wall clock, which makes the
+playback deterministic and as fast as the frame loop can go. Any positive
+speed plays the capture back relative to the recorded timestamps, with
+@cpp 1.0f @ce being realtime.
+*/
+class HandReplay: public AbstractHandSource {
+    public:
+        explicit HandReplay(const std::string& filename);
+
+        /** @brief Whether the capture was successfully opened */
+        bool isOpen() const { return !!_data; }
+
+        /** @brief Count of frames in the capture */
+        UnsignedInt frameCount() const { return _frameCount; }
+
+        /** @brief Index of the frame returned by last @ref frame() */
+        UnsignedInt currentFrame() const { return _currentFrame; }
+
+        Float speed() const { return _speed; }
+
+        /** @brief Set playback speed */
+        HandReplay& setSpeed(Float speed);
+
+        bool isLooping() const { return _looping; }
+
+        /**
+         * @brief Set looping
+         *
+         * If enabled, the playback starts again from the first frame after
+         * reaching the end. Otherwise @ref frame() returns @cpp false @ce
+         * at the end.
+         */
+        HandReplay& setLooping(bool looping) {
+            _looping = looping;
+            return *this;
+        }
+
+        /** @brief Rewind to the first frame, also after reaching the end */
+        HandReplay& rewind();
+
+    private:
+        bool doIsConnected() const override;
+        bool doFrame(HandSnapshot& hands) override;
+
+        HandCapture::FrameHeader frameHeader(std::size_t offset) const;
+
+        Containers::Array<const char, Utility::Directory::MapDeleter> _data;
+        std::size_t _dataEnd{}, _offset{};
+        UnsignedInt _frameCount{}, _currentFrame{};
+        UnsignedLong _firstTimestamp{}, _lastTimestamp{};
+        Float _speed{};
+        bool _looping{}, _started{}, _finished{};
+        std::chrono::steady_clock::time_point _startTime;
+};
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "HandSnapshot.h"
+
+#include <Corrade/Utility/Assert.h>
+
+namespace Magnum {
+
+void HandSnapshot::clear() {
+    _timestamp = 0;
+    _handCount = _boneCount = _jointCount = 0;
+}
+
+UnsignedInt HandSnapshot::addHand(const bool isRight) {
+    CORRADE_ASSERT(_handCount < MaxHands,
+        "HandSnapshot::addHand(): only" << MaxHands << "hands supported", 0);
+
+    /* Hands with missing fingers still need defined fingertips */
+    for(UnsignedInt finger = 0; finger != FingerCount; ++finger)
+        _fingertip.set(_handCount*FingerCount + finger, {});
+
+    _isRight[_handCount] = isRight;
+    return _handCount++;
+}
+
+void HandSnapshot::addBone(const UnsignedInt hand, const Vector3& center, const Vector3& xBasis, const Vector3& yBasis, const Vector3& zBasis, const Float length) {
+    CORRADE_ASSERT(hand < _handCount && _boneCount < MaxBones,
+        "HandSnapshot::addBone(): invalid hand or too many bones", );
+
+    _boneCenter.set(_boneCount, center);
+    _boneXBasis.set(_boneCount, xBasis);
+    _boneYBasis.set(_boneCount, yBasis);
+    _boneZBasis.set(_boneCount, zBasis);
+    _boneLength[_boneCount] = length;
+    _boneHand[_boneCount] = hand;
+    ++_boneCount;
+}
+
+void HandSnapshot::addJoint(const UnsignedInt hand, const Vector3& position) {
+    CORRADE_ASSERT(hand < _handCount && _jointCount < MaxJoints,
+        "HandSnapshot::addJoint(): invalid hand or too many joints", );
+
+    _jointPosition.set(_jointCount, position);
+    _jointHand[_jointCount] = hand;
+    ++_jointCount;
+}
+
+void HandSnapshot::setFingertip(const UnsignedInt hand, const UnsignedInt finger, const Vector3& position) {
+    CORRADE_ASSERT(hand < _handCount && finger < FingerCount,
+        "HandSnapshot::setFingertip(): invalid hand or finger", );
+
+    _fingertip.set(hand*FingerCount + finger, position);
+}
+
+void HandSnapshot::computeTransformations(const Matrix4& toWorldSpace) {
+    computeBoneTransformations();
+    computeWorldFingertips(toWorldSpace);
+}
+
+void HandSnapshot::computeBoneTransformations() {
+    /* Bone transformation is translation(center)*basis*rotationX(90°)*
+       scaling({1, length, 1}). The rotation swaps the Y and Z basis
+       vectors, so the whole product boils down to a multiply and a negation
+       per component. Written as straight loops over the component arrays
+       with no branches so the compiler vectorizes them. */
+    const UnsignedInt boneCount = _boneCount;
+    for(UnsignedInt i = 0; i != boneCount; ++i) {
+        _boneAxisY.x[i] = _boneZBasis.x[i]*_boneLength[i];
+        _boneAxisY.y[i] = _boneZBasis.y[i]*_boneLength[i];
+        _boneAxisY.z[i] = _boneZBasis.z[i]*_boneLength[i];
+    }
+    for(UnsignedInt i = 0; i != boneCount; ++i) {
+        _boneAxisZ.x[i] = -_boneYBasis.x[i];
+        _boneAxisZ.y[i] = -_boneYBasis.y[i];
+        _boneAxisZ.z[i] = -_boneYBasis.z[i];
+    }
+}
+
+void HandSnapshot::computeWorldFingertips(const Matrix4& toWorldSpace) {
+    /* Fingertips to world space, toWorldSpace is affine */
+    const Matrix4& m = toWorldSpace;
+    const UnsignedInt fingertipCount = _handCount*FingerCount;
+    for(UnsignedInt i = 0; i != fingertipCount; ++i) {
+        const Float x = _fingertip.x[i], y = _fingertip.y[i], z = _fingertip.z[i];
+        _worldFingertip.x[i] = m[0][0]*x + m[1][0]*y + m[2][0]*z + m[3][0];
+        _worldFingertip.y[i] = m[0][1]*x + m[1][1]*y + m[2][1]*z + m[3][1];
+        _worldFingertip.z[i] = m[0][2]*x + m[1][2]*y + m[2][2]*z + m[3][2];
+    }
+}
+
+Int HandSnapshot::hand(const bool right) const {
+    for(UnsignedInt i = 0; i != _handCount; ++i)
+        if(_isRight[i] == right) return i;
+    return -1;
+}
+
+Matrix4 HandSnapshot::boneTransformation(const UnsignedInt bone) const {
+    return Matrix4::from(Matrix3x3{_boneXBasis[bone], _boneAxisY[bone], _boneAxisZ[bone]}, _boneCenter[bone]);
+}
+
+}
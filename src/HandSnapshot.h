@@ -0,0 +1,211 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_HandSnapshot_h
+#define Magnum_VrUi_HandSnapshot_h
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Matrix4.h>
+
+namespace Magnum {
+
+/**
+@brief Fixed-size array of 3D vectors stored component-wise
+
+Each component is a separate contiguous array so loops over it can be
+vectorized by the compiler.
+*/
+template<UnsignedInt size> struct Vector3Array {
+    Vector3 operator[](UnsignedInt i) const { return {x[i], y[i], z[i]}; }
+
+    void set(UnsignedInt i, const Vector3& value) {
+        x[i] = value.x();
+        y[i] = value.y();
+        z[i] = value.z();
+    }
+
+    Float x[size];
+    Float y[size];
+    Float z[size];
+};
+
+/**
+@brief Per-frame hand snapshot
+
+Everything the renderer and UI interaction need from a hand tracking frame,
+extracted once per frame and shared by both eyes. Bones, joints and
+fingertips of all hands are stored in fixed-size component-wise arrays, so
+there are no allocations and the snapshot is trivially copyable. Positions
+are in hand tracking space, in millimeters.
+
+After filling the snapshot, call @ref computeTransformations() to calculate
+bone transformations and world-space fingertip positions for the whole frame
+in one batch.
+*/
+class HandSnapshot {
+    public:
+        enum: UnsignedInt {
+            MaxHands = 2,
+            FingerCount = 5,
+
+            /* Four bones per finger, minus the first bones of middle and
+               ring finger which aren't drawn */
+            MaxBonesPerHand = 18,
+
+            /* Start of every bone and end of the last bone of every finger */
+            MaxJointsPerHand = MaxBonesPerHand + FingerCount,
+
+            MaxBones = MaxHands*MaxBonesPerHand,
+            MaxJoints = MaxHands*MaxJointsPerHand,
+            MaxFingertips = MaxHands*FingerCount
+        };
+
+        /** @brief Finger index, in order of the tracking SDK finger types */
+        enum: UnsignedInt {
+            Thumb = 0,
+            Index = 1,
+            Middle = 2,
+            Ring = 3,
+            Pinky = 4
+        };
+
+        /** @brief Remove all hands and reset the timestamp */
+        void clear();
+
+        /** @brief Timestamp of the tracking frame, in microseconds */
+        UnsignedLong timestamp() const { return _timestamp; }
+
+        void setTimestamp(UnsignedLong timestamp) { _timestamp = timestamp; }
+
+        /**
+         * @brief Add a hand
+         *
+         * Returns ID of the hand to be used in @ref addBone(),
+         * @ref addJoint() and @ref setFingertip().
+         */
+        UnsignedInt addHand(bool isRight);
+
+        /** @brief Add a bone described by its center, orientation and length */
+        void addBone(UnsignedInt hand, const Vector3& center, const Vector3& xBasis, const Vector3& yBasis, const Vector3& zBasis, Float length);
+
+        /** @brief Add a joint */
+        void addJoint(UnsignedInt hand, const Vector3& position);
+
+        /** @brief Set fingertip position */
+        void setFingertip(UnsignedInt hand, UnsignedInt finger, const Vector3& position);
+
+        /**
+         * @brief Compute bone transformations and world-space fingertips
+         * @param toWorldSpace  Transformation from hand tracking space to
+         *      world space
+         *
+         * Same as calling @ref computeBoneTransformations() and
+         * @ref computeWorldFingertips().
+         */
+        void computeTransformations(const Matrix4& toWorldSpace);
+
+        /**
+         * @brief Compute bone transformations
+         *
+         * Bone transformations stay in hand tracking space, so they can be
+         * computed before the head pose is known.
+         */
+        void computeBoneTransformations();
+
+        /**
+         * @brief Compute world-space fingertips
+         * @param toWorldSpace  Transformation from hand tracking space to
+         *      world space
+         */
+        void computeWorldFingertips(const Matrix4& toWorldSpace);
+
+        UnsignedInt handCount() const { return _handCount; }
+        bool isRight(UnsignedInt hand) const { return _isRight[hand]; }
+
+        /** @brief Index of the right or left hand, `-1` if not tracked */
+        Int hand(bool right) const;
+
+        UnsignedInt boneCount() const { return _boneCount; }
+        UnsignedInt boneHand(UnsignedInt bone) const { return _boneHand[bone]; }
+        Vector3 boneCenter(UnsignedInt bone) const { return _boneCenter[bone]; }
+        Vector3 boneXBasis(UnsignedInt bone) const { return _boneXBasis[bone]; }
+        Vector3 boneYBasis(UnsignedInt bone) const { return _boneYBasis[bone]; }
+        Vector3 boneZBasis(UnsignedInt bone) const { return _boneZBasis[bone]; }
+        Float boneLength(UnsignedInt bone) const { return _boneLength[bone]; }
+
+        /**
+         * @brief Bone transformation
+         *
+         * Transforms a bone of unit length along the Y axis centered at
+         * origin to the actual bone. Calculated by
+         * @ref computeTransformations().
+         */
+        Matrix4 boneTransformation(UnsignedInt bone) const;
+
+        UnsignedInt jointCount() const { return _jointCount; }
+        UnsignedInt jointHand(UnsignedInt joint) const { return _jointHand[joint]; }
+        Vector3 jointPosition(UnsignedInt joint) const { return _jointPosition[joint]; }
+
+        /** @brief Fingertip position in hand tracking space */
+        Vector3 fingertip(UnsignedInt hand, UnsignedInt finger) const {
+            return _fingertip[hand*FingerCount + finger];
+        }
+
+        /**
+         * @brief Fingertip position in world space
+         *
+         * Calculated by @ref computeTransformations().
+         */
+        Vector3 worldFingertip(UnsignedInt hand, UnsignedInt finger) const {
+            return _worldFingertip[hand*FingerCount + finger];
+        }
+
+    private:
+        UnsignedLong _timestamp{};
+        UnsignedInt _handCount{},
+            _boneCount{},
+            _jointCount{};
+        bool _isRight[MaxHands];
+
+        /* Input */
+        Vector3Array<MaxBones> _boneCenter,
+            _boneXBasis,
+            _boneYBasis,
+            _boneZBasis;
+        Float _boneLength[MaxBones];
+        UnsignedByte _boneHand[MaxBones];
+        Vector3Array<MaxJoints> _jointPosition;
+        UnsignedByte _jointHand[MaxJoints];
+        Vector3Array<MaxFingertips> _fingertip;
+
+        /* Output of computeTransformations(), the X axis is the same as
+           the X basis */
+        Vector3Array<MaxBones> _boneAxisY,
+            _boneAxisZ;
+        Vector3Array<MaxFingertips> _worldFingertip;
+};
+
+}
+
+#endif
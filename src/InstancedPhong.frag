@@ -0,0 +1,31 @@
+uniform lowp vec3 ambientColor;
+uniform lowp vec3 specularColor;
+uniform mediump float shininess;
+
+in mediump vec3 transformedNormal;
+in highp vec3 lightDirection;
+in highp vec3 cameraDirection;
+flat in lowp vec3 diffuseColor;
+
+layout(location = 0) out lowp vec4 color;
+
+void main() {
+    /* Ambient color */
+    lowp vec3 finalColor = ambientColor;
+
+    mediump vec3 normalizedTransformedNormal = normalize(transformedNormal);
+    highp vec3 normalizedLightDirection = normalize(lightDirection);
+
+    /* Add diffuse color */
+    lowp float intensity = max(0.0, dot(normalizedTransformedNormal, normalizedLightDirection));
+    finalColor += diffuseColor*intensity;
+
+    /* Add specular color, if needed */
+    if(intensity > 0.001) {
+        highp vec3 reflection = reflect(-normalizedLightDirection, normalizedTransformedNormal);
+        mediump float specularity = pow(max(0.0, dot(normalize(cameraDirection), reflection)), shininess);
+        finalColor += specularColor*specularity;
+    }
+
+    color = vec4(finalColor, 1.0);
+}
@@ -0,0 +1,134 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_InstancedPhong_h
+#define Magnum_VrUi_InstancedPhong_h
+
+#include <Corrade/Containers/EnumSet.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+namespace Magnum {
+
+class StartupCache;
+
+/**
+@brief Instanced Phong shader
+
+Equivalent of @ref Shaders::Phong with a single white light, but with the
+transformation, normal matrix and diffuse color taken from per-instance
+vertex attributes instead of uniforms, so a whole batch of hand bones or
+joints can be rendered with a single draw call. Position and normal
+attribute locations match @ref Shaders::Phong, so the same vertex buffers
+can be shared between both.
+
+With @ref Flag::Stereo the shader renders both eyes in a single draw into a
+side-by-side target. Draw twice the instance count with per-instance
+attributes having a divisor of 2, even instances go to the left half and odd
+instances to the right half. Requires @cpp GL_CLIP_DISTANCE0 @ce to be enabled.
+*/
+class InstancedPhong: public GL::AbstractShaderProgram {
+    public:
+        typedef GL::Attribute<0, Vector3> Position;
+        typedef GL::Attribute<2, Vector3> Normal;
+
+        /** @brief Per-instance transformation, occupies locations 3 to 6 */
+        typedef GL::Attribute<3, Matrix4> TransformationMatrix;
+
+        /** @brief Per-instance normal matrix, occupies locations 7 to 9 */
+        typedef GL::Attribute<7, Matrix3x3> NormalMatrix;
+
+        /** @brief Per-instance diffuse color */
+        typedef GL::Attribute<10, Color3> Color;
+
+        enum class Flag: UnsignedByte {
+            /** Single-pass side-by-side stereo rendering */
+            Stereo = 1 << 0
+        };
+
+        typedef Containers::EnumSet<Flag> Flags;
+
+        /**
+         * @brief Constructor
+         * @param flags     Flags
+         * @param cache     Cache to load the program binary from and save
+         *      it to, or @cpp nullptr @ce to always compile
+         */
+        explicit InstancedPhong(Flags flags = {}, StartupCache* cache = nullptr);
+
+        explicit InstancedPhong(NoCreateT) noexcept: GL::AbstractShaderProgram{NoCreate} {}
+
+        Flags flags() const { return _flags; }
+
+        /**
+         * @brief Set projection matrix
+         *
+         * Expects that @ref Flag::Stereo is not set.
+         */
+        InstancedPhong& setProjectionMatrix(const Matrix4& matrix);
+
+        /**
+         * @brief Set projection matrices for both eyes
+         *
+         * Expects that @ref Flag::Stereo is set.
+         */
+        InstancedPhong& setProjectionMatrices(const Matrix4& left, const Matrix4& right);
+
+        InstancedPhong& setLightPosition(const Vector3& position) {
+            setUniform(_lightPositionUniform, position);
+            return *this;
+        }
+
+        InstancedPhong& setAmbientColor(const Color3& color) {
+            setUniform(_ambientColorUniform, color);
+            return *this;
+        }
+
+        InstancedPhong& setSpecularColor(const Color3& color) {
+            setUniform(_specularColorUniform, color);
+            return *this;
+        }
+
+        InstancedPhong& setShininess(Float shininess) {
+            setUniform(_shininessUniform, shininess);
+            return *this;
+        }
+
+    private:
+        Flags _flags;
+        Int _projectionMatrixUniform{0},
+            _rightProjectionMatrixUniform{1},
+            _lightPositionUniform{2},
+            _ambientColorUniform{3},
+            _specularColorUniform{4},
+            _shininessUniform{5};
+};
+
+CORRADE_ENUMSET_OPERATORS(InstancedPhong::Flags)
+
+}
+
+#endif
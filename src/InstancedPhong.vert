@@ -0,0 +1,53 @@
+#ifdef STEREO
+uniform highp mat4 projectionMatrices[2];
+#else
+uniform highp mat4 projectionMatrix;
+#endif
+uniform highp vec3 lightPosition;
+
+layout(location = 0) in highp vec4 position;
+layout(location = 2) in mediump vec3 normal;
+
+/* Per-instance attributes, see InstancedPhong::TransformationMatrix and
+   friends for the locations */
+layout(location = 3) in highp mat4 transformationMatrix;
+layout(location = 7) in mediump mat3 normalMatrix;
+layout(location = 10) in lowp vec3 instanceColor;
+
+out mediump vec3 transformedNormal;
+out highp vec3 lightDirection;
+out highp vec3 cameraDirection;
+flat out lowp vec3 diffuseColor;
+
+void main() {
+    /* Transformed vertex position */
+    highp vec4 transformedPosition4 = transformationMatrix*position;
+    highp vec3 transformedPosition = transformedPosition4.xyz/transformedPosition4.w;
+
+    /* Transformed normal vector */
+    transformedNormal = normalMatrix*normal;
+
+    /* Direction to the light */
+    lightDirection = normalize(lightPosition - transformedPosition);
+
+    /* Direction to the camera */
+    cameraDirection = -transformedPosition;
+
+    diffuseColor = instanceColor;
+
+    #ifdef STEREO
+    /* Even instances are for the left eye, odd for the right one. The
+       per-instance attributes have a divisor of 2, so both eyes get the same
+       data. */
+    int eye = gl_InstanceID & 1;
+    gl_Position = projectionMatrices[eye]*transformedPosition4;
+
+    /* Squeeze into the eye's half of the side-by-side target and clip away
+       everything that would leak into the other half */
+    gl_Position.x = gl_Position.x*0.5 + (eye == 0 ? -0.5 : 0.5)*gl_Position.w;
+    gl_ClipDistance[0] = eye == 0 ? -gl_Position.x : gl_Position.x;
+    #else
+    /* Transform the position */
+    gl_Position = projectionMatrix*transformedPosition4;
+    #endif
+}
@@ -0,0 +1,141 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "JobSystem.h"
+
+#include <Corrade/Utility/Assert.h>
+
+namespace Magnum {
+
+namespace {
+
+/* Queue of the current thread, 0 for threads outside of any job system.
+   There's at most one job system running, so it doesn't need to know
+   which one the index belongs to. */
+thread_local UnsignedInt currentQueue = 0;
+
+}
+
+JobSystem::JobSystem(const UnsignedInt workerCount): _queueCount{workerCount + 1}, _queues{new Queue[workerCount + 1]} {
+    _threads.reserve(workerCount);
+    for(UnsignedInt i = 0; i != workerCount; ++i)
+        _threads.emplace_back(&JobSystem::work, this, i + 1);
+}
+
+JobSystem::~JobSystem() {
+    CORRADE_ASSERT(!_queued.load(),
+        "JobSystem: destroyed with" << _queued.load() << "jobs still queued", );
+
+    {
+        std::lock_guard<std::mutex> lock{_sleepMutex};
+        _stop = true;
+    }
+    _wake.notify_all();
+    for(std::thread& thread: _threads) thread.join();
+}
+
+UnsignedInt JobSystem::queueIndex() const {
+    CORRADE_INTERNAL_ASSERT(currentQueue < _queueCount);
+    return currentQueue;
+}
+
+void JobSystem::run(Counter& counter, const Function function, void* const data) {
+    counter._pending.fetch_add(1, std::memory_order_relaxed);
+
+    Queue& queue = _queues[queueIndex()];
+    {
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        CORRADE_ASSERT(queue.size < QueueCapacity,
+            "JobSystem::run(): queue full", );
+        queue.jobs[(queue.front + queue.size) % QueueCapacity] = Job{function, data, &counter};
+        ++queue.size;
+    }
+
+    /* Taking the sleep mutex makes sure a worker that just found all queues
+       empty is already waiting, so the notification isn't lost */
+    _queued.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock{_sleepMutex};
+    }
+    _wake.notify_one();
+}
+
+bool JobSystem::pop(const UnsignedInt queueId, Job& job) {
+    Queue& queue = _queues[queueId];
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    if(!queue.size) return false;
+    --queue.size;
+    job = queue.jobs[(queue.front + queue.size) % QueueCapacity];
+    _queued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::steal(const UnsignedInt thief, Job& job) {
+    for(UnsignedInt i = 1; i != _queueCount; ++i) {
+        Queue& queue = _queues[(thief + i) % _queueCount];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        if(!queue.size) continue;
+        job = queue.jobs[queue.front];
+        queue.front = (queue.front + 1) % QueueCapacity;
+        --queue.size;
+        _queued.fetch_sub(1, std::memory_order_relaxed);
+        _stolenCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+void JobSystem::execute(const Job& job) {
+    job.function(job.data);
+    _finishedCount.fetch_add(1, std::memory_order_relaxed);
+    job.counter->_pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::wait(Counter& counter) {
+    const UnsignedInt queue = queueIndex();
+    Job job;
+    while(!counter.isDone()) {
+        if(pop(queue, job) || steal(queue, job)) execute(job);
+        else std::this_thread::yield();
+    }
+}
+
+void JobSystem::work(const UnsignedInt queue) {
+    currentQueue = queue;
+
+    Job job;
+    for(;;) {
+        if(pop(queue, job) || steal(queue, job)) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{_sleepMutex};
+        _wake.wait(lock, [this] { return _stop || _queued.load(std::memory_order_acquire); });
+        if(_stop) return;
+    }
+}
+
+}
@@ -0,0 +1,185 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_JobSystem_h
+#define Magnum_VrUi_JobSystem_h
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <Magnum/Magnum.h>
+
+namespace Magnum {
+
+/**
+@brief Work-stealing job system
+
+Runs small jobs on a fixed set of worker threads. Each worker and the
+thread that submits jobs from outside have their own fixed-size job queue.
+A thread takes jobs from the back of its own queue and, once that is empty,
+steals from the front of the others. Jobs submitted from a job go to the
+queue of the worker running it.
+
+A job is a plain function pointer with a data pointer, so submitting it
+never allocates. Completion is tracked with a @ref Counter; @ref wait()
+runs queued jobs on the waiting thread until the counter drops to zero,
+so waiting never leaves a core idle and a job system with no workers runs
+everything serially in @ref wait().
+
+@code{.cpp}
+JobSystem jobs{3};
+JobSystem::Counter done;
+jobs.run(done, [](void* data) {
+    static_cast<HandSnapshot*>(data)->computeBoneTransformations();
+}, &hands);
+
+// do something else on this thread
+
+jobs.wait(done);
+@endcode
+
+Jobs are expected to be submitted and waited for from a single thread
+outside of the job system, or from jobs.
+*/
+class JobSystem {
+    public:
+        /** @brief Job function */
+        typedef void(*Function)(void*);
+
+        /** @brief Max count of jobs queued in a single queue */
+        enum: UnsignedInt { QueueCapacity = 256 };
+
+        /**
+         * @brief Job completion counter
+         *
+         * Counts jobs submitted with it that haven't finished yet. Can be
+         * reused once it's done.
+         */
+        class Counter {
+            public:
+                /** @brief Whether all jobs submitted with it finished */
+                bool isDone() const {
+                    return _pending.load(std::memory_order_acquire) == 0;
+                }
+
+            private:
+                friend JobSystem;
+
+                std::atomic<UnsignedInt> _pending{0};
+        };
+
+        /**
+         * @brief Constructor
+         * @param workerCount   Count of worker threads. With
+         *      @cpp 0 @ce, all jobs are run in @ref wait().
+         *
+         * Starts the worker threads.
+         */
+        explicit JobSystem(UnsignedInt workerCount);
+
+        /**
+         * @brief Destructor
+         *
+         * Expects that no jobs are queued. Stops and joins the worker
+         * threads.
+         */
+        ~JobSystem();
+
+        /** @brief Copying is not allowed */
+        JobSystem(const JobSystem&) = delete;
+
+        /** @brief Copying is not allowed */
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /** @brief Count of worker threads */
+        UnsignedInt workerCount() const { return _queueCount - 1; }
+
+        /**
+         * @brief Submit a job
+         *
+         * Expects that the queue of the calling thread has less than
+         * @ref QueueCapacity jobs.
+         */
+        void run(Counter& counter, Function function, void* data);
+
+        /**
+         * @brief Wait until all jobs of a counter finish
+         *
+         * Runs queued jobs on the calling thread while waiting.
+         */
+        void wait(Counter& counter);
+
+        /** @brief Count of jobs finished so far */
+        UnsignedLong finishedCount() const { return _finishedCount.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Count of stolen jobs
+         *
+         * Jobs that were run by a different thread than the one that
+         * queued them.
+         */
+        UnsignedLong stolenCount() const { return _stolenCount.load(std::memory_order_relaxed); }
+
+    private:
+        struct Job {
+            Function function;
+            void* data;
+            Counter* counter;
+        };
+
+        /* A ring buffer, the owner pushes and pops at the back, thieves
+           take from the front */
+        struct Queue {
+            std::mutex mutex;
+            Job jobs[QueueCapacity];
+            UnsignedInt front{}, size{};
+        };
+
+        UnsignedInt queueIndex() const;
+        bool pop(UnsignedInt queue, Job& job);
+        bool steal(UnsignedInt thief, Job& job);
+        void execute(const Job& job);
+        void work(UnsignedInt queue);
+
+        /* Queue 0 is for the submitting thread outside of the job system,
+           the others for workers. The count is fixed before any worker
+           starts, as the thread list is still growing at that point. */
+        const UnsignedInt _queueCount;
+        std::unique_ptr<Queue[]> _queues;
+        std::vector<std::thread> _threads;
+
+        std::mutex _sleepMutex;
+        std::condition_variable _wake;
+        std::atomic<UnsignedInt> _queued{0};
+        std::atomic<bool> _stop{false};
+
+        std::atomic<UnsignedLong> _finishedCount{0}, _stolenCount{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "LeapHandSource.h"
+
+#include "AllocationCounter.h"
+#include "HandSnapshot.h"
+
+namespace Magnum {
+
+namespace {
+
+Vector3 fromLeap(const Leap::Vector& vector) {
+    return {vector.x, vector.y, vector.z};
+}
+
+}
+
+LeapHandSource::LeapHandSource() {
+    _controller.setPolicy(Leap::Controller::PolicyFlag::POLICY_OPTIMIZE_HMD);
+}
+
+bool LeapHandSource::doIsConnected() const {
+    return _controller.isConnected();
+}
+
+bool LeapHandSource::doFrame(HandSnapshot& hands) {
+    if(!_controller.isConnected()) return false;
+
+    /* Frame, hand and finger objects are reference-counted handles
+       allocated inside the SDK */
+    AllocationCounter::Exempt exempt;
+    const Leap::Frame frame = _controller.frame();
+    hands.setTimestamp(frame.timestamp());
+
+    for(const Leap::Hand& hand : frame.hands()) {
+        if(hands.handCount() == HandSnapshot::MaxHands) break;
+
+        const UnsignedInt id = hands.addHand(hand.isRight());
+        for(const Leap::Finger& finger : hand.fingers()) {
+            hands.setFingertip(id, finger.type(), fromLeap(finger.tipPosition()));
+
+            for(int b = 0; b < 4; ++b) {
+                /* Leave out first bones of ring and middle finger, looks better */
+                if(b == 0 && (finger.type() == Leap::Finger::Type::TYPE_MIDDLE || finger.type() == Leap::Finger::Type::TYPE_RING)) continue;
+
+                const Leap::Bone bone = finger.bone(Leap::Bone::Type(b));
+                const Leap::Matrix basis = bone.basis();
+                hands.addBone(id, fromLeap(bone.center()),
+                    fromLeap(basis.xBasis), fromLeap(basis.yBasis), fromLeap(basis.zBasis),
+                    bone.length());
+
+                /* Joint at start of every bone, at the end only for last
+                   bones */
+                hands.addJoint(id, fromLeap(bone.prevJoint()));
+                if(b == 3) hands.addJoint(id, fromLeap(bone.nextJoint()));
+            }
+        }
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,53 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_LeapHandSource_h
+#define Magnum_VrUi_LeapHandSource_h
+
+#include <Leap.h>
+
+#include "AbstractHandSource.h"
+
+namespace Magnum {
+
+/**
+@brief Live Leap Motion hand source
+
+Polls the latest frame from the Leap Motion controller, optimized for HMD
+mounting.
+*/
+class LeapHandSource: public AbstractHandSource {
+    public:
+        explicit LeapHandSource();
+
+    private:
+        bool doIsConnected() const override;
+        bool doFrame(HandSnapshot& hands) override;
+
+        Leap::Controller _controller;
+};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "MockHmd.h"
+
+#include <thread>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Math/Functions.h>
+
+namespace Magnum {
+
+using namespace Math::Literals;
+
+namespace {
+
+/* Same texture count as the Oculus runtime swap chains */
+constexpr const std::size_t SwapChainLength{3};
+
+/* Average interpupillary distance, in meters */
+constexpr const Float Ipd{0.064f};
+
+}
+
+MockHmd::MockHmd(const Vector2i& eyeTextureSize): _eyeTextureSize{eyeTextureSize} {}
+
+MockHmd& MockHmd::setRefreshRate(const Float rate) {
+    _refreshInterval = std::chrono::nanoseconds{rate > 0.0f ? Long(1.0e9/rate) : 0};
+    _nextRefresh = {};
+    return *this;
+}
+
+Vector2i MockHmd::doEyeTextureSize(Int) const {
+    return _eyeTextureSize;
+}
+
+Matrix4 MockHmd::doProjectionMatrix(Int, const Float near, const Float far) const {
+    return Matrix4::perspectiveProjection(100.0_degf, Vector2{_eyeTextureSize}.aspectRatio(), near, far);
+}
+
+void MockHmd::doCreateEyeTarget(const Int target, const Vector2i& size) {
+    _swapChain[target].clear();
+    _swapChain[target].reserve(SwapChainLength);
+    for(std::size_t i = 0; i != SwapChainLength; ++i) {
+        _swapChain[target].emplace_back();
+        _swapChain[target].back().setMinificationFilter(GL::SamplerFilter::Linear)
+            .setMagnificationFilter(GL::SamplerFilter::Linear)
+            .setWrapping(GL::SamplerWrapping::ClampToEdge)
+            .setStorage(1, GL::TextureFormat::RGBA8, size);
+    }
+    _activeTexture[target] = 0;
+}
+
+GL::Texture2D& MockHmd::doActiveTexture(const Int target) {
+    return _swapChain[target][_activeTexture[target]];
+}
+
+void MockHmd::doCommit(const Int target) {
+    _activeTexture[target] = (_activeTexture[target] + 1) % _swapChain[target].size();
+}
+
+void MockHmd::doSetEyeViewport(Int, Int, const Range2Di&) {}
+
+void MockHmd::doWaitForFrame() {
+    if(!_refreshInterval.count()) return;
+
+    /* The first frame starts right away, later ones on the first refresh
+       that didn't pass yet */
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(_nextRefresh == std::chrono::steady_clock::time_point{}) _nextRefresh = now;
+    else if(_nextRefresh < now) {
+        const auto missed = (now - _nextRefresh)/_refreshInterval + 1;
+        _missedRefreshCount += UnsignedInt(missed);
+        _nextRefresh += missed*_refreshInterval;
+    }
+
+    std::this_thread::sleep_until(_nextRefresh);
+    _nextRefresh += _refreshInterval;
+}
+
+void MockHmd::doPollPoses(DualQuaternion(&eyePoses)[2], DualQuaternion& headPose) {
+    headPose = DualQuaternion{};
+    eyePoses[0] = DualQuaternion::translation(Vector3::xAxis(-Ipd*0.5f));
+    eyePoses[1] = DualQuaternion::translation(Vector3::xAxis(Ipd*0.5f));
+}
+
+void MockHmd::doSubmitFrame() {
+    ++_submittedFrameCount;
+}
+
+void MockHmd::doResubmitFrame() {
+    ++_submittedFrameCount;
+    ++_resubmittedFrameCount;
+}
+
+}
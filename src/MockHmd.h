@@ -0,0 +1,104 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_MockHmd_h
+#define Magnum_VrUi_MockHmd_h
+
+#include <chrono>
+#include <vector>
+#include <Magnum/GL/Texture.h>
+
+#include "AbstractHmd.h"
+
+namespace Magnum {
+
+/**
+@brief Mock HMD
+
+Stands in for a real HMD so the frame loop can run on a windowless context
+without any VR runtime. Eye and head poses are fixed, with the head at the
+origin looking down the negative Z axis. Each eye target is a ring of three
+offscreen textures mimicking a texture swap chain, submitting a frame does
+nothing besides counting. With a refresh rate set, @ref waitForFrame()
+sleeps until the next display refresh like a compositor would, otherwise it
+returns immediately.
+*/
+class MockHmd: public AbstractHmd {
+    public:
+        /**
+         * @brief Constructor
+         * @param eyeTextureSize    Eye texture size, by default roughly
+         *      matching the Oculus Rift
+         */
+        explicit MockHmd(const Vector2i& eyeTextureSize = {1344, 1600});
+
+        /**
+         * @brief Count of frames submitted
+         *
+         * Includes resubmitted frames.
+         */
+        UnsignedInt submittedFrameCount() const { return _submittedFrameCount; }
+
+        /** @brief Count of frames resubmitted */
+        UnsignedInt resubmittedFrameCount() const { return _resubmittedFrameCount; }
+
+        /**
+         * @brief Set display refresh rate
+         *
+         * In Hz. Default is @cpp 0.0f @ce, which disables pacing.
+         */
+        MockHmd& setRefreshRate(Float rate);
+
+        /**
+         * @brief Count of missed display refreshes
+         *
+         * Refreshes that passed without a frame because the previous one
+         * took too long. Only counted with a refresh rate set.
+         */
+        UnsignedInt missedRefreshCount() const { return _missedRefreshCount; }
+
+    private:
+        Vector2i doEyeTextureSize(Int eye) const override;
+        Matrix4 doProjectionMatrix(Int eye, Float near, Float far) const override;
+        void doCreateEyeTarget(Int target, const Vector2i& size) override;
+        GL::Texture2D& doActiveTexture(Int target) override;
+        void doCommit(Int target) override;
+        void doSetEyeViewport(Int eye, Int target, const Range2Di& viewport) override;
+        void doWaitForFrame() override;
+        void doPollPoses(DualQuaternion(&eyePoses)[2], DualQuaternion& headPose) override;
+        void doSubmitFrame() override;
+        void doResubmitFrame() override;
+
+        Vector2i _eyeTextureSize;
+        std::vector<GL::Texture2D> _swapChain[2];
+        std::size_t _activeTexture[2]{};
+        UnsignedInt _submittedFrameCount{}, _resubmittedFrameCount{};
+        std::chrono::nanoseconds _refreshInterval{};
+        std::chrono::steady_clock::time_point _nextRefresh;
+        UnsignedInt _missedRefreshCount{};
+};
+
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include "ModalPool.h"
+
+#include <Corrade/Interconnect/Receiver.h>
+#include <Corrade/Utility/Assert.h>
+
+#include "GalleryUi.h"
+
+namespace Magnum {
+
+ModalPool::ModalPool(Ui::UserInterface& ui, const std::size_t capacity): _ui(ui), _capacity{capacity} {}
+
+ModalPool::~ModalPool() = default;
+
+UnsignedInt ModalPool::add(const Ui::Style style) {
+    _slots.push_back({style, false, 0, nullptr});
+    return UnsignedInt(_slots.size() - 1);
+}
+
+ModalPool& ModalPool::createAll() {
+    for(UnsignedInt id = 0; id != _slots.size(); ++id)
+        if(!_slots[id].plane) create(id);
+    return *this;
+}
+
+bool ModalPool::isCreated(const UnsignedInt id) const {
+    CORRADE_ASSERT(id < _slots.size(), "ModalPool::isCreated(): index" << id << "out of range for" << _slots.size() << "dialogs", {});
+    return !!_slots[id].plane;
+}
+
+bool ModalPool::isVisible(const UnsignedInt id) const {
+    CORRADE_ASSERT(id < _slots.size(), "ModalPool::isVisible(): index" << id << "out of range for" << _slots.size() << "dialogs", {});
+    return _slots[id].visible;
+}
+
+ModalUiPlane& ModalPool::create(const UnsignedInt id) {
+    Slot& slot = _slots[id];
+    slot.plane.reset(new ModalUiPlane{_ui, slot.style});
+
+    /* The connection goes away together with the plane */
+    Interconnect::connect(slot.plane->close, &Ui::Button::tapped, [this, id]() { hide(id); });
+
+    ++_liveCount;
+    ++_createdCount;
+    return *slot.plane;
+}
+
+ModalUiPlane& ModalPool::activate(const UnsignedInt id) {
+    CORRADE_ASSERT(id < _slots.size(), "ModalPool::activate(): index" << id << "out of range for" << _slots.size() << "dialogs", *_slots[0].plane);
+    Slot& slot = _slots[id];
+
+    ModalUiPlane* plane = slot.plane.get();
+    if(plane) ++_recycledCount;
+    else plane = &create(id);
+
+    plane->activate();
+    slot.visible = true;
+    return *plane;
+}
+
+void ModalPool::hide(const UnsignedInt id) {
+    CORRADE_ASSERT(id < _slots.size(), "ModalPool::hide(): index" << id << "out of range for" << _slots.size() << "dialogs", );
+    Slot& slot = _slots[id];
+    if(!slot.visible) return;
+
+    slot.plane->hide();
+    slot.visible = false;
+    slot.hiddenAt = ++_hideCount;
+}
+
+std::size_t ModalPool::collect() {
+    std::size_t released = 0;
+    for(;;) {
+        /* Find the dialog closed longest ago among the closed ones. There
+           are at most a few dozen dialogs, a linear scan is enough. */
+        std::size_t closedCount = 0;
+        Slot* oldest = nullptr;
+        for(Slot& slot: _slots) {
+            if(!slot.plane || slot.visible) continue;
+            ++closedCount;
+            if(!oldest || slot.hiddenAt < oldest->hiddenAt) oldest = &slot;
+        }
+        if(closedCount <= _capacity) break;
+
+        oldest->plane = nullptr;
+        --_liveCount;
+        ++released;
+    }
+
+    _releasedCount += released;
+    return released;
+}
+
+}
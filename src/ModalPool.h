@@ -0,0 +1,178 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef Magnum_VrUi_ModalPool_h
+#define Magnum_VrUi_ModalPool_h
+
+#include <memory>
+#include <vector>
+#include <Magnum/Magnum.h>
+#include <Magnum/Ui/Style.h>
+#include <Magnum/Ui/Ui.h>
+
+namespace Magnum {
+
+struct ModalUiPlane;
+
+/**
+@brief Lazily created modal UI planes
+
+Modal dialogs are registered with @ref add() upfront, but their
+@ref ModalUiPlane --- with its own glyph and widget capacity --- gets
+created only when the dialog is first shown with @ref activate(). Startup
+time and memory then scale with the count of dialogs actually used, not the
+count of dialogs that exist.
+
+Closed dialogs stay alive in a small recycling pool, so reopening a recently
+used one doesn't create it again. Once more than @ref capacity() closed
+dialogs are kept, the ones closed longest ago are destroyed on the next
+@ref collect(). Dialogs can't be destroyed right when closed, as that
+happens from a signal of their own close button.
+
+@code{.cpp}
+ModalPool modals{ui};
+const UnsignedInt danger = modals.add(Ui::Style::Danger);
+Interconnect::connect(button, &Ui::Button::tapped, [&]{ modals.activate(danger); });
+// ...
+modals.collect();
+@endcode
+*/
+class ModalPool {
+    public:
+        /**
+         * @brief Constructor
+         * @param ui        UI to create the planes in, expected to stay
+         *      alive for the whole lifetime of the pool
+         * @param capacity  Max count of closed dialogs kept alive
+         */
+        explicit ModalPool(Ui::UserInterface& ui, std::size_t capacity = 2);
+
+        /** @brief Copying is not allowed */
+        ModalPool(const ModalPool&) = delete;
+
+        ~ModalPool();
+
+        /** @brief Copying is not allowed */
+        ModalPool& operator=(const ModalPool&) = delete;
+
+        /** @brief Max count of closed dialogs kept alive */
+        std::size_t capacity() const { return _capacity; }
+
+        /**
+         * @brief Set max count of closed dialogs kept alive
+         *
+         * Set to @cpp 0 @ce to destroy every dialog after it's closed.
+         * Takes effect on next @ref collect().
+         */
+        ModalPool& setCapacity(std::size_t capacity) {
+            _capacity = capacity;
+            return *this;
+        }
+
+        /** @brief Count of registered dialogs */
+        std::size_t count() const { return _slots.size(); }
+
+        /**
+         * @brief Register a dialog
+         * @return Dialog ID
+         *
+         * Doesn't create anything.
+         */
+        UnsignedInt add(Ui::Style style);
+
+        /**
+         * @brief Create all dialogs upfront
+         *
+         * For comparison with lazy creation. The dialogs still get
+         * destroyed by @ref collect() when closed with a capacity lower
+         * than @ref count().
+         */
+        ModalPool& createAll();
+
+        /** @brief Whether the dialog plane is currently created */
+        bool isCreated(UnsignedInt id) const;
+
+        /** @brief Whether the dialog is shown */
+        bool isVisible(UnsignedInt id) const;
+
+        /**
+         * @brief Show a dialog
+         *
+         * Creates the dialog plane if it doesn't exist yet, otherwise
+         * reuses the existing one, and activates it.
+         */
+        ModalUiPlane& activate(UnsignedInt id);
+
+        /**
+         * @brief Close a dialog
+         *
+         * Hides the plane and puts it into the recycling pool. Called from
+         * the dialog close button, can be called directly as well.
+         */
+        void hide(UnsignedInt id);
+
+        /**
+         * @brief Destroy closed dialogs over capacity
+         * @return Count of destroyed dialogs
+         *
+         * The ones closed longest ago are destroyed first. Expected to be
+         * called outside of UI event handling, for example once a frame.
+         */
+        std::size_t collect();
+
+        /** @brief Count of dialogs currently created */
+        std::size_t liveCount() const { return _liveCount; }
+
+        /** @brief Count of dialog planes created */
+        UnsignedLong createdCount() const { return _createdCount; }
+
+        /** @brief Count of activations that reused a created plane */
+        UnsignedLong recycledCount() const { return _recycledCount; }
+
+        /** @brief Count of dialog planes destroyed by @ref collect() */
+        UnsignedLong releasedCount() const { return _releasedCount; }
+
+    private:
+        /* Closed dialogs are ordered by the hide count at the time they
+           got closed */
+        struct Slot {
+            Ui::Style style;
+            bool visible;
+            UnsignedLong hiddenAt;
+            std::unique_ptr<ModalUiPlane> plane;
+        };
+
+        ModalUiPlane& create(UnsignedInt id);
+
+        Ui::UserInterface& _ui;
+        std::size_t _capacity;
+        std::vector<Slot> _slots;
+        std::size_t _liveCount{};
+        UnsignedLong _hideCount{}, _createdCount{}, _recycledCount{}, _releasedCount{};
+};
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "OneEuroFilter.h"
+
+#include <Magnum/Math/Constants.h>
+#include <Magnum/Math/Functions.h>
+
+namespace Magnum {
+
+namespace {
+
+/* Smoothing factor of an exponential low-pass filter with given cutoff
+   frequency and sample interval */
+Float smoothingFactor(const Float cutoff, const Float dt) {
+    const Float tau = 1.0f/(2.0f*Constants::pi()*cutoff);
+    return 1.0f/(1.0f + tau/dt);
+}
+
+}
+
+OneEuroFilter::OneEuroFilter(const Float minCutoff, const Float beta, const Float derivativeCutoff): _minCutoff{minCutoff}, _beta{beta}, _derivativeCutoff{derivativeCutoff}, _cutoff{minCutoff} {}
+
+const Vector3& OneEuroFilter::filter(const Vector3& value, const Double time) {
+    if(!_hasValue) {
+        _hasValue = true;
+        _time = time;
+        _value = value;
+        _velocity = {};
+        _cutoff = _minCutoff;
+        return _value;
+    }
+
+    const Float dt = Float(time - _time);
+    if(dt <= 0.0f) return _value;
+    _time = time;
+
+    const Float derivativeAlpha = smoothingFactor(_derivativeCutoff, dt);
+    _velocity = Math::lerp(_velocity, (value - _value)/dt, derivativeAlpha);
+
+    _cutoff = _minCutoff + _beta*_velocity.length();
+    _value = Math::lerp(_value, value, smoothingFactor(_cutoff, dt));
+    return _value;
+}
+
+void OneEuroFilter::reset() {
+    _hasValue = false;
+    _velocity = {};
+    _cutoff = _minCutoff;
+}
+
+}
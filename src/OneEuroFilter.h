@@ -0,0 +1,124 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_OneEuroFilter_h
+#define Magnum_VrUi_OneEuroFilter_h
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector3.h>
+
+namespace Magnum {
+
+/**
+@brief One Euro filter
+
+Adaptive low-pass filter for noisy positional input, as described in
+*1€ Filter: A Simple Speed-based Low-pass Filter for Noisy Input in
+Interactive Systems* by Casiez, Roussel and Vogel. The cutoff frequency
+rises with speed, so slow movements get heavily smoothed while fast
+movements stay responsive:
+
+@f[
+    f_c = f_{c_{min}} + \beta |\dot{\hat{x}}|
+@f]
+
+The speed is the magnitude of the 3D velocity, so all three axes share one
+cutoff.
+*/
+class OneEuroFilter {
+    public:
+        /**
+         * @brief Constructor
+         * @param minCutoff         Cutoff frequency at rest, in Hz
+         * @param beta              Cutoff increase per unit of speed, in
+         *      Hz per unit per second
+         * @param derivativeCutoff  Cutoff frequency of the velocity
+         *      estimate, in Hz
+         */
+        explicit OneEuroFilter(Float minCutoff, Float beta, Float derivativeCutoff);
+
+        /** @brief Cutoff frequency at rest */
+        Float minCutoff() const { return _minCutoff; }
+
+        /** @brief Set cutoff frequency at rest */
+        OneEuroFilter& setMinCutoff(Float cutoff) {
+            _minCutoff = cutoff;
+            return *this;
+        }
+
+        /** @brief Cutoff increase per unit of speed */
+        Float beta() const { return _beta; }
+
+        /** @brief Set cutoff increase per unit of speed */
+        OneEuroFilter& setBeta(Float beta) {
+            _beta = beta;
+            return *this;
+        }
+
+        /** @brief Cutoff frequency of the velocity estimate */
+        Float derivativeCutoff() const { return _derivativeCutoff; }
+
+        /** @brief Set cutoff frequency of the velocity estimate */
+        OneEuroFilter& setDerivativeCutoff(Float cutoff) {
+            _derivativeCutoff = cutoff;
+            return *this;
+        }
+
+        /**
+         * @brief Filter a sample
+         * @param value     Sample value
+         * @param time      Sample time, in seconds
+         *
+         * The first sample after construction or @ref reset() is passed
+         * through. Samples that are not newer than the previous one are
+         * ignored and the previous filtered value is returned.
+         */
+        const Vector3& filter(const Vector3& value, Double time);
+
+        /** @brief Whether the filter has any sample */
+        bool hasValue() const { return _hasValue; }
+
+        /** @brief Last filtered value */
+        const Vector3& value() const { return _value; }
+
+        /** @brief Last filtered velocity, in units per second */
+        const Vector3& velocity() const { return _velocity; }
+
+        /** @brief Cutoff frequency used for the last sample, in Hz */
+        Float cutoff() const { return _cutoff; }
+
+        /** @brief Discard filter state */
+        void reset();
+
+    private:
+        Float _minCutoff, _beta, _derivativeCutoff;
+        Float _cutoff;
+        bool _hasValue{};
+        Double _time{};
+        Vector3 _value, _velocity;
+};
+
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "OvrHmd.h"
+
+#include <array>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/OvrIntegration/Compositor.h>
+#include <Magnum/OvrIntegration/Context.h>
+#include <Magnum/OvrIntegration/Session.h>
+#include <OVR_CAPI.h>
+
+namespace Magnum {
+
+OvrHmd::OvrHmd(OvrIntegration::Context& context, OvrIntegration::Session& session): _context(context), _session(session) {
+    _session.configureRendering();
+
+    /* Setup compositor layers */
+    _layer = &_context.compositor().addLayerEyeFov();
+    _layer->setFov(_session)
+           .setHighQuality(true);
+}
+
+OvrHmd::~OvrHmd() = default;
+
+Vector2i OvrHmd::doEyeTextureSize(const Int eye) const {
+    return _session.fovTextureSize(eye);
+}
+
+Matrix4 OvrHmd::doProjectionMatrix(const Int eye, const Float near, const Float far) const {
+    return _session.projectionMatrix(eye, near, far);
+}
+
+void OvrHmd::doCreateEyeTarget(const Int target, const Vector2i& size) {
+    _textureSwapChain[target] = _session.createTextureSwapChain(size);
+}
+
+GL::Texture2D& OvrHmd::doActiveTexture(const Int target) {
+    return _textureSwapChain[target]->activeTexture();
+}
+
+void OvrHmd::doCommit(const Int target) {
+    _textureSwapChain[target]->commit();
+}
+
+void OvrHmd::doSetEyeViewport(const Int eye, const Int target, const Range2Di& viewport) {
+    _layer->setColorTexture(eye, *_textureSwapChain[target])
+           .setViewport(eye, viewport);
+}
+
+void OvrHmd::doWaitForFrame() {
+    /* The frame is ended with ovr_EndFrame() in endFrame() instead of
+       ovr_SubmitFrame(), which would wait for the boundary at the end of
+       the previous frame already and let hand and UI work done in between
+       age the poses */
+    ++_frameIndex;
+    ovrResult result = ovr_WaitToBeginFrame(_session.ovrSession(), _frameIndex);
+    if(OVR_SUCCESS(result))
+        result = ovr_BeginFrame(_session.ovrSession(), _frameIndex);
+    if(!OVR_SUCCESS(result))
+        Error() << "OvrHmd::waitForFrame(): beginning frame" << _frameIndex << "failed with" << result;
+}
+
+void OvrHmd::doPollPoses(DualQuaternion(&eyePoses)[2], DualQuaternion& headPose) {
+    const std::array<DualQuaternion, 2> poses = _session.pollEyePoses().eyePoses();
+    eyePoses[0] = poses[0];
+    eyePoses[1] = poses[1];
+    headPose = _session.headPoseState().pose();
+}
+
+void OvrHmd::doSubmitFrame() {
+    /* Set the layers eye poses to the poses chached in the _hmd. */
+    _layer->setRenderPoses(_session);
+
+    /* Let the libOVR sdk compositor do its magic! */
+    endFrame();
+}
+
+void OvrHmd::doResubmitFrame() {
+    /* The layer still has the render poses of the last submitted frame and
+       the swap chains their last committed textures, the compositor
+       reprojects them to the current head pose */
+    endFrame();
+}
+
+void OvrHmd::endFrame() {
+    const ovrLayerHeader* const layers[]{&_layer->layerHeader()};
+    const ovrResult result = ovr_EndFrame(_session.ovrSession(), _frameIndex, nullptr, layers, 1);
+    if(!OVR_SUCCESS(result))
+        Error() << "OvrHmd::submitFrame(): ending frame" << _frameIndex << "failed with" << result;
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_OvrHmd_h
+#define Magnum_VrUi_OvrHmd_h
+
+#include <memory>
+#include <Magnum/OvrIntegration/OvrIntegration.h>
+
+#include "AbstractHmd.h"
+
+namespace Magnum {
+
+/**
+@brief Oculus runtime HMD
+
+Renders into Oculus texture swap chains presented through a single
+@ref OvrIntegration::LayerEyeFov compositor layer. Expects that the GL
+context is already created.
+
+Frames are paced with @cpp ovr_WaitToBeginFrame() @ce and
+@cpp ovr_BeginFrame() @ce in @ref waitForFrame() and ended with
+@cpp ovr_EndFrame() @ce on submit, bypassing
+@ref OvrIntegration::Compositor::submitFrame(). Needs LibOVR 1.19 or newer.
+*/
+class OvrHmd: public AbstractHmd {
+    public:
+        explicit OvrHmd(OvrIntegration::Context& context, OvrIntegration::Session& session);
+
+        ~OvrHmd();
+
+        OvrIntegration::Session& session() { return _session; }
+
+    private:
+        Vector2i doEyeTextureSize(Int eye) const override;
+        Matrix4 doProjectionMatrix(Int eye, Float near, Float far) const override;
+        void doCreateEyeTarget(Int target, const Vector2i& size) override;
+        GL::Texture2D& doActiveTexture(Int target) override;
+        void doCommit(Int target) override;
+        void doSetEyeViewport(Int eye, Int target, const Range2Di& viewport) override;
+        void doWaitForFrame() override;
+        void doPollPoses(DualQuaternion(&eyePoses)[2], DualQuaternion& headPose) override;
+        void doSubmitFrame() override;
+        void doResubmitFrame() override;
+
+        void endFrame();
+
+        OvrIntegration::Context& _context;
+        OvrIntegration::Session& _session;
+        OvrIntegration::LayerEyeFov* _layer;
+        std::unique_ptr<OvrIntegration::TextureSwapChain> _textureSwapChain[2];
+        Long _frameIndex{};
+};
+
+}
+
+#endif
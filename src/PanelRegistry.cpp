@@ -0,0 +1,357 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "PanelRegistry.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+
+#include "StereoFrustum.h"
+
+namespace Magnum {
+
+namespace {
+
+/* Max depth of the hierarchy. With median splits it's roughly
+   log2(panelCount/LeafSize), so this is plenty. */
+constexpr UnsignedInt MaxDepth = 64;
+
+/* Keeps bounding boxes of axis-aligned panels from being flat, which would
+   make the ray slab test produce NaNs */
+constexpr Float BoundsPadding = 1.0e-4f;
+
+Range3D join(const Range3D& a, const Range3D& b) {
+    return {Math::min(a.min(), b.min()), Math::max(a.max(), b.max())};
+}
+
+}
+
+UnsignedInt PanelRegistry::add(const Matrix4& transformation, const Vector2i& pixelSize) {
+    Panel panel;
+    panel.transformation = transformation;
+    panel.pixelSize = pixelSize;
+    panel.visible = true;
+    updatePanel(panel);
+    _panels.push_back(panel);
+
+    _rebuild = true;
+    ++_changeCount;
+    return _panels.size() - 1;
+}
+
+PanelRegistry& PanelRegistry::setTransformation(const UnsignedInt id, const Matrix4& transformation) {
+    CORRADE_ASSERT(id < _panels.size(),
+        "PanelRegistry::setTransformation(): index" << id << "out of range for" << _panels.size() << "panels", *this);
+    _panels[id].transformation = transformation;
+    updatePanel(_panels[id]);
+    _refit = true;
+    ++_changeCount;
+    return *this;
+}
+
+PanelRegistry& PanelRegistry::setVisible(const UnsignedInt id, const bool visible) {
+    CORRADE_ASSERT(id < _panels.size(),
+        "PanelRegistry::setVisible(): index" << id << "out of range for" << _panels.size() << "panels", *this);
+    _panels[id].visible = visible;
+    ++_changeCount;
+    return *this;
+}
+
+void PanelRegistry::updatePanel(Panel& panel) {
+    const Matrix4& m = panel.transformation;
+    const Vector3 scaledX = m[0].xyz(), scaledY = m[1].xyz();
+    panel.origin = m.translation();
+    panel.halfSize = Vector2{scaledX.length(), scaledY.length()}*0.5f;
+    panel.axisX = scaledX/(panel.halfSize.x()*2.0f);
+    panel.axisY = scaledY/(panel.halfSize.y()*2.0f);
+    panel.normal = Math::cross(panel.axisX, panel.axisY).normalized();
+
+    const Vector3 extent = Math::abs(scaledX)*0.5f + Math::abs(scaledY)*0.5f + Vector3{BoundsPadding};
+    panel.bounds = {panel.origin - extent, panel.origin + extent};
+}
+
+void PanelRegistry::update() {
+    if(_rebuild) {
+        _order.resize(_panels.size());
+        for(UnsignedInt i = 0; i != _order.size(); ++i) _order[i] = i;
+
+        _nodes.clear();
+        _nodes.reserve(2*(_panels.size()/LeafSize + 1));
+        if(!_panels.empty()) build(0, _panels.size());
+
+    } else if(_refit) refit();
+
+    _rebuild = _refit = false;
+}
+
+UnsignedInt PanelRegistry::build(const UnsignedInt begin, const UnsignedInt end) {
+    const UnsignedInt index = _nodes.size();
+    _nodes.emplace_back();
+
+    Range3D bounds = _panels[_order[begin]].bounds;
+    Range3D centers{bounds.center(), bounds.center()};
+    for(UnsignedInt i = begin + 1; i != end; ++i) {
+        const Range3D& panelBounds = _panels[_order[i]].bounds;
+        bounds = join(bounds, panelBounds);
+        centers = join(centers, {panelBounds.center(), panelBounds.center()});
+    }
+    _nodes[index].bounds = bounds;
+
+    if(end - begin <= LeafSize) {
+        _nodes[index].first = begin;
+        _nodes[index].count = end - begin;
+        return index;
+    }
+
+    /* Split at the median along the axis the panels are most spread
+       along, which keeps the tree balanced even for clustered panels */
+    const Vector3 spread = centers.size();
+    const Int axis = spread.x() > spread.y() ?
+        (spread.x() > spread.z() ? 0 : 2) :
+        (spread.y() > spread.z() ? 1 : 2);
+    const UnsignedInt middle = begin + (end - begin)/2;
+    std::nth_element(_order.begin() + begin, _order.begin() + middle, _order.begin() + end,
+        [this, axis](UnsignedInt a, UnsignedInt b) {
+            return _panels[a].bounds.center()[axis] < _panels[b].bounds.center()[axis];
+        });
+
+    build(begin, middle);
+    const UnsignedInt right = build(middle, end);
+    _nodes[index].first = right;
+    _nodes[index].count = 0;
+    return index;
+}
+
+void PanelRegistry::refit() {
+    /* Children are always after their parent, so going backwards updates
+       them first */
+    for(std::size_t i = _nodes.size(); i != 0; --i) {
+        Node& node = _nodes[i - 1];
+        if(node.count) {
+            node.bounds = _panels[_order[node.first]].bounds;
+            for(UnsignedInt j = 1; j != node.count; ++j)
+                node.bounds = join(node.bounds, _panels[_order[node.first + j]].bounds);
+        } else node.bounds = join(_nodes[i].bounds, _nodes[node.first].bounds);
+    }
+}
+
+Vector2i PanelRegistry::pixelPosition(const Panel& panel, const Vector2& local) {
+    return {Int((local.x()/(panel.halfSize.x()*2.0f) + 0.5f)*panel.pixelSize.x()),
+            Int((-local.y()/(panel.halfSize.y()*2.0f) + 0.5f)*panel.pixelSize.y())};
+}
+
+Vector2i PanelRegistry::pixelPosition(const UnsignedInt id, const Vector2& local) const {
+    CORRADE_ASSERT(id < _panels.size(),
+        "PanelRegistry::pixelPosition(): index" << id << "out of range for" << _panels.size() << "panels", {});
+    return pixelPosition(_panels[id], local);
+}
+
+PanelRegistry::Hit PanelRegistry::hitAt(const Panel& panel, const Int id, const Vector3& local) {
+    Hit hit;
+    hit.panel = id;
+    hit.position = local;
+    hit.pixel = pixelPosition(panel, local.xy());
+    return hit;
+}
+
+PanelRegistry::Hit PanelRegistry::project(const UnsignedInt id, const Vector3& point) const {
+    CORRADE_ASSERT(id < _panels.size(),
+        "PanelRegistry::project(): index" << id << "out of range for" << _panels.size() << "panels", {});
+    const Panel& panel = _panels[id];
+    const Vector3 offset = point - panel.origin;
+    const Vector3 local{Math::dot(offset, panel.axisX),
+                        Math::dot(offset, panel.axisY),
+                        Math::dot(offset, panel.normal)};
+    Hit hit = hitAt(panel, id, local);
+    hit.distance = Math::abs(local.z());
+    return hit;
+}
+
+PanelRegistry::Hit PanelRegistry::querySphere(const Vector3& center, const Float radius) {
+    update();
+
+    Hit best;
+    if(_nodes.empty()) return best;
+
+    const Float radiusSquared = radius*radius;
+    UnsignedInt stack[MaxDepth];
+    UnsignedInt stackSize = 0;
+    stack[stackSize++] = 0;
+    while(stackSize) {
+        const UnsignedInt index = stack[--stackSize];
+        const Node& node = _nodes[index];
+        const Vector3 nearest = Math::min(Math::max(center, node.bounds.min()), node.bounds.max());
+        if((nearest - center).dot() > radiusSquared) continue;
+
+        if(!node.count) {
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = index + 1;
+            continue;
+        }
+
+        _panelTestCount += node.count;
+        for(UnsignedInt i = node.first; i != node.first + node.count; ++i) {
+            const UnsignedInt id = _order[i];
+            const Panel& panel = _panels[id];
+            if(!panel.visible) continue;
+
+            const Vector3 offset = center - panel.origin;
+            const Float distance = Math::abs(Math::dot(offset, panel.normal));
+            if(distance > radius || (best.panel != -1 && distance >= best.distance))
+                continue;
+
+            const Vector2 xy{Math::dot(offset, panel.axisX), Math::dot(offset, panel.axisY)};
+            if(Math::abs(xy.x()) > panel.halfSize.x() || Math::abs(xy.y()) > panel.halfSize.y())
+                continue;
+
+            best = hitAt(panel, id, {xy, Math::dot(offset, panel.normal)});
+            best.distance = distance;
+        }
+    }
+
+    return best;
+}
+
+void PanelRegistry::querySpheres(const Containers::ArrayView<const Vector3> centers, const Float radius, const Containers::ArrayView<Hit> hits) {
+    CORRADE_ASSERT(centers.size() == hits.size(),
+        "PanelRegistry::querySpheres(): expected" << centers.size() << "hits but got" << hits.size(), );
+    for(std::size_t i = 0; i != centers.size(); ++i)
+        hits[i] = querySphere(centers[i], radius);
+}
+
+PanelRegistry::Hit PanelRegistry::queryRay(const Vector3& origin, const Vector3& direction, const Float maxDistance) {
+    update();
+
+    Hit best;
+    best.distance = maxDistance;
+    if(_nodes.empty()) return best;
+
+    const Vector3 inverseDirection = 1.0f/direction;
+    UnsignedInt stack[MaxDepth];
+    UnsignedInt stackSize = 0;
+    stack[stackSize++] = 0;
+    while(stackSize) {
+        const UnsignedInt index = stack[--stackSize];
+        const Node& node = _nodes[index];
+
+        /* Slab test, pruned by the nearest hit so far */
+        const Vector3 t0 = (node.bounds.min() - origin)*inverseDirection;
+        const Vector3 t1 = (node.bounds.max() - origin)*inverseDirection;
+        const Float tNear = Math::max(Math::min(t0, t1).max(), 0.0f);
+        const Float tFar = Math::min(Math::max(t0, t1).min(), best.distance);
+        if(tNear > tFar) continue;
+
+        if(!node.count) {
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = index + 1;
+            continue;
+        }
+
+        _panelTestCount += node.count;
+        for(UnsignedInt i = node.first; i != node.first + node.count; ++i) {
+            const UnsignedInt id = _order[i];
+            const Panel& panel = _panels[id];
+            if(!panel.visible) continue;
+
+            const Float denominator = Math::dot(direction, panel.normal);
+            if(Math::abs(denominator) < 1.0e-6f) continue;
+
+            const Float t = Math::dot(panel.origin - origin, panel.normal)/denominator;
+            if(t < 0.0f || t > best.distance) continue;
+
+            const Vector3 offset = origin + direction*t - panel.origin;
+            const Vector2 xy{Math::dot(offset, panel.axisX), Math::dot(offset, panel.axisY)};
+            if(Math::abs(xy.x()) > panel.halfSize.x() || Math::abs(xy.y()) > panel.halfSize.y())
+                continue;
+
+            best = hitAt(panel, id, {xy, 0.0f});
+            best.distance = t;
+        }
+    }
+
+    if(best.panel == -1) best.distance = {};
+    return best;
+}
+
+UnsignedInt PanelRegistry::cull(const StereoFrustum& frustum, const Containers::ArrayView<UnsignedByte> eyeMasks) {
+    CORRADE_ASSERT(eyeMasks.size() == _panels.size(),
+        "PanelRegistry::cull(): expected" << _panels.size() << "eye masks but got" << eyeMasks.size(), {});
+    update();
+
+    _cullStats = {};
+    if(_nodes.empty()) return 0;
+    std::memset(eyeMasks.data(), 0, eyeMasks.size());
+
+    /* The second item is whether the node is known to be completely inside
+       the combined frustum */
+    std::pair<UnsignedInt, bool> stack[MaxDepth];
+    UnsignedInt stackSize = 0;
+    stack[stackSize++] = {0, false};
+    while(stackSize) {
+        const UnsignedInt index = stack[--stackSize].first;
+        bool inside = stack[stackSize].second;
+        const Node& node = _nodes[index];
+
+        if(!inside) {
+            ++_cullStats.nodesTested;
+            const StereoFrustum::Test test = frustum.test(node.bounds);
+            if(test == StereoFrustum::Test::Outside) continue;
+            inside = test == StereoFrustum::Test::Inside;
+        }
+
+        if(!node.count) {
+            stack[stackSize++] = {node.first, inside};
+            stack[stackSize++] = {index + 1, inside};
+            continue;
+        }
+
+        for(UnsignedInt i = node.first; i != node.first + node.count; ++i) {
+            const UnsignedInt id = _order[i];
+            const Panel& panel = _panels[id];
+            if(!panel.visible) continue;
+
+            if(!inside) {
+                ++_cullStats.panelsTested;
+                if(frustum.test(panel.bounds) == StereoFrustum::Test::Outside)
+                    continue;
+            }
+
+            /* Only the survivors get tested for each eye */
+            const UnsignedByte mask = frustum.eyeMask(panel.bounds);
+            eyeMasks[id] = mask;
+            if(!mask) continue;
+            ++_cullStats.visible;
+            if(mask != StereoFrustum::BothEyes) ++_cullStats.singleEye;
+        }
+    }
+
+    for(const Panel& panel: _panels) if(panel.visible) ++_cullStats.culled;
+    _cullStats.culled -= _cullStats.visible;
+    return _cullStats.visible;
+}
+
+}
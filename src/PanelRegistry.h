@@ -0,0 +1,284 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_PanelRegistry_h
+#define Magnum_VrUi_PanelRegistry_h
+
+#include <vector>
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
+
+namespace Magnum {
+
+class StereoFrustum;
+
+/**
+@brief World-space UI panel registry
+
+Keeps rectangular UI panels placed anywhere in the world and finds which of
+them a fingertip touches or points at. A panel is a unit square spanning
+@cpp [-0.5, 0.5] @ce in the XY plane, with Z being its normal, transformed
+by an arbitrary rotation, translation and non-uniform scaling. Shear is not
+supported. Hits are reported in panel-local coordinates in world units,
+with Z being the signed distance from the panel, and in UI screen pixels
+with the origin in the top left corner.
+
+Panels are kept in a bounding volume hierarchy over their world-space
+bounding boxes, so a query tests only the few panels near it instead of all
+of them. Changing a panel transformation only refits the bounding boxes,
+adding a panel rebuilds the hierarchy, both lazily on the next query.
+Hidden panels stay in the hierarchy and are skipped when tested.
+
+The same hierarchy culls the panels against a @ref StereoFrustum with
+@ref cull(). Subtrees completely inside the combined frustum of both eyes
+aren't tested against it further and only the surviving panels are tested
+against each eye.
+
+The class doesn't depend on rendering or the UI library, so it can be
+benchmarked on its own.
+
+@code{.cpp}
+PanelRegistry panels;
+UnsignedInt id = panels.add(Matrix4::translation({0.2f, -0.6f, -0.4f}), {1024, 1024});
+
+// every frame
+PanelRegistry::Hit hit = panels.querySphere(fingertip, 0.05f);
+if(hit.panel == Int(id)) ui.handleMoveEvent(hit.pixel);
+@endcode
+*/
+class PanelRegistry {
+    public:
+        /** @brief Max panel count in a leaf node */
+        enum: UnsignedInt { LeafSize = 4 };
+
+        /** @brief Query result */
+        struct Hit {
+            /** @brief Panel ID or @cpp -1 @ce if nothing was hit */
+            Int panel{-1};
+
+            /**
+             * @brief Panel-local position
+             *
+             * In world units, with Z being the signed distance from the
+             * panel along its normal.
+             */
+            Vector3 position;
+
+            /** @brief Position in UI screen pixels, Y down */
+            Vector2i pixel;
+
+            /**
+             * @brief Distance
+             *
+             * Absolute distance from the panel for sphere queries, distance
+             * along the ray for ray queries.
+             */
+            Float distance{};
+        };
+
+        /**
+         * @brief Culling statistics
+         *
+         * Of the last @ref cull() call.
+         */
+        struct CullStats {
+            /** @brief Count of hierarchy nodes tested */
+            UnsignedInt nodesTested;
+
+            /** @brief Count of panels tested against the combined frustum */
+            UnsignedInt panelsTested;
+
+            /** @brief Count of panels visible in at least one eye */
+            UnsignedInt visible;
+
+            /** @brief Count of panels visible in just one eye */
+            UnsignedInt singleEye;
+
+            /** @brief Count of visible panels culled away */
+            UnsignedInt culled;
+        };
+
+        /** @brief Add a panel */
+        UnsignedInt add(const Matrix4& transformation, const Vector2i& pixelSize);
+
+        /** @brief Panel count */
+        std::size_t panelCount() const { return _panels.size(); }
+
+        /** @brief Panel transformation */
+        const Matrix4& transformation(UnsignedInt id) const {
+            return _panels[id].transformation;
+        }
+
+        /**
+         * @brief Set panel transformation
+         *
+         * The hierarchy gets refit on the next query.
+         */
+        PanelRegistry& setTransformation(UnsignedInt id, const Matrix4& transformation);
+
+        /** @brief Panel size in UI screen pixels */
+        Vector2i pixelSize(UnsignedInt id) const { return _panels[id].pixelSize; }
+
+        /** @brief Panel size in world units */
+        Vector2 size(UnsignedInt id) const { return _panels[id].halfSize*2.0f; }
+
+        /** @brief World-space bounding box of the panel */
+        const Range3D& bounds(UnsignedInt id) const { return _panels[id].bounds; }
+
+        /** @brief Whether the panel is visible */
+        bool isVisible(UnsignedInt id) const { return _panels[id].visible; }
+
+        /**
+         * @brief Set panel visibility
+         *
+         * Hidden panels are never hit. Visible by default.
+         */
+        PanelRegistry& setVisible(UnsignedInt id, bool visible);
+
+        /**
+         * @brief Count of panel changes
+         *
+         * Incremented on every @ref add(), @ref setTransformation() and
+         * @ref setVisible(), so users can tell whether anything changed
+         * since they last looked.
+         */
+        UnsignedLong changeCount() const { return _changeCount; }
+
+        /**
+         * @brief Update the hierarchy
+         *
+         * Rebuilds or refits the hierarchy if any panel was added or moved
+         * since the last update. Called implicitly by all queries.
+         */
+        void update();
+
+        /** @brief Node count of the hierarchy after last @ref update() */
+        std::size_t nodeCount() const { return _nodes.size(); }
+
+        /**
+         * @brief Count of panels tested so far
+         *
+         * Summed over all queries, useful to see how much the hierarchy
+         * prunes.
+         */
+        UnsignedLong panelTestCount() const { return _panelTestCount; }
+
+        /**
+         * @brief Convert a panel-local position to UI screen pixels
+         *
+         * The X and Y coordinates of @ref Hit::position map to
+         * @ref Hit::pixel this way.
+         */
+        Vector2i pixelPosition(UnsignedInt id, const Vector2& local) const;
+
+        /**
+         * @brief Project a point onto a panel
+         *
+         * Returns the hit regardless of whether the point is above the
+         * panel rectangle or how far from it it is. Useful to keep
+         * following a fingertip on a panel it's pressing.
+         */
+        Hit project(UnsignedInt id, const Vector3& point) const;
+
+        /**
+         * @brief Find the panel nearest to a sphere
+         *
+         * Returns the visible panel with the smallest distance from
+         * @p center that is at most @p radius and has @p center above its
+         * rectangle.
+         */
+        Hit querySphere(const Vector3& center, Float radius);
+
+        /**
+         * @brief Find panels nearest to a batch of spheres
+         *
+         * Same as calling @ref querySphere() for each of @p centers, with
+         * results written to @p hits of the same size.
+         */
+        void querySpheres(Containers::ArrayView<const Vector3> centers, Float radius, Containers::ArrayView<Hit> hits);
+
+        /**
+         * @brief Find the first panel hit by a ray
+         * @param origin        Ray origin
+         * @param direction     Normalized ray direction
+         * @param maxDistance   Max distance along the ray
+         *
+         * Panels are hit from both sides.
+         */
+        Hit queryRay(const Vector3& origin, const Vector3& direction, Float maxDistance);
+
+        /**
+         * @brief Cull panels against a stereo frustum
+         * @param frustum   Frustum to cull against
+         * @param eyeMasks  Where to write a combination of
+         *      @ref StereoFrustum::LeftEye and @ref StereoFrustum::RightEye
+         *      bits for each panel, expected to have @ref panelCount()
+         *      items
+         * @return Count of panels visible in at least one eye
+         *
+         * Hidden panels get an empty mask.
+         */
+        UnsignedInt cull(const StereoFrustum& frustum, Containers::ArrayView<UnsignedByte> eyeMasks);
+
+        /** @brief Statistics of the last @ref cull() */
+        const CullStats& cullStats() const { return _cullStats; }
+
+    private:
+        struct Panel {
+            Matrix4 transformation;
+            Vector3 origin, axisX, axisY, normal;
+            Vector2 halfSize;
+            Vector2i pixelSize;
+            Range3D bounds;
+            bool visible;
+        };
+
+        /* Inner nodes have the left child right after them and the right
+           child at first, leaves have panels first to first + count in
+           _order. Children always come after their parent. */
+        struct Node {
+            Range3D bounds;
+            UnsignedInt first, count;
+        };
+
+        static void updatePanel(Panel& panel);
+        UnsignedInt build(UnsignedInt begin, UnsignedInt end);
+        void refit();
+        static Vector2i pixelPosition(const Panel& panel, const Vector2& local);
+        static Hit hitAt(const Panel& panel, Int id, const Vector3& local);
+
+        std::vector<Panel> _panels;
+        std::vector<Node> _nodes;
+        std::vector<UnsignedInt> _order;
+        bool _rebuild{}, _refit{};
+        UnsignedLong _changeCount{};
+        UnsignedLong _panelTestCount{};
+        CullStats _cullStats{};
+};
+
+}
+
+#endif
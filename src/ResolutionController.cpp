@@ -0,0 +1,130 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "ResolutionController.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+
+namespace Magnum {
+
+namespace {
+
+/* Frames over or under budget in a row before the scale changes. Going down
+   is fast to not drop frames, going up slow to not bounce right back. */
+constexpr const UnsignedInt DecreaseFrames{3};
+constexpr const UnsignedInt IncreaseFrames{45};
+
+/* Scale steps along each axis. Pixel count goes with square of the scale,
+   so the steps are small. */
+constexpr const Float DecreaseStep{0.1f};
+constexpr const Float IncreaseStep{0.05f};
+
+/* Smoothing factor of the measured frame time */
+constexpr const Float Smoothing{0.25f};
+
+}
+
+constexpr Float ResolutionController::DecreaseThreshold;
+constexpr Float ResolutionController::IncreaseThreshold;
+
+ResolutionController::ResolutionController() = default;
+
+ResolutionController::~ResolutionController() = default;
+
+ResolutionController& ResolutionController::setScaleRange(const Float min, const Float max) {
+    CORRADE_ASSERT(min > 0.0f && min <= max && max <= 1.0f,
+        "ResolutionController::setScaleRange(): expected 0 < min <= max <= 1 but got" << min << "and" << max, *this);
+    _minScale = min;
+    _maxScale = max;
+
+    const Float scale = Math::clamp(_scale, min, max);
+    _scaleChanged = scale != _scale;
+    _scale = scale;
+    return *this;
+}
+
+ResolutionController& ResolutionController::setTargetFrameTime(const Float milliseconds) {
+    _targetFrameTime = milliseconds;
+    return *this;
+}
+
+void ResolutionController::beginFrame() {
+    if(!isEnabled()) return;
+
+    if(!_queries[0].id())
+        for(GL::TimeQuery& query: _queries)
+            query = GL::TimeQuery{GL::TimeQuery::Target::TimeElapsed};
+
+    _queries[_frameCount % QueryLatency].begin();
+    _inFrame = true;
+}
+
+void ResolutionController::endFrame() {
+    _scaleChanged = false;
+    if(!_inFrame) return;
+
+    _queries[_frameCount % QueryLatency].end();
+    _inFrame = false;
+    ++_frameCount;
+
+    /* The next frame is going to reuse the query of the oldest frame in
+       flight, get its result. Skip it instead of stalling if the GPU is
+       that much behind. */
+    GL::TimeQuery& query = _queries[_frameCount % QueryLatency];
+    if(_frameCount >= QueryLatency && query.resultAvailable())
+        update(query.result<UnsignedLong>()/1.0e6f);
+}
+
+void ResolutionController::update(const Float gpuFrameTime) {
+    _scaleChanged = false;
+    _gpuFrameTime = _gpuFrameTime != 0.0f ? Math::lerp(_gpuFrameTime, gpuFrameTime, Smoothing) : gpuFrameTime;
+
+    /* Frames still in flight were rendered with the previous scale */
+    if(_settleFrames) {
+        --_settleFrames;
+        return;
+    }
+
+    if(_gpuFrameTime > _targetFrameTime*DecreaseThreshold) {
+        _underBudgetFrames = 0;
+        if(++_overBudgetFrames < DecreaseFrames || _scale == _minScale) return;
+        _scale = Math::max(_scale - DecreaseStep, _minScale);
+    } else if(_gpuFrameTime < _targetFrameTime*IncreaseThreshold) {
+        _overBudgetFrames = 0;
+        if(++_underBudgetFrames < IncreaseFrames || _scale == _maxScale) return;
+        _scale = Math::min(_scale + IncreaseStep, _maxScale);
+    } else {
+        _overBudgetFrames = _underBudgetFrames = 0;
+        return;
+    }
+
+    _overBudgetFrames = _underBudgetFrames = 0;
+    _settleFrames = QueryLatency;
+    /* Forget the old time, it was measured at a different resolution */
+    _gpuFrameTime = 0.0f;
+    _scaleChanged = true;
+}
+
+}
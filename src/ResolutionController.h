@@ -0,0 +1,160 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_ResolutionController_h
+#define Magnum_VrUi_ResolutionController_h
+
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/TimeQuery.h>
+
+namespace Magnum {
+
+/**
+@brief Adaptive eye buffer resolution controller
+
+Measures GPU time of the frame with GL time queries and picks a scale of the
+rendered eye viewport so the frame fits into a target frame time. The eye
+textures are allocated for the full resolution, the scale only shrinks the
+part of them that gets rendered into and shown by the compositor.
+
+To avoid oscillating, the measured time is smoothed and the scale follows
+with hysteresis: it goes down quickly once the frame is over
+@ref DecreaseThreshold of the target for a few frames in a row, but goes up
+slowly and only after the frame has been below @ref IncreaseThreshold of the
+target for a longer time. After every change the controller waits until
+frames rendered with the new scale get measured. Query results are read back
+@ref QueryLatency frames later to not stall the pipeline.
+
+@code{.cpp}
+controller.beginFrame();
+// render both eyes
+controller.endFrame();
+
+if(controller.scaleChanged()) resizeViewports(controller.scale());
+@endcode
+*/
+class ResolutionController {
+    public:
+        enum: std::size_t {
+            /** Count of frames after which GPU times are read back */
+            QueryLatency = 4
+        };
+
+        /** @brief Fraction of the target frame time above which the scale decreases */
+        static constexpr Float DecreaseThreshold = 0.9f;
+
+        /** @brief Fraction of the target frame time below which the scale increases */
+        static constexpr Float IncreaseThreshold = 0.7f;
+
+        /**
+         * @brief Constructor
+         *
+         * The scale is fixed to @cpp 1.0f @ce by default and the target
+         * frame time is @cpp 11.1f @ce ms, which is one frame at 90 Hz. GL
+         * queries are created on the first @ref beginFrame(), so a GL
+         * context is expected to be current then.
+         */
+        explicit ResolutionController();
+
+        ~ResolutionController();
+
+        /** @brief Min scale */
+        Float minScale() const { return _minScale; }
+
+        /** @brief Max scale */
+        Float maxScale() const { return _maxScale; }
+
+        /**
+         * @brief Set scale range
+         *
+         * The scale is a factor of the full eye texture size along each
+         * axis. Expects that @cpp 0 < min <= max <= 1 @ce. If both are the
+         * same, the scale is fixed and GPU time is not measured. The
+         * current scale gets clamped to the new range.
+         */
+        ResolutionController& setScaleRange(Float min, Float max);
+
+        /** @brief Target frame time, in milliseconds */
+        Float targetFrameTime() const { return _targetFrameTime; }
+
+        /** @brief Set target frame time, in milliseconds */
+        ResolutionController& setTargetFrameTime(Float milliseconds);
+
+        /** @brief Whether the scale is adapted at all */
+        bool isEnabled() const { return _minScale != _maxScale; }
+
+        /** @brief Current scale */
+        Float scale() const { return _scale; }
+
+        /**
+         * @brief Whether the scale changed in the last @ref endFrame()
+         *
+         * Also @cpp true @ce after @ref setScaleRange() clamped the current
+         * scale.
+         */
+        bool scaleChanged() const { return _scaleChanged; }
+
+        /** @brief Smoothed GPU frame time, in milliseconds */
+        Float gpuFrameTime() const { return _gpuFrameTime; }
+
+        /**
+         * @brief Begin measuring a frame
+         *
+         * Does nothing if not @ref isEnabled().
+         */
+        void beginFrame();
+
+        /**
+         * @brief End measuring a frame
+         *
+         * Reads back the GPU time of the frame from @ref QueryLatency frames
+         * ago, if available, and passes it to @ref update(). Does nothing if
+         * not @ref isEnabled().
+         */
+        void endFrame();
+
+        /**
+         * @brief Update the scale with a GPU frame time
+         *
+         * In milliseconds. Called from @ref endFrame(), useful directly for
+         * feeding in times from elsewhere.
+         */
+        void update(Float gpuFrameTime);
+
+    private:
+        Float _minScale{1.0f}, _maxScale{1.0f};
+        Float _targetFrameTime{11.1f};
+        Float _scale{1.0f};
+        Float _gpuFrameTime{};
+        bool _scaleChanged{}, _inFrame{};
+        UnsignedInt _overBudgetFrames{}, _underBudgetFrames{}, _settleFrames{};
+        UnsignedLong _frameCount{};
+        GL::TimeQuery _queries[QueryLatency]{
+            GL::TimeQuery{NoCreate}, GL::TimeQuery{NoCreate},
+            GL::TimeQuery{NoCreate}, GL::TimeQuery{NoCreate}};
+};
+
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include "SharedMemory.h"
+
+#include <Corrade/Utility/Debug.h>
+
+#ifdef CORRADE_TARGET_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Magnum {
+
+#ifdef CORRADE_TARGET_WINDOWS
+SharedMemory::SharedMemory(const std::string& name, const Mode mode, const std::size_t size): _name{"Local\\" + name}, _mode{mode} {
+    if(mode == Mode::Create) {
+        _handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+            DWORD(UnsignedLong(size) >> 32), DWORD(size & 0xffffffffu), _name.data());
+        if(!_handle) {
+            Error() << "SharedMemory: can't create" << _name << "with error" << GetLastError();
+            return;
+        }
+        _data = static_cast<char*>(MapViewOfFile(_handle, FILE_MAP_ALL_ACCESS, 0, 0, size));
+        _size = size;
+    } else {
+        _handle = OpenFileMappingA(FILE_MAP_READ, FALSE, _name.data());
+        if(!_handle) return;
+        _data = static_cast<char*>(MapViewOfFile(_handle, FILE_MAP_READ, 0, 0, 0));
+
+        /* The view size is rounded up to whole pages, the users check
+           their own headers anyway */
+        MEMORY_BASIC_INFORMATION info;
+        if(_data && VirtualQuery(_data, &info, sizeof(info))) _size = info.RegionSize;
+    }
+
+    if(!_data) {
+        Error() << "SharedMemory: can't map" << _name << "with error" << GetLastError();
+        CloseHandle(_handle);
+        _handle = nullptr;
+        _size = 0;
+    }
+}
+
+SharedMemory::~SharedMemory() {
+    if(_data) UnmapViewOfFile(_data);
+    if(_handle) CloseHandle(_handle);
+}
+#else
+SharedMemory::SharedMemory(const std::string& name, const Mode mode, const std::size_t size): _name{"/" + name}, _mode{mode} {
+    const int fd = mode == Mode::Create ?
+        shm_open(_name.data(), O_RDWR|O_CREAT|O_TRUNC, 0644) :
+        shm_open(_name.data(), O_RDONLY, 0);
+    if(fd == -1) {
+        /* A reader can be started before the writer, that's not an error */
+        if(mode == Mode::Create) Error() << "SharedMemory: can't create" << _name;
+        return;
+    }
+
+    std::size_t mappedSize = size;
+    if(mode == Mode::Create) {
+        if(ftruncate(fd, off_t(size)) != 0) {
+            Error() << "SharedMemory: can't resize" << _name << "to" << size << "bytes";
+            close(fd);
+            shm_unlink(_name.data());
+            return;
+        }
+    } else {
+        struct stat info;
+        if(fstat(fd, &info) != 0 || info.st_size <= 0) {
+            close(fd);
+            return;
+        }
+        mappedSize = std::size_t(info.st_size);
+    }
+
+    void* const data = mmap(nullptr, mappedSize, mode == Mode::Create ? PROT_READ|PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+
+    /* The mapping stays valid after the descriptor is closed */
+    close(fd);
+    if(data == MAP_FAILED) {
+        Error() << "SharedMemory: can't map" << _name;
+        if(mode == Mode::Create) shm_unlink(_name.data());
+        return;
+    }
+
+    _data = static_cast<char*>(data);
+    _size = mappedSize;
+}
+
+SharedMemory::~SharedMemory() {
+    if(!_data) return;
+    munmap(_data, _size);
+    if(_mode == Mode::Create) shm_unlink(_name.data());
+}
+#endif
+
+}
@@ -0,0 +1,95 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef Magnum_VrUi_SharedMemory_h
+#define Magnum_VrUi_SharedMemory_h
+
+#include <string>
+#include <Magnum/Magnum.h>
+
+namespace Magnum {
+
+/**
+@brief Named shared memory region
+
+A memory region other processes on the same machine can map by name, backed
+by POSIX shared memory or by a Windows file mapping. The creating process
+maps it for writing, other processes open it read-only. On POSIX systems
+the name is removed again when the creating instance is destroyed, processes
+that still have it mapped keep their mapping.
+*/
+class SharedMemory {
+    public:
+        /** @brief Open mode */
+        enum class Mode: UnsignedByte {
+            /** Create the region, replacing any existing one, read-write */
+            Create,
+            /** Open an existing region read-only */
+            ReadOnly
+        };
+
+        /**
+         * @brief Constructor
+         * @param name      Region name, without any platform-specific prefix
+         * @param mode      Open mode
+         * @param size      Region size for @ref Mode::Create, ignored
+         *      otherwise
+         *
+         * A newly created region is zero-filled. Check @ref isOpen() for
+         * success.
+         */
+        explicit SharedMemory(const std::string& name, Mode mode, std::size_t size = 0);
+
+        /** @brief Copying is not allowed */
+        SharedMemory(const SharedMemory&) = delete;
+
+        ~SharedMemory();
+
+        /** @brief Copying is not allowed */
+        SharedMemory& operator=(const SharedMemory&) = delete;
+
+        /** @brief Whether the region is mapped */
+        bool isOpen() const { return _data; }
+
+        /** @brief Mapped memory */
+        char* data() { return _data; }
+        const char* data() const { return _data; } /**< @overload */
+
+        /** @brief Mapped size */
+        std::size_t size() const { return _size; }
+
+    private:
+        std::string _name;
+        Mode _mode;
+        char* _data{};
+        std::size_t _size{};
+        #ifdef CORRADE_TARGET_WINDOWS
+        void* _handle{};
+        #endif
+};
+
+}
+
+#endif
@@ -0,0 +1,146 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef Magnum_VrUi_SharedTelemetry_h
+#define Magnum_VrUi_SharedTelemetry_h
+
+#include <atomic>
+#include <cstddef>
+#include <Magnum/Magnum.h>
+
+#include "HandSnapshot.h"
+
+namespace Magnum { namespace SharedTelemetry {
+
+/**
+@brief Shared telemetry memory layout
+
+Per-frame telemetry exported by @ref TelemetryExporter into a named
+@ref SharedMemory region and read by @ref TelemetryReader from other
+processes. The region starts with a @ref Header, followed by
+@ref Header::capacity slots, each being a @ref Slot with one @ref Frame
+record. Frame @cpp n @ce is written into slot @cpp n % capacity @ce, the
+capacity is a power of two.
+
+Each slot is guarded by a sequence lock: before writing frame @cpp n @ce,
+the writer sets @ref Slot::sequence to @cpp 2*n + 1 @ce, and to
+@cpp 2*n + 2 @ce after the frame is complete, then increments
+@ref Header::writeCount. A reader can use the frame in place if the
+sequence is @cpp 2*n + 2 @ce both before and after reading it, otherwise
+the frame was overwritten in the meantime. The writer never waits for
+readers, readers that fall behind by more than the capacity lose frames.
+
+All values are in native byte order. Timestamps are of the steady clock in
+nanoseconds, which on common platforms is the same for all processes.
+*/
+struct Header {
+    /** @cpp "MVRUITEL" @ce, written last after everything else is set */
+    char magic[8];
+    UnsignedInt version;
+    /** Size of a @ref Slot, in bytes */
+    UnsignedInt slotSize;
+    /** Slot count, a power of two */
+    UnsignedInt capacity;
+    UnsignedInt reserved;
+    /** Count of frames written so far */
+    std::atomic<UnsignedLong> writeCount;
+    UnsignedLong reserved2[4];
+};
+
+enum: UnsignedInt { Version = 1 };
+
+/** @brief Region name used by the gallery and tools by default */
+constexpr const char DefaultName[] = "magnum-vr-ui-telemetry";
+
+/** @brief Frame flag */
+enum: UnsignedInt {
+    /** Hand tracking delivered a frame */
+    HandsTracked = 1 << 0,
+    /** Eyes weren't rendered, the previous frame got resubmitted */
+    FrameReused = 1 << 1
+};
+
+/** @brief Per-frame record */
+struct Frame {
+    /** Gallery frame index */
+    UnsignedLong frameIndex;
+    /** Steady clock time at submit, in nanoseconds */
+    UnsignedLong timestamp;
+    /** Hand tracking timestamp, in microseconds of the tracking clock */
+    UnsignedLong handTimestamp;
+
+    /** Head pose, dual quaternion as real XYZW followed by dual XYZW */
+    Float headPose[8];
+    /** Left and right eye pose, same as @ref headPose */
+    Float eyePoses[2][8];
+
+    /** CPU time from the frame boundary to submit, in microseconds */
+    UnsignedInt cpuTime;
+    /** Age of the rendered head pose at submit, in microseconds */
+    UnsignedInt poseAge;
+    UnsignedInt drawCalls;
+    /** Not measured, see @ref Gallery::FrameStats */
+    UnsignedInt estimatedStateChanges;
+    Float resolutionScale;
+    /** Combination of @ref HandsTracked and @ref FrameReused */
+    UnsignedInt flags;
+
+    /** Touched panel of the right and left hand, @cpp -1 @ce if none */
+    Int touchPanel[2];
+    /** Touch event of the right and left hand, see @ref FingertipTouch::Event */
+    UnsignedInt touchEvent[2];
+    /** Filtered touch position in panel space of the right and left hand */
+    Float touchPosition[2][3];
+
+    UnsignedInt handCount;
+    UnsignedInt jointCount;
+    /** Bit @cpp i @ce is set if hand @cpp i @ce is a right hand */
+    UnsignedInt rightHandMask;
+    UnsignedInt reserved;
+    /** Hand index of each joint, only the first @ref jointCount are valid */
+    UnsignedByte jointHand[HandSnapshot::MaxJoints];
+    UnsignedByte padding[2];
+    /** Joint positions in tracking space, in millimeters */
+    Float joints[HandSnapshot::MaxJoints][3];
+};
+
+/** @brief Ring buffer slot */
+struct Slot {
+    /** Sequence lock, see @ref Header */
+    std::atomic<UnsignedLong> sequence;
+    Frame frame;
+};
+
+static_assert(sizeof(Header) == 64 && sizeof(Frame) == 800 && sizeof(Slot) == 808, "unexpected padding in shared telemetry layout");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "64-bit atomics need to be lock-free to work across processes");
+
+/** @brief Size of a region with given slot count */
+constexpr std::size_t regionSize(UnsignedInt capacity) {
+    return sizeof(Header) + capacity*sizeof(Slot);
+}
+
+}}
+
+#endif
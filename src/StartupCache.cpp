@@ -0,0 +1,237 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "StartupCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/OpenGL.h>
+#include <Magnum/GL/Version.h>
+
+namespace Magnum {
+
+namespace {
+
+constexpr const char Magic[8]{'V', 'R', 'U', 'I', 'C', 'A', 'C', 'H'};
+
+constexpr std::size_t padded(const std::size_t size) {
+    return (size + 7) & ~std::size_t(7);
+}
+
+/* FNV-1a, good enough to tell drivers and shader sources apart */
+constexpr const UnsignedLong FnvOffset{14695981039346656037ull};
+
+UnsignedLong hash(UnsignedLong value, const std::string& string) {
+    for(const char c: string) {
+        value ^= UnsignedByte(c);
+        value *= 1099511628211ull;
+    }
+    return value;
+}
+
+/* Program binary blobs start with the binary format */
+struct ProgramHeader {
+    UnsignedInt format;
+    UnsignedInt reserved;
+};
+
+}
+
+std::string StartupCache::programName(const std::string& name, const std::string& source) {
+    char digest[17];
+    std::snprintf(digest, sizeof(digest), "%016llx", static_cast<unsigned long long>(hash(FnvOffset, source)));
+    return name + '@' + digest;
+}
+
+StartupCache::StartupCache(std::string filename): _filename{std::move(filename)} {
+    GL::Context& context = GL::Context::current();
+    _contextHash = hash(hash(hash(FnvOffset, context.vendorString()), context.rendererString()), context.versionString());
+
+    GLint formatCount{};
+    if(context.isVersionSupported(GL::Version::GL410) || context.isExtensionSupported<GL::Extensions::ARB::get_program_binary>())
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    _programBinarySupported = formatCount > 0;
+
+    if(!Utility::Directory::fileExists(_filename)) return;
+
+    Containers::Array<const char, Utility::Directory::MapDeleter> data = Utility::Directory::mapRead(_filename);
+    if(data.size() < sizeof(FileHeader)) {
+        Warning() << "StartupCache: ignoring invalid cache file" << _filename;
+        return;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, data.data(), sizeof(FileHeader));
+    if(std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version || header.contextHash != _contextHash) {
+        Warning() << "StartupCache: ignoring cache file" << _filename << "made by a different version or GL driver";
+        return;
+    }
+
+    /* Validate all entries upfront, a truncated one invalidates the whole
+       file as it's most likely a crash during write */
+    std::vector<Entry> entries;
+    entries.reserve(header.entryCount);
+    std::size_t offset = sizeof(FileHeader);
+    for(UnsignedInt i = 0; i != header.entryCount; ++i) {
+        EntryHeader entry;
+        if(data.size() - offset < sizeof(EntryHeader)) break;
+        std::memcpy(&entry, data + offset, sizeof(EntryHeader));
+        offset += sizeof(EntryHeader);
+
+        if(data.size() - offset < padded(entry.nameSize) + padded(entry.dataSize)) break;
+        entries.push_back({std::string(data + offset, entry.nameSize),
+            data.slice(offset + padded(entry.nameSize), offset + padded(entry.nameSize) + entry.dataSize), nullptr});
+        offset += padded(entry.nameSize) + padded(entry.dataSize);
+    }
+
+    if(entries.size() != header.entryCount) {
+        Warning() << "StartupCache: ignoring truncated cache file" << _filename;
+        return;
+    }
+
+    _entries = std::move(entries);
+    _data = std::move(data);
+    _loaded = true;
+}
+
+StartupCache::~StartupCache() = default;
+
+StartupCache::Entry* StartupCache::find(const std::string& name) {
+    for(Entry& entry: _entries)
+        if(entry.name == name) return &entry;
+    return nullptr;
+}
+
+Containers::ArrayView<const char> StartupCache::get(const std::string& name) {
+    if(Entry* entry = find(name)) {
+        ++_hitCount;
+        return entry->data;
+    }
+
+    ++_missCount;
+    return nullptr;
+}
+
+StartupCache& StartupCache::set(const std::string& name, const Containers::ArrayView<const char> data) {
+    Entry* entry = find(name);
+    if(!entry) {
+        _entries.push_back({name, nullptr, nullptr});
+        entry = &_entries.back();
+    }
+
+    entry->owned = Containers::Array<char>{Containers::NoInit, data.size()};
+    std::memcpy(entry->owned.data(), data.data(), data.size());
+    entry->data = entry->owned;
+    _changed = true;
+    return *this;
+}
+
+bool StartupCache::loadProgram(const std::string& name, const GLuint program) {
+    Entry* entry = _programBinarySupported ? find(name) : nullptr;
+    if(!entry || entry->data.size() < sizeof(ProgramHeader)) {
+        ++_missCount;
+        return false;
+    }
+
+    ProgramHeader header;
+    std::memcpy(&header, entry->data.data(), sizeof(ProgramHeader));
+    glProgramBinary(program, header.format, entry->data + sizeof(ProgramHeader), entry->data.size() - sizeof(ProgramHeader));
+
+    /* The driver is free to reject the binary even with a matching context
+       hash, for example after a silent update */
+    GLint linked{};
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if(!linked) {
+        ++_missCount;
+        return false;
+    }
+
+    ++_hitCount;
+    return true;
+}
+
+void StartupCache::prepareProgram(const GLuint program) {
+    if(_programBinarySupported)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void StartupCache::saveProgram(const std::string& name, const GLuint program) {
+    if(!_programBinarySupported) return;
+
+    GLint size{};
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+    if(!size) return;
+
+    Containers::Array<char> data{Containers::NoInit, sizeof(ProgramHeader) + size};
+    ProgramHeader header{};
+    GLenum format;
+    glGetProgramBinary(program, size, nullptr, &format, data + sizeof(ProgramHeader));
+    header.format = format;
+    std::memcpy(data.data(), &header, sizeof(ProgramHeader));
+    set(name, data);
+}
+
+bool StartupCache::save() {
+    std::size_t size = sizeof(FileHeader);
+    for(const Entry& entry: _entries)
+        size += sizeof(EntryHeader) + padded(entry.name.size()) + padded(entry.data.size());
+
+    Containers::Array<char> out{Containers::ValueInit, size};
+    FileHeader header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.entryCount = _entries.size();
+    header.contextHash = _contextHash;
+    std::memcpy(out.data(), &header, sizeof(FileHeader));
+
+    /* Entries now point into the new buffer, so the file can be unmapped */
+    std::size_t offset = sizeof(FileHeader);
+    for(Entry& entry: _entries) {
+        const EntryHeader entryHeader{UnsignedInt(entry.name.size()), 0, entry.data.size()};
+        std::memcpy(out + offset, &entryHeader, sizeof(EntryHeader));
+        offset += sizeof(EntryHeader);
+        std::memcpy(out + offset, entry.name.data(), entry.name.size());
+        offset += padded(entry.name.size());
+        std::memcpy(out + offset, entry.data.data(), entry.data.size());
+        entry.data = out.slice(offset, offset + entry.data.size());
+        entry.owned = nullptr;
+        offset += padded(entry.data.size());
+    }
+
+    _data = nullptr;
+    _storage = std::move(out);
+    _changed = false;
+
+    if(!Utility::Directory::write(_filename, _storage)) {
+        Error() << "StartupCache: can't write" << _filename;
+        return false;
+    }
+
+    return true;
+}
+
+}
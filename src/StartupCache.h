@@ -0,0 +1,195 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_StartupCache_h
+#define Magnum_VrUi_StartupCache_h
+
+#include <string>
+#include <vector>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/GL.h>
+
+namespace Magnum {
+
+/**
+@brief On-disk cache of startup data
+
+Keeps named binary blobs --- preprocessed mesh data and GL program binaries
+--- in a single versioned file, so the next launch can skip generating the
+meshes and compiling the shaders. The file is memory-mapped and blobs are
+returned as views into it, so they can be uploaded to the GPU without any
+copy.
+
+The file starts with a @ref FileHeader, followed by entries. Each entry is
+an @ref EntryHeader, the name and the data, both padded to a multiple of 8
+bytes. The header contains a hash of the GL vendor, renderer and version
+strings, if it doesn't match the current context or @ref Version doesn't
+match, the whole file is ignored and gets rewritten on @ref save().
+
+@code{.cpp}
+StartupCache cache{"startup.cache"};
+Gallery gallery{hmd, std::move(handSource), Gallery::Configuration{}
+    .setStartupCache(&cache)};
+
+// after the first frame
+if(cache.hasChanged()) cache.save();
+@endcode
+*/
+class StartupCache {
+    public:
+        /** @brief File header */
+        struct FileHeader {
+            char magic[8];
+            UnsignedInt version;
+            UnsignedInt entryCount;
+            UnsignedLong contextHash;
+        };
+
+        /** @brief Entry header */
+        struct EntryHeader {
+            UnsignedInt nameSize;
+            UnsignedInt reserved;
+            UnsignedLong dataSize;
+        };
+
+        enum: UnsignedInt { Version = 1 };
+
+        /**
+         * @brief Blob name of a program
+         *
+         * Combines @p name with a hash of @p source, so a program gets
+         * recompiled when its sources change.
+         */
+        static std::string programName(const std::string& name, const std::string& source);
+
+        /**
+         * @brief Constructor
+         *
+         * Maps @p filename if it exists and is a valid cache for the
+         * current GL context, otherwise starts empty. Expects that a GL
+         * context is created and current.
+         */
+        explicit StartupCache(std::string filename);
+
+        /** @brief Copying is not allowed */
+        StartupCache(const StartupCache&) = delete;
+
+        /** @brief Copying is not allowed */
+        StartupCache& operator=(const StartupCache&) = delete;
+
+        ~StartupCache();
+
+        /** @brief Cache filename */
+        const std::string& filename() const { return _filename; }
+
+        /** @brief Whether an existing cache file was loaded */
+        bool isLoaded() const { return _loaded; }
+
+        /**
+         * @brief Get a blob
+         *
+         * Returns an empty view if there's no such blob. The view is valid
+         * until @ref set() is called with the same name or until
+         * @ref save().
+         */
+        Containers::ArrayView<const char> get(const std::string& name);
+
+        /**
+         * @brief Add or replace a blob
+         *
+         * The data are copied.
+         */
+        StartupCache& set(const std::string& name, Containers::ArrayView<const char> data);
+
+        /**
+         * @brief Load a GL program binary
+         *
+         * If there's a blob of given name and program binaries are
+         * supported, loads it into @p program. Returns @cpp true @ce if the
+         * program is linked after that, @cpp false @ce otherwise, in which
+         * case the program should be compiled and linked as usual. Call
+         * @ref prepareProgram() before linking and @ref saveProgram() after.
+         */
+        bool loadProgram(const std::string& name, GLuint program);
+
+        /**
+         * @brief Prepare a GL program for saving its binary
+         *
+         * Hints the driver that the binary will be retrieved. Call before
+         * linking. Does nothing if program binaries are not supported.
+         */
+        void prepareProgram(GLuint program);
+
+        /**
+         * @brief Save a linked GL program binary
+         *
+         * Does nothing if program binaries are not supported.
+         */
+        void saveProgram(const std::string& name, GLuint program);
+
+        /** @brief Count of @ref get() and @ref loadProgram() calls that found a usable blob */
+        UnsignedInt hitCount() const { return _hitCount; }
+
+        /** @brief Count of @ref get() and @ref loadProgram() calls that found nothing usable */
+        UnsignedInt missCount() const { return _missCount; }
+
+        /** @brief Whether anything was added since loading or saving */
+        bool hasChanged() const { return _changed; }
+
+        /**
+         * @brief Write the cache to @ref filename()
+         *
+         * All blobs are moved to memory first, so the file isn't mapped
+         * while it's being written. Returns @cpp false @ce if the file
+         * can't be written.
+         */
+        bool save();
+
+    private:
+        struct Entry {
+            std::string name;
+            Containers::ArrayView<const char> data;
+            /* Empty if the data point into the mapped file */
+            Containers::Array<char> owned;
+        };
+
+        Entry* find(const std::string& name);
+
+        std::string _filename;
+        UnsignedLong _contextHash;
+        bool _programBinarySupported, _loaded{}, _changed{};
+        UnsignedInt _hitCount{}, _missCount{};
+        Containers::Array<const char, Utility::Directory::MapDeleter> _data;
+        /* Contents of the file after save() */
+        Containers::Array<char> _storage;
+        std::vector<Entry> _entries;
+};
+
+static_assert(sizeof(StartupCache::FileHeader) == 24 && sizeof(StartupCache::EntryHeader) == 16, "unexpected padding in startup cache headers");
+
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "StereoFrustum.h"
+
+#include <Magnum/Math/Functions.h>
+
+namespace Magnum {
+
+namespace {
+
+void extractPlanes(const Matrix4& m, Vector4(&planes)[6]) {
+    const Vector4 x = m.row(0), y = m.row(1), z = m.row(2), w = m.row(3);
+    planes[0] = w + x;
+    planes[1] = w - x;
+    planes[2] = w + y;
+    planes[3] = w - y;
+    planes[4] = w + z;
+    planes[5] = w - z;
+    for(Vector4& plane: planes) plane /= plane.xyz().length();
+}
+
+void extractCorners(const Matrix4& m, Vector3(&corners)[8]) {
+    const Matrix4 inverted = m.inverted();
+    for(Int i = 0; i != 8; ++i) {
+        const Vector4 corner = inverted*Vector4{i & 1 ? 1.0f : -1.0f,
+                                                i & 2 ? 1.0f : -1.0f,
+                                                i & 4 ? 1.0f : -1.0f, 1.0f};
+        corners[i] = corner.xyz()/corner.w();
+    }
+}
+
+Float distance(const Vector4& plane, const Vector3& point) {
+    return Math::dot(plane.xyz(), point) + plane.w();
+}
+
+}
+
+StereoFrustum::StereoFrustum(const Matrix4& leftViewProjection, const Matrix4& rightViewProjection) {
+    extractPlanes(leftViewProjection, _eyePlanes[0]);
+    extractPlanes(rightViewProjection, _eyePlanes[1]);
+
+    Vector3 corners[2][8];
+    extractCorners(leftViewProjection, corners[0]);
+    extractCorners(rightViewProjection, corners[1]);
+
+    /* For every plane take the candidate from the eye that needs to be
+       pushed out the least to enclose the other eye's frustum. Usually
+       that's zero, as the outer side planes of each eye and the shared
+       top, bottom, near and far planes already enclose both. */
+    for(Int i = 0; i != 6; ++i) {
+        Float bestShift{};
+        for(Int eye: {0, 1}) {
+            Float shift{};
+            for(const Vector3& corner: corners[1 - eye])
+                shift = Math::max(shift, -distance(_eyePlanes[eye][i], corner));
+            if(eye == 0 || shift < bestShift) {
+                bestShift = shift;
+                _combinedPlanes[i] = _eyePlanes[eye][i];
+            }
+        }
+        _combinedPlanes[i].w() += bestShift;
+    }
+}
+
+StereoFrustum::Test StereoFrustum::test(const Vector4(&planes)[6], const Range3D& box) {
+    Test result = Test::Inside;
+    for(const Vector4& plane: planes) {
+        /* The box corner furthest along the plane normal decides whether
+           it's outside, the nearest one whether it's inside */
+        const Vector3 normal = plane.xyz();
+        const Vector3 furthest{normal.x() >= 0.0f ? box.max().x() : box.min().x(),
+                               normal.y() >= 0.0f ? box.max().y() : box.min().y(),
+                               normal.z() >= 0.0f ? box.max().z() : box.min().z()};
+        if(distance(plane, furthest) < 0.0f) return Test::Outside;
+
+        const Vector3 nearest{normal.x() >= 0.0f ? box.min().x() : box.max().x(),
+                              normal.y() >= 0.0f ? box.min().y() : box.max().y(),
+                              normal.z() >= 0.0f ? box.min().z() : box.max().z()};
+        if(distance(plane, nearest) < 0.0f) result = Test::Intersects;
+    }
+    return result;
+}
+
+UnsignedByte StereoFrustum::eyeMask(const Range3D& box) const {
+    return (test(_eyePlanes[0], box) != Test::Outside ? LeftEye : 0)|
+           (test(_eyePlanes[1], box) != Test::Outside ? RightEye : 0);
+}
+
+}
@@ -0,0 +1,123 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_StereoFrustum_h
+#define Magnum_VrUi_StereoFrustum_h
+
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Range.h>
+
+namespace Magnum {
+
+/**
+@brief Stereo view frustum
+
+Frusta of both eyes together with a combined frustum enclosing both of
+them, so a bounding box can be culled for both eyes with a single test and
+only the boxes surviving it get tested for each eye separately. Planes are
+extracted from the view-projection matrices and face inwards.
+
+The combined frustum takes each plane from the eye whose plane already
+encloses the other eye's frustum, such as the left plane of the left eye,
+and pushes it outwards if neither does, so it's conservative for any eye
+poses and asymmetric projections.
+
+@code{.cpp}
+StereoFrustum frustum{viewProjection[0], viewProjection[1]};
+if(frustum.test(bounds) != StereoFrustum::Test::Outside) {
+    UnsignedByte eyes = frustum.eyeMask(bounds);
+    // draw in eyes that have their bit set
+}
+@endcode
+*/
+class StereoFrustum {
+    public:
+        /** @brief Eye visibility mask bits */
+        enum: UnsignedByte {
+            LeftEye = 1 << 0,   /**< Visible in the left eye */
+            RightEye = 1 << 1,  /**< Visible in the right eye */
+            BothEyes = LeftEye|RightEye /**< Visible in both eyes */
+        };
+
+        /** @brief Bounding box test result */
+        enum class Test: UnsignedByte {
+            Outside,    /**< Completely outside */
+            Intersects, /**< Intersecting the boundary or not decided */
+            Inside      /**< Completely inside */
+        };
+
+        /**
+         * @brief Default constructor
+         *
+         * All planes are zero, meaning everything is inside.
+         */
+        explicit StereoFrustum() = default;
+
+        /**
+         * @brief Constructor
+         * @param leftViewProjection    View-projection matrix of the left eye
+         * @param rightViewProjection   View-projection matrix of the right
+         *      eye
+         */
+        explicit StereoFrustum(const Matrix4& leftViewProjection, const Matrix4& rightViewProjection);
+
+        /**
+         * @brief Plane of given eye
+         *
+         * Planes are in order left, right, bottom, top, near and far, with
+         * points @f$ \boldsymbol{p} @f$ for which
+         * @f$ \boldsymbol{n} \cdot \boldsymbol{p} + d \ge 0 @f$ being
+         * inside.
+         */
+        const Vector4& plane(Int eye, Int i) const { return _eyePlanes[eye][i]; }
+
+        /** @brief Plane of the combined frustum */
+        const Vector4& combinedPlane(Int i) const { return _combinedPlanes[i]; }
+
+        /** @brief Test a bounding box against the combined frustum */
+        Test test(const Range3D& box) const { return test(_combinedPlanes, box); }
+
+        /** @brief Test a bounding box against a frustum of given eye */
+        Test test(Int eye, const Range3D& box) const { return test(_eyePlanes[eye], box); }
+
+        /**
+         * @brief Eyes a bounding box is visible in
+         *
+         * Combination of @ref LeftEye and @ref RightEye bits. Tests against
+         * both eye frusta, meant to be called only for boxes that passed
+         * @ref test() against the combined frustum.
+         */
+        UnsignedByte eyeMask(const Range3D& box) const;
+
+    private:
+        static Test test(const Vector4(&planes)[6], const Range3D& box);
+
+        Vector4 _eyePlanes[2][6]{};
+        Vector4 _combinedPlanes[6]{};
+};
+
+}
+
+#endif
@@ -0,0 +1,137 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "StreamingBuffer.h"
+
+#include <cstring>
+#include <utility>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+
+namespace Magnum {
+
+bool StreamingBuffer::isPersistentMappingSupported() {
+    return GL::Context::current().isExtensionSupported<GL::Extensions::ARB::buffer_storage>();
+}
+
+StreamingBuffer::StreamingBuffer(const std::size_t frameCapacity): StreamingBuffer{frameCapacity, isPersistentMappingSupported() ? Mode::PersistentMapping : Mode::Orphaning} {}
+
+StreamingBuffer::StreamingBuffer(const std::size_t frameCapacity, const Mode mode): _buffer{GL::Buffer::TargetHint::Array}, _mode{mode}, _frameCapacity{frameCapacity} {
+    CORRADE_ASSERT(mode != Mode::PersistentMapping || isPersistentMappingSupported(),
+        "StreamingBuffer: persistent mapping is not supported", );
+
+    const std::size_t size = frameCapacity*FrameCount;
+    if(mode == Mode::PersistentMapping) {
+        _buffer.setStorage({nullptr, size}, GL::Buffer::StorageFlag::MapWrite|GL::Buffer::StorageFlag::MapPersistent|GL::Buffer::StorageFlag::MapCoherent);
+        _mapped = _buffer.map(0, size, GL::Buffer::MapFlag::Write|GL::Buffer::MapFlag::Persistent|GL::Buffer::MapFlag::Coherent).data();
+    } else _buffer.setData({nullptr, size}, GL::BufferUsage::StreamDraw);
+}
+
+StreamingBuffer::StreamingBuffer(NoCreateT) noexcept: _buffer{NoCreate} {}
+
+StreamingBuffer::StreamingBuffer(StreamingBuffer&& other) noexcept: _buffer{std::move(other._buffer)}, _mode{other._mode}, _frameCapacity{other._frameCapacity}, _mapped{other._mapped}, _frame{other._frame}, _frameOffset{other._frameOffset}, _frameUploadedBytes{other._frameUploadedBytes}, _frameFenceWaits{other._frameFenceWaits}, _uploadedBytes{other._uploadedBytes}, _fenceWaits{other._fenceWaits} {
+    for(UnsignedInt i = 0; i != FrameCount; ++i) {
+        _fences[i] = other._fences[i];
+        other._fences[i] = nullptr;
+    }
+    other._mapped = nullptr;
+}
+
+StreamingBuffer::~StreamingBuffer() {
+    for(GLsync fence: _fences) if(fence) glDeleteSync(fence);
+
+    /* Persistent mappings are released together with the buffer */
+}
+
+StreamingBuffer& StreamingBuffer::operator=(StreamingBuffer&& other) noexcept {
+    using std::swap;
+    swap(_buffer, other._buffer);
+    swap(_mode, other._mode);
+    swap(_frameCapacity, other._frameCapacity);
+    swap(_mapped, other._mapped);
+    swap(_fences, other._fences);
+    swap(_frame, other._frame);
+    swap(_frameOffset, other._frameOffset);
+    swap(_frameUploadedBytes, other._frameUploadedBytes);
+    swap(_frameFenceWaits, other._frameFenceWaits);
+    swap(_uploadedBytes, other._uploadedBytes);
+    swap(_fenceWaits, other._fenceWaits);
+    return *this;
+}
+
+void StreamingBuffer::beginFrame() {
+    _frameUploadedBytes = 0;
+    _frameFenceWaits = 0;
+
+    if(_mode == Mode::Orphaning) {
+        /* The driver hands out fresh storage if the GPU still reads the old
+           one, so the first region is always safe to write */
+        _buffer.setData({nullptr, _frameCapacity*FrameCount}, GL::BufferUsage::StreamDraw);
+        _frame = 0;
+        _frameOffset = 0;
+        return;
+    }
+
+    /* Everything reading the previous region was submitted by now */
+    if(_frame != -1) _fences[_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    _frame = (_frame + 1) % FrameCount;
+    _frameOffset = _frame*_frameCapacity;
+
+    GLsync& fence = _fences[_frame];
+    if(!fence) return;
+
+    /* Poll first to count only actual waits, then block flushing the
+       command queue so the fence is guaranteed to signal */
+    if(glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+        ++_frameFenceWaits;
+        ++_fenceWaits;
+        while(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+std::size_t StreamingBuffer::upload(const Containers::ArrayView<const void> data, const std::size_t alignment) {
+    CORRADE_ASSERT(_frame != -1,
+        "StreamingBuffer::upload(): no frame begun", {});
+
+    const std::size_t offset = (_frameOffset + alignment - 1)/alignment*alignment;
+    const std::size_t regionEnd = (_frame + 1)*_frameCapacity;
+    CORRADE_ASSERT(offset + data.size() <= regionEnd,
+        "StreamingBuffer::upload(): uploading" << data.size() << "bytes would exceed the frame capacity of" << _frameCapacity << "bytes", {});
+
+    if(_mode == Mode::PersistentMapping)
+        std::memcpy(_mapped + offset, data.data(), data.size());
+    else
+        _buffer.setSubData(offset, data);
+
+    _frameOffset = offset + data.size();
+    _frameUploadedBytes += data.size();
+    _uploadedBytes += data.size();
+    return offset;
+}
+
+}
@@ -0,0 +1,185 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_StreamingBuffer_h
+#define Magnum_VrUi_StreamingBuffer_h
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/OpenGL.h>
+
+namespace Magnum {
+
+/**
+@brief Streaming buffer for per-frame dynamic GPU data
+
+A single buffer split into @ref FrameCount regions, one of which is written
+by the CPU each frame while the GPU still reads the others. Data are copied
+in with @ref upload(), which returns their offset in @ref buffer(); meshes
+read them either through an offset given to the vertex attribute binding
+or, if the attributes are bound at offset zero, through a base instance of
+offset divided by the instance stride.
+
+If `GL_ARB_buffer_storage` is supported, the buffer is persistently
+mapped and coherent, so uploading is a plain @cpp memcpy() @ce. A fence is
+inserted when a region is left and waited for before it gets written again,
+which normally never blocks, as it's three frames old by then. Otherwise
+the buffer is orphaned at the beginning of every frame and data are
+uploaded with @ref GL::Buffer::setSubData(), leaving the synchronization to
+the driver.
+
+@code{.cpp}
+StreamingBuffer stream{64*1024};
+mesh.addVertexBufferInstanced(stream.buffer(), 1, 0, ...);
+
+// every frame
+stream.beginFrame();
+std::size_t offset = stream.upload(instances, sizeof(Instance));
+mesh.setBaseInstance(offset/sizeof(Instance))
+    .draw(shader);
+@endcode
+*/
+class StreamingBuffer {
+    public:
+        /** @brief Count of frames in flight */
+        enum: UnsignedInt { FrameCount = 3 };
+
+        /** @brief Upload mode */
+        enum class Mode: UnsignedByte {
+            /** Persistently mapped with fence-based reuse */
+            PersistentMapping,
+
+            /** Orphaned every frame and updated with subdata uploads */
+            Orphaning
+        };
+
+        /**
+         * @brief Whether persistent mapping is supported
+         *
+         * Expects that a GL context is current.
+         */
+        static bool isPersistentMappingSupported();
+
+        /**
+         * @brief Constructor
+         * @param frameCapacity     Max bytes uploaded in a single frame
+         * @param mode              Upload mode, expected to be
+         *      @ref Mode::Orphaning if persistent mapping is not supported
+         *
+         * Expects that a GL context is current.
+         */
+        explicit StreamingBuffer(std::size_t frameCapacity, Mode mode);
+
+        /**
+         * @brief Constructor
+         *
+         * Uses @ref Mode::PersistentMapping if supported and
+         * @ref Mode::Orphaning otherwise.
+         */
+        explicit StreamingBuffer(std::size_t frameCapacity);
+
+        /** @brief Construct without creating the buffer */
+        explicit StreamingBuffer(NoCreateT) noexcept;
+
+        /** @brief Copying is not allowed */
+        StreamingBuffer(const StreamingBuffer&) = delete;
+
+        /** @brief Move constructor */
+        StreamingBuffer(StreamingBuffer&& other) noexcept;
+
+        ~StreamingBuffer();
+
+        /** @brief Copying is not allowed */
+        StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+        /** @brief Move assignment */
+        StreamingBuffer& operator=(StreamingBuffer&& other) noexcept;
+
+        /** @brief Upload mode */
+        Mode mode() const { return _mode; }
+
+        /** @brief Underlying buffer */
+        GL::Buffer& buffer() { return _buffer; }
+
+        /** @brief Max bytes uploaded in a single frame */
+        std::size_t frameCapacity() const { return _frameCapacity; }
+
+        /**
+         * @brief Begin a frame
+         *
+         * Fences the region written last frame, moves to the next one and
+         * waits until the GPU finished reading it. Resets the per-frame
+         * statistics.
+         */
+        void beginFrame();
+
+        /**
+         * @brief Upload data
+         * @param data          Data to upload
+         * @param alignment     Alignment of the offset
+         * @return Offset of the data in @ref buffer()
+         *
+         * The offset is aligned to a multiple of @p alignment from the
+         * buffer start, which doesn't need to be a power of two, so it can
+         * be an instance stride. Expects that @ref beginFrame() was called
+         * and the data together with already uploaded ones fit into
+         * @ref frameCapacity().
+         */
+        std::size_t upload(Containers::ArrayView<const void> data, std::size_t alignment = 16);
+
+        /** @brief Bytes uploaded since last @ref beginFrame() */
+        std::size_t frameUploadedBytes() const { return _frameUploadedBytes; }
+
+        /**
+         * @brief Fence waits in last @ref beginFrame()
+         *
+         * @cpp 1 @ce if the GPU didn't finish reading the region by the
+         * time it was needed again, @cpp 0 @ce otherwise. Always
+         * @cpp 0 @ce with @ref Mode::Orphaning.
+         */
+        UnsignedInt frameFenceWaits() const { return _frameFenceWaits; }
+
+        /** @brief Bytes uploaded in total */
+        UnsignedLong uploadedBytes() const { return _uploadedBytes; }
+
+        /** @brief Fence waits in total */
+        UnsignedLong fenceWaits() const { return _fenceWaits; }
+
+    private:
+        GL::Buffer _buffer;
+        Mode _mode{};
+        std::size_t _frameCapacity{};
+        char* _mapped{};
+        GLsync _fences[FrameCount]{};
+        Int _frame{-1};
+        std::size_t _frameOffset{};
+        std::size_t _frameUploadedBytes{};
+        UnsignedInt _frameFenceWaits{};
+        UnsignedLong _uploadedBytes{}, _fenceWaits{};
+};
+
+}
+
+#endif
@@ -0,0 +1,83 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include "TelemetryExporter.h"
+
+#include <cstring>
+#include <new>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Math/Functions.h>
+
+namespace Magnum {
+
+namespace {
+
+UnsignedInt roundUpToPowerOfTwo(const UnsignedInt value) {
+    UnsignedInt out = 1;
+    while(out < value) out <<= 1;
+    return out;
+}
+
+}
+
+TelemetryExporter::TelemetryExporter(const std::string& name, const UnsignedInt capacity): _memory{name, SharedMemory::Mode::Create, SharedTelemetry::regionSize(roundUpToPowerOfTwo(Math::max(capacity, 1u)))}, _capacity{roundUpToPowerOfTwo(Math::max(capacity, 1u))} {
+    if(!_memory.isOpen()) return;
+
+    /* The region is zero-filled, so all slot sequences are zero and no
+       slot looks written. Readers check the magic first, so it's set last. */
+    _header = new(_memory.data()) SharedTelemetry::Header{};
+    _header->version = SharedTelemetry::Version;
+    _header->slotSize = sizeof(SharedTelemetry::Slot);
+    _header->capacity = _capacity;
+    _slots = reinterpret_cast<SharedTelemetry::Slot*>(_memory.data() + sizeof(SharedTelemetry::Header));
+    for(UnsignedInt i = 0; i != _capacity; ++i)
+        new(&_slots[i].sequence) std::atomic<UnsignedLong>{0};
+
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(_header->magic, "MVRUITEL", 8);
+}
+
+SharedTelemetry::Frame& TelemetryExporter::beginFrame() {
+    CORRADE_ASSERT(_header && !_current,
+        "TelemetryExporter::beginFrame(): region not open or frame already begun", _slots->frame);
+
+    /* An odd sequence tells readers the slot is being overwritten. The
+       fence keeps the record writes from being reordered before it. */
+    _current = &_slots[_writeCount & (_capacity - 1)];
+    _current->sequence.store(2*_writeCount + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return _current->frame;
+}
+
+void TelemetryExporter::endFrame() {
+    CORRADE_ASSERT(_current,
+        "TelemetryExporter::endFrame(): no frame begun", );
+
+    _current->sequence.store(2*_writeCount + 2, std::memory_order_release);
+    _header->writeCount.store(++_writeCount, std::memory_order_release);
+    _current = nullptr;
+}
+
+}
@@ -0,0 +1,102 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef Magnum_VrUi_TelemetryExporter_h
+#define Magnum_VrUi_TelemetryExporter_h
+
+#include <string>
+#include <Magnum/Magnum.h>
+
+#include "SharedMemory.h"
+#include "SharedTelemetry.h"
+
+namespace Magnum {
+
+/**
+@brief Shared memory telemetry exporter
+
+Writes one @ref SharedTelemetry::Frame per frame into a ring buffer in a
+named @ref SharedMemory region, for external tools to read with
+@ref TelemetryReader without touching the frame loop. Single producer ---
+only one thread is expected to write.
+
+The record is filled in place in the shared memory between
+@ref beginFrame() and @ref endFrame(). Writing never blocks on readers and
+never allocates, readers that don't keep up lose the oldest frames.
+*/
+class TelemetryExporter {
+    public:
+        /** @brief Default slot count */
+        enum: UnsignedInt { DefaultCapacity = 1024 };
+
+        /**
+         * @brief Constructor
+         * @param name      Shared memory region name
+         * @param capacity  Slot count, rounded up to a power of two
+         *
+         * Replaces any existing region of the same name. Check
+         * @ref isOpen() for success, writing into a region that failed to
+         * open does nothing.
+         */
+        explicit TelemetryExporter(const std::string& name, UnsignedInt capacity = DefaultCapacity);
+
+        /** @brief Whether the region is mapped */
+        bool isOpen() const { return _memory.isOpen(); }
+
+        /** @brief Slot count */
+        UnsignedInt capacity() const { return _capacity; }
+
+        /** @brief Count of frames written so far */
+        UnsignedLong writeCount() const { return _writeCount; }
+
+        /**
+         * @brief Begin writing a frame
+         *
+         * Marks the next slot as being written and returns its record.
+         * Its previous contents are left there, all fields are expected to
+         * be overwritten. Expects that the region is open and no frame is
+         * being written.
+         */
+        SharedTelemetry::Frame& beginFrame();
+
+        /**
+         * @brief End writing a frame
+         *
+         * Publishes the record returned from @ref beginFrame() to readers.
+         */
+        void endFrame();
+
+    private:
+        SharedMemory _memory;
+        UnsignedInt _capacity;
+        UnsignedLong _writeCount{};
+        SharedTelemetry::Header* _header{};
+        SharedTelemetry::Slot* _slots{};
+        SharedTelemetry::Slot* _current{};
+};
+
+}
+
+#endif
@@ -0,0 +1,127 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "TelemetryPanel.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Ui/Input.h>
+
+#include "AllocationCounter.h"
+
+namespace Magnum {
+
+TelemetryPanel::TelemetryPanel() = default;
+
+UnsignedInt TelemetryPanel::addField(Ui::Input& widget, const std::size_t width) {
+    CORRADE_ASSERT(width && width <= MaxWidth,
+        "TelemetryPanel::addField(): expected width between 1 and" << MaxWidth << "but got" << width, {});
+
+    Field field{};
+    field.widget = &widget;
+    field.width = width;
+    _fields.push_back(field);
+    return _fields.size() - 1;
+}
+
+TelemetryPanel& TelemetryPanel::setMaxRefreshRate(const Float rate) {
+    _maxRefreshRate = rate;
+    _minInterval = rate > 0.0f ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<Double>{1.0/rate}) : std::chrono::steady_clock::duration{};
+    return *this;
+}
+
+TelemetryPanel& TelemetryPanel::set(const UnsignedInt field, const Int value) {
+    Field& f = _fields[field];
+    f.type = Type::Int;
+    f.value.i = value;
+    f.set = true;
+    return *this;
+}
+
+TelemetryPanel& TelemetryPanel::set(const UnsignedInt field, const Float value) {
+    Field& f = _fields[field];
+    f.type = Type::Float;
+    f.value.f = value;
+    f.set = true;
+    return *this;
+}
+
+TelemetryPanel& TelemetryPanel::flush(const std::chrono::steady_clock::time_point now) {
+    return format(now).apply();
+}
+
+TelemetryPanel& TelemetryPanel::format(const std::chrono::steady_clock::time_point now) {
+    if(_flushed && now - _lastFlush < _minInterval) {
+        _skippedCount += _fields.size();
+        return *this;
+    }
+
+    _lastFlush = now;
+    _flushed = true;
+
+    /* Large enough for any %d or %f output of a 32-bit value, the result
+       is truncated to field width afterwards */
+    char formatted[64];
+    for(Field& f: _fields) {
+        if(!f.set) {
+            ++_skippedCount;
+            continue;
+        }
+
+        if(f.type == Type::Int)
+            std::snprintf(formatted, sizeof(formatted), "%d", f.value.i);
+        else
+            std::snprintf(formatted, sizeof(formatted), "%f", Double(f.value.f));
+        formatted[f.width] = '\0';
+
+        if(std::strcmp(formatted, f.displayed) == 0) {
+            ++_skippedCount;
+            continue;
+        }
+
+        std::strcpy(f.displayed, formatted);
+        f.changed = true;
+    }
+
+    return *this;
+}
+
+TelemetryPanel& TelemetryPanel::apply() {
+    /* The strings fit into small string storage, but the text layout in
+       the UI library allocates */
+    AllocationCounter::Exempt exempt;
+    for(Field& f: _fields) {
+        if(!f.changed) continue;
+
+        f.widget->setValue(f.displayed);
+        f.changed = false;
+        ++_updateCount;
+    }
+
+    return *this;
+}
+
+}
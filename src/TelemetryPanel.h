@@ -0,0 +1,167 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_TelemetryPanel_h
+#define Magnum_VrUi_TelemetryPanel_h
+
+#include <chrono>
+#include <vector>
+#include <Magnum/Magnum.h>
+#include <Magnum/Ui/Ui.h>
+
+namespace Magnum {
+
+/**
+@brief Rate-limited telemetry display
+
+Shows numeric values in UI input widgets without reshaping text every frame.
+Values passed to @ref set() are only stored. On @ref flush() they get
+formatted into preallocated per-field buffers, without any heap allocation,
+and a widget is updated only if its displayed string actually changed. The
+refresh can be additionally capped with @ref setMaxRefreshRate(), in which
+case @ref flush() does nothing until enough time has passed.
+
+@code{.cpp}
+TelemetryPanel telemetry;
+UnsignedInt fps = telemetry.addField(fpsInput, 6);
+
+// every frame
+telemetry.set(fps, currentFps)
+    .flush();
+@endcode
+*/
+class TelemetryPanel {
+    public:
+        /** @brief Max field width, in characters */
+        enum: std::size_t { MaxWidth = 15 };
+
+        /**
+         * @brief Constructor
+         *
+         * Refresh rate is not limited by default.
+         */
+        explicit TelemetryPanel();
+
+        /**
+         * @brief Add a field
+         * @param widget    Widget to display the value in
+         * @param width     Width in characters the formatted value gets
+         *      truncated to. Expected to be at most @ref MaxWidth.
+         * @return Field ID to be passed to @ref set()
+         */
+        UnsignedInt addField(Ui::Input& widget, std::size_t width);
+
+        /** @brief Field count */
+        std::size_t fieldCount() const { return _fields.size(); }
+
+        /** @brief Max refresh rate, in Hz */
+        Float maxRefreshRate() const { return _maxRefreshRate; }
+
+        /**
+         * @brief Set max refresh rate
+         *
+         * Widgets get updated at most @p rate times per second. Set to
+         * @cpp 0.0f @ce to update on every @ref flush().
+         */
+        TelemetryPanel& setMaxRefreshRate(Float rate);
+
+        /** @brief Set an integer value, formatted with @cpp "%d" @ce */
+        TelemetryPanel& set(UnsignedInt field, Int value);
+
+        /** @brief Set a floating-point value, formatted with @cpp "%f" @ce */
+        TelemetryPanel& set(UnsignedInt field, Float value);
+
+        /**
+         * @brief Push changed values to the widgets
+         *
+         * Uses current time of @ref std::chrono::steady_clock for rate
+         * limiting.
+         */
+        TelemetryPanel& flush() { return flush(std::chrono::steady_clock::now()); }
+
+        /**
+         * @brief Push changed values to the widgets with explicit time
+         *
+         * Useful for deterministic replays and benchmarks.
+         */
+        TelemetryPanel& flush(std::chrono::steady_clock::time_point now);
+
+        /**
+         * @brief Format changed values
+         *
+         * First half of @ref flush(), which formats the values and finds
+         * out which widgets need an update, without touching them. Doesn't
+         * access the UI, so it can run on a different thread than the one
+         * drawing it, as long as @ref set() and @ref apply() are not called
+         * at the same time.
+         */
+        TelemetryPanel& format(std::chrono::steady_clock::time_point now);
+
+        /**
+         * @brief Push values formatted by @ref format() to the widgets
+         *
+         * Second half of @ref flush(). Does nothing if nothing changed since
+         * the last call.
+         */
+        TelemetryPanel& apply();
+
+        /** @brief Count of widget updates done */
+        UnsignedLong updateCount() const { return _updateCount; }
+
+        /**
+         * @brief Count of widget updates skipped
+         *
+         * Counts fields that were not pushed on @ref flush() either because
+         * the displayed string didn't change or because of the refresh rate
+         * limit.
+         */
+        UnsignedLong skippedCount() const { return _skippedCount; }
+
+    private:
+        enum class Type: UnsignedByte { Int, Float };
+
+        struct Field {
+            Ui::Input* widget;
+            std::size_t width;
+            Type type;
+            bool set;
+            bool changed;
+            union {
+                Int i;
+                Float f;
+            } value;
+            char displayed[MaxWidth + 1];
+        };
+
+        std::vector<Field> _fields;
+        Float _maxRefreshRate{};
+        std::chrono::steady_clock::duration _minInterval{};
+        std::chrono::steady_clock::time_point _lastFlush;
+        bool _flushed{};
+        UnsignedLong _updateCount{}, _skippedCount{};
+};
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include "TelemetryReader.h"
+
+#include <cstring>
+#include <Corrade/Utility/Debug.h>
+
+namespace Magnum {
+
+TelemetryReader::TelemetryReader(const std::string& name): _memory{name, SharedMemory::Mode::ReadOnly} {
+    if(!_memory.isOpen()) return;
+
+    /* The exporter sets the magic last, a region without it is still being
+       set up */
+    const auto& header = *reinterpret_cast<const SharedTelemetry::Header*>(_memory.data());
+    if(_memory.size() < sizeof(SharedTelemetry::Header) ||
+       std::memcmp(header.magic, "MVRUITEL", 8) != 0)
+        return;
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if(header.version != SharedTelemetry::Version ||
+       header.slotSize != sizeof(SharedTelemetry::Slot) ||
+       !header.capacity || (header.capacity & (header.capacity - 1)) ||
+       _memory.size() < SharedTelemetry::regionSize(header.capacity)) {
+        Error() << "TelemetryReader: unsupported region version" << header.version << "with slot size" << header.slotSize << "and capacity" << header.capacity;
+        return;
+    }
+
+    _header = &header;
+    _slots = reinterpret_cast<const SharedTelemetry::Slot*>(_memory.data() + sizeof(SharedTelemetry::Header));
+    _capacity = header.capacity;
+}
+
+UnsignedLong TelemetryReader::writeCount() const {
+    return _header ? _header->writeCount.load(std::memory_order_acquire) : 0;
+}
+
+const SharedTelemetry::Frame* TelemetryReader::view(const UnsignedLong index) const {
+    if(!_header) return nullptr;
+
+    const SharedTelemetry::Slot& slot = _slots[index & (_capacity - 1)];
+    if(slot.sequence.load(std::memory_order_acquire) != 2*index + 2)
+        return nullptr;
+    return &slot.frame;
+}
+
+bool TelemetryReader::isIntact(const UnsignedLong index) const {
+    if(!_header) return false;
+
+    /* Keeps the preceding reads of the frame from being reordered after the
+       sequence check */
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return _slots[index & (_capacity - 1)].sequence.load(std::memory_order_relaxed) == 2*index + 2;
+}
+
+bool TelemetryReader::read(const UnsignedLong index, SharedTelemetry::Frame& out) const {
+    const SharedTelemetry::Frame* const frame = view(index);
+    if(!frame) return false;
+
+    std::memcpy(&out, frame, sizeof(SharedTelemetry::Frame));
+    return isIntact(index);
+}
+
+TelemetryReader::Status TelemetryReader::next(SharedTelemetry::Frame& out) {
+    const UnsignedLong written = writeCount();
+    if(_cursor >= written) return Status::Pending;
+
+    /* The slots of frames older than the capacity got already reused */
+    if(written - _cursor > _capacity) {
+        _overrunCount += written - _capacity - _cursor;
+        _cursor = written - _capacity;
+        return Status::Overrun;
+    }
+
+    /* Overwritten while copying, the writer is at least a full ring ahead
+       now, so skip this one frame and let the next call catch up */
+    if(!read(_cursor, out)) {
+        ++_overrunCount;
+        ++_cursor;
+        return Status::Overrun;
+    }
+
+    ++_cursor;
+    return Status::Ok;
+}
+
+}
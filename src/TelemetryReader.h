@@ -0,0 +1,148 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#ifndef Magnum_VrUi_TelemetryReader_h
+#define Magnum_VrUi_TelemetryReader_h
+
+#include <string>
+#include <Magnum/Magnum.h>
+
+#include "SharedMemory.h"
+#include "SharedTelemetry.h"
+
+namespace Magnum {
+
+/**
+@brief Shared memory telemetry reader
+
+Reads frames written by a @ref TelemetryExporter in another process. The
+region is mapped read-only and the writer never waits for the reader, so a
+reader that falls more than @ref capacity() frames behind loses frames.
+This gets detected and counted in @ref overrunCount().
+
+Frames can be either used in place through @ref view() and
+@ref isIntact(), without any copy, or copied out with @ref read() and
+@ref next(). Doesn't depend on GL or anything else from the gallery, so it
+can be linked into external tools on its own as the
+@cb{.sh} MagnumVrUiTelemetryReader @ce library.
+*/
+class TelemetryReader {
+    public:
+        /** @brief Read status */
+        enum class Status: UnsignedByte {
+            /** A frame was read */
+            Ok,
+            /** No new frame written yet */
+            Pending,
+            /**
+             * The reader fell behind and frames were lost, see
+             * @ref overrunCount(). Reading continues with the oldest frame
+             * still available.
+             */
+            Overrun
+        };
+
+        /**
+         * @brief Constructor
+         *
+         * Opens a region created by @ref TelemetryExporter. Check
+         * @ref isOpen() for success --- the region doesn't exist yet if the
+         * exporter isn't running, a region of a different format is
+         * rejected with an error message.
+         */
+        explicit TelemetryReader(const std::string& name);
+
+        /** @brief Whether a valid region is mapped */
+        bool isOpen() const { return _header; }
+
+        /** @brief Slot count */
+        UnsignedInt capacity() const { return _capacity; }
+
+        /** @brief Count of frames written so far */
+        UnsignedLong writeCount() const;
+
+        /**
+         * @brief Frame in place
+         *
+         * Returns a pointer into the shared memory if frame @p index is
+         * written and wasn't overwritten yet, @cpp nullptr @ce otherwise.
+         * The writer can overwrite the frame any time, check
+         * @ref isIntact() after using the data to know whether they were
+         * consistent.
+         */
+        const SharedTelemetry::Frame* view(UnsignedLong index) const;
+
+        /**
+         * @brief Whether a frame is still intact
+         *
+         * Returns @cpp false @ce if frame @p index got overwritten since
+         * or while it was accessed through @ref view().
+         */
+        bool isIntact(UnsignedLong index) const;
+
+        /**
+         * @brief Copy a frame
+         *
+         * Returns @cpp false @ce if frame @p index isn't written yet or was
+         * overwritten before or during the copy, @p out then contains
+         * garbage.
+         */
+        bool read(UnsignedLong index, SharedTelemetry::Frame& out) const;
+
+        /** @brief Index of the frame read by the next @ref next() call */
+        UnsignedLong cursor() const { return _cursor; }
+
+        /**
+         * @brief Move the cursor
+         *
+         * Use @cpp seek(writeCount()) @ce to skip everything written so far.
+         */
+        TelemetryReader& seek(UnsignedLong index) {
+            _cursor = index;
+            return *this;
+        }
+
+        /**
+         * @brief Copy the frame at cursor and advance it
+         *
+         * On @ref Status::Overrun the cursor is moved past the lost frames
+         * and @p out isn't filled.
+         */
+        Status next(SharedTelemetry::Frame& out);
+
+        /** @brief Count of frames lost by @ref next() */
+        UnsignedLong overrunCount() const { return _overrunCount; }
+
+    private:
+        SharedMemory _memory;
+        const SharedTelemetry::Header* _header{};
+        const SharedTelemetry::Slot* _slots{};
+        UnsignedInt _capacity{};
+        UnsignedLong _cursor{}, _overrunCount{};
+};
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Arguments.h>
+
+#include <Magnum/Magnum.h>
+
+#include "TelemetryReader.h"
+
+/* Prints frames exported by the gallery through shared memory, one line per
+   frame, similarly to tail -f */
+int main(int argc, char** argv) {
+    using namespace Magnum;
+
+    Utility::Arguments args;
+    args.addOption("name", SharedTelemetry::DefaultName).setHelp("name", "shared memory region name", "NAME")
+        .addOption("count", "0").setHelp("count", "exit after printing this many frames, 0 to print until killed", "N")
+        .addBooleanOption("from-start").setHelp("from-start", "print also frames still in the ring from before the tool started")
+        .addOption("interval", "1").setHelp("interval", "polling interval when no new frame is available, in milliseconds", "MS")
+        .setGlobalHelp("Prints telemetry exported by magnum-vr-ui-gallery --export-telemetry.")
+        .parse(argc, argv);
+
+    const UnsignedLong count = args.value<UnsignedLong>("count");
+    const std::chrono::milliseconds interval{args.value<UnsignedInt>("interval")};
+
+    /* The gallery might not be running yet */
+    Containers::Optional<TelemetryReader> reader;
+    for(;;) {
+        reader.emplace(args.value("name"));
+        if(reader->isOpen()) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    }
+
+    /* Start at the oldest frame still in the ring or at the next one */
+    const UnsignedLong written = reader->writeCount();
+    if(!args.isSet("from-start")) reader->seek(written);
+    else if(written > reader->capacity()) reader->seek(written - reader->capacity());
+
+    std::printf("# frame time[ms] cpu[us] poseAge[us] draws scale reused hands joints touch[R] touch[L]\n");
+
+    SharedTelemetry::Frame frame;
+    UnsignedLong printed = 0, firstTimestamp = 0;
+    while(!count || printed != count) {
+        const TelemetryReader::Status status = reader->next(frame);
+        if(status == TelemetryReader::Status::Pending) {
+            std::fflush(stdout);
+            std::this_thread::sleep_for(interval);
+            continue;
+        }
+
+        if(status == TelemetryReader::Status::Overrun) {
+            std::printf("# overrun, %llu frames lost in total\n", static_cast<unsigned long long>(reader->overrunCount()));
+            continue;
+        }
+
+        if(!firstTimestamp) firstTimestamp = frame.timestamp;
+        std::printf("%llu %.3f %u %u %u %.2f %d %u %u %d:%u %d:%u\n",
+            static_cast<unsigned long long>(frame.frameIndex),
+            (frame.timestamp - firstTimestamp)*1.0e-6,
+            frame.cpuTime, frame.poseAge, frame.drawCalls,
+            Double(frame.resolutionScale),
+            frame.flags & SharedTelemetry::FrameReused ? 1 : 0,
+            frame.handCount, frame.jointCount,
+            frame.touchPanel[0], frame.touchEvent[0],
+            frame.touchPanel[1], frame.touchEvent[1]);
+        ++printed;
+    }
+
+    std::printf("# %llu frames, %llu lost\n",
+        static_cast<unsigned long long>(printed),
+        static_cast<unsigned long long>(reader->overrunCount()));
+    return 0;
+}
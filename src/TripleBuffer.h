@@ -0,0 +1,138 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_TripleBuffer_h
+#define Magnum_VrUi_TripleBuffer_h
+
+#include <atomic>
+#include <Magnum/Magnum.h>
+
+namespace Magnum {
+
+/**
+@brief Lock-free triple buffer
+
+Hands values over from a single producer thread to a single consumer thread
+without either of them ever waiting on the other. The producer fills
+@ref writeBuffer() and makes it available with @ref publish(), the consumer
+picks up the latest published value with @ref update() and reads it through
+@ref readBuffer(). Each side owns one of the three buffers at any time, the
+third one is exchanged between them through a single atomic index.
+
+If the producer publishes again before the consumer picked up the previous
+value, the previous value is dropped. If the consumer asks for an update
+while nothing new was published, the update is stale and @ref readBuffer()
+stays the same. Both cases are counted, see @ref droppedCount() and
+@ref staleCount().
+*/
+template<class T> class TripleBuffer {
+    public:
+        explicit TripleBuffer(): _shared{2} {}
+
+        /** @brief Copying is not allowed */
+        TripleBuffer(const TripleBuffer<T>&) = delete;
+
+        /** @brief Moving is not allowed */
+        TripleBuffer(TripleBuffer<T>&&) = delete;
+
+        /** @brief Copying is not allowed */
+        TripleBuffer<T>& operator=(const TripleBuffer<T>&) = delete;
+
+        /** @brief Moving is not allowed */
+        TripleBuffer<T>& operator=(TripleBuffer<T>&&) = delete;
+
+        /**
+         * @brief Buffer to fill on the producer side
+         *
+         * Contains whatever value was there before, not necessarily the
+         * last published one.
+         */
+        T& writeBuffer() { return _buffers[_write]; }
+
+        /** @brief Publish contents of @ref writeBuffer() on the producer side */
+        void publish() {
+            const UnsignedByte previous = _shared.exchange(_write|Fresh, std::memory_order_acq_rel);
+            _write = previous & IndexMask;
+            _publishedCount.fetch_add(1, std::memory_order_relaxed);
+            if(previous & Fresh) _droppedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Pick up the latest published value on the consumer side
+         *
+         * Returns @cpp true @ce if @ref readBuffer() changed,
+         * @cpp false @ce if nothing was published since last update.
+         */
+        bool update() {
+            if(!(_shared.load(std::memory_order_relaxed) & Fresh)) {
+                _staleCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            _read = _shared.exchange(_read, std::memory_order_acq_rel) & IndexMask;
+            return true;
+        }
+
+        /** @brief Latest value picked up on the consumer side */
+        const T& readBuffer() const { return _buffers[_read]; }
+
+        /** @brief Count of published values */
+        UnsignedLong publishedCount() const { return _publishedCount.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Count of dropped values
+         *
+         * Values that got published, but replaced by a newer one before the
+         * consumer picked them up.
+         */
+        UnsignedLong droppedCount() const { return _droppedCount.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Count of stale updates
+         *
+         * Calls to @ref update() that found nothing new.
+         */
+        UnsignedLong staleCount() const { return _staleCount.load(std::memory_order_relaxed); }
+
+    private:
+        enum: UnsignedByte {
+            IndexMask = 0x03,
+            Fresh = 0x04
+        };
+
+        T _buffers[3];
+
+        /* Producer, consumer and shared state are on separate cache lines
+           to avoid false sharing */
+        UnsignedByte _write{0};
+        std::atomic<UnsignedLong> _publishedCount{0},
+            _droppedCount{0};
+        alignas(64) UnsignedByte _read{1};
+        std::atomic<UnsignedLong> _staleCount{0};
+        alignas(64) std::atomic<UnsignedByte> _shared;
+};
+
+}
+
+#endif
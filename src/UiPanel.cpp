@@ -0,0 +1,170 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include "UiPanel.h"
+
+#include <new>
+#include <string>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Ui/Button.h>
+#include <Magnum/Ui/Input.h>
+#include <Magnum/Ui/Label.h>
+
+namespace Magnum {
+
+namespace {
+
+/* Glyph count of an UTF-8 string, continuation bytes don't start a glyph */
+std::size_t glyphCount(const char* text) {
+    std::size_t count{};
+    for(; *text; ++text) if((*text & 0xc0) != 0x80) ++count;
+    return count;
+}
+
+std::size_t alignedSize(const UiPanel::WidgetType type) {
+    /* Every widget starts at an offset aligned for all widget types */
+    constexpr std::size_t alignment = alignof(Ui::Button) > alignof(Ui::Label) ?
+        (alignof(Ui::Button) > alignof(Ui::Input) ? alignof(Ui::Button) : alignof(Ui::Input)) :
+        (alignof(Ui::Label) > alignof(Ui::Input) ? alignof(Ui::Label) : alignof(Ui::Input));
+
+    std::size_t size{};
+    switch(type) {
+        case UiPanel::WidgetType::Button: size = sizeof(Ui::Button); break;
+        case UiPanel::WidgetType::Label: size = sizeof(Ui::Label); break;
+        case UiPanel::WidgetType::Input: size = sizeof(Ui::Input); break;
+    }
+    return (size + alignment - 1)/alignment*alignment;
+}
+
+}
+
+UiPanel::WidgetDescription UiPanel::button(const Ui::Snaps snaps, const Int relativeTo, const Range2D& rect, const char* const text, const Ui::Style style, const bool disabled) {
+    return {WidgetType::Button, style, disabled, relativeTo, snaps, rect, text, 0, Text::Alignment::LineCenterIntegral};
+}
+
+UiPanel::WidgetDescription UiPanel::label(const Ui::Snaps snaps, const Int relativeTo, const Range2D& rect, const char* const text, const Text::Alignment alignment, const Ui::Style style, const bool disabled) {
+    return {WidgetType::Label, style, disabled, relativeTo, snaps, rect, text, 0, alignment};
+}
+
+UiPanel::WidgetDescription UiPanel::input(const Ui::Snaps snaps, const Int relativeTo, const Range2D& rect, const char* const value, const UnsignedInt maxValueSize, const Ui::Style style, const bool disabled) {
+    return {WidgetType::Input, style, disabled, relativeTo, snaps, rect, value, maxValueSize, Text::Alignment::LineCenterIntegral};
+}
+
+UiPanel::Capacity UiPanel::capacity(const Containers::ArrayView<const WidgetDescription> widgets) {
+    Capacity capacity{};
+    for(const WidgetDescription& widget: widgets) switch(widget.type) {
+        case WidgetType::Button:
+            capacity.foreground += 1;
+            capacity.text += glyphCount(widget.text);
+            break;
+        case WidgetType::Label:
+            capacity.text += glyphCount(widget.text);
+            break;
+        case WidgetType::Input:
+            capacity.foreground += 2;
+            capacity.text += widget.maxValueSize;
+            break;
+    }
+
+    return capacity;
+}
+
+UiPanel::UiPanel(Ui::UserInterface& ui, const Ui::Anchor& anchor, const Containers::ArrayView<const WidgetDescription> widgets): UiPanel{ui, anchor, widgets, capacity(widgets)} {}
+
+UiPanel::UiPanel(Ui::UserInterface& ui, const Ui::Anchor& anchor, const Containers::ArrayView<const WidgetDescription> widgets, const Capacity& capacity): Ui::Plane{ui, anchor, capacity.background, capacity.foreground, capacity.text}, _widgets{Containers::ValueInit, widgets.size()} {
+    std::size_t arenaSize{};
+    for(const WidgetDescription& widget: widgets)
+        arenaSize += alignedSize(widget.type);
+    _arena = Containers::Array<char>{Containers::NoInit, arenaSize};
+
+    std::size_t offset{};
+    for(std::size_t i = 0; i != widgets.size(); ++i) {
+        const WidgetDescription& description = widgets[i];
+        CORRADE_ASSERT(description.relativeTo < Int(i),
+            "UiPanel: widget" << i << "can be anchored only to an earlier widget, got" << description.relativeTo, );
+
+        const Ui::Anchor widgetAnchor = description.relativeTo == RelativeToPlane ?
+            Ui::Anchor{description.snaps, description.rect} :
+            Ui::Anchor{description.snaps, *_widgets[description.relativeTo].widget, description.rect};
+
+        void* const storage = _arena + offset;
+        Ui::Widget* widget{};
+        switch(description.type) {
+            case WidgetType::Button:
+                widget = new(storage) Ui::Button{*this, widgetAnchor, description.text, description.style};
+                break;
+            case WidgetType::Label:
+                widget = new(storage) Ui::Label{*this, widgetAnchor, description.text, description.alignment, description.style};
+                break;
+            case WidgetType::Input:
+                widget = new(storage) Ui::Input{*this, widgetAnchor, description.text, description.maxValueSize, description.style};
+                break;
+        }
+
+        _widgets[i] = {description.type, widget};
+        offset += alignedSize(description.type);
+
+        if(description.disabled) Ui::Widget::disable({*widget});
+    }
+}
+
+UiPanel::~UiPanel() {
+    /* Destroy in reverse order of construction, before the plane itself.
+       Slots past a failed construction are empty. */
+    for(std::size_t i = _widgets.size(); i != 0; --i) {
+        const Slot& slot = _widgets[i - 1];
+        if(!slot.widget) continue;
+        switch(slot.type) {
+            case WidgetType::Button:
+                static_cast<Ui::Button*>(slot.widget)->~Button();
+                break;
+            case WidgetType::Label:
+                static_cast<Ui::Label*>(slot.widget)->~Label();
+                break;
+            case WidgetType::Input:
+                static_cast<Ui::Input*>(slot.widget)->~Input();
+                break;
+        }
+    }
+}
+
+Ui::Button& UiPanel::button(const std::size_t id) {
+    CORRADE_ASSERT(_widgets[id].type == WidgetType::Button,
+        "UiPanel::button(): widget" << id << "is not a button", *static_cast<Ui::Button*>(_widgets[id].widget));
+    return *static_cast<Ui::Button*>(_widgets[id].widget);
+}
+
+Ui::Label& UiPanel::label(const std::size_t id) {
+    CORRADE_ASSERT(_widgets[id].type == WidgetType::Label,
+        "UiPanel::label(): widget" << id << "is not a label", *static_cast<Ui::Label*>(_widgets[id].widget));
+    return *static_cast<Ui::Label*>(_widgets[id].widget);
+}
+
+Ui::Input& UiPanel::input(const std::size_t id) {
+    CORRADE_ASSERT(_widgets[id].type == WidgetType::Input,
+        "UiPanel::input(): widget" << id << "is not an input", *static_cast<Ui::Input*>(_widgets[id].widget));
+    return *static_cast<Ui::Input*>(_widgets[id].widget);
+}
+
+}
@@ -0,0 +1,180 @@
+/*
+
+    Copyright © 2018 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef Magnum_VrUi_UiPanel_h
+#define Magnum_VrUi_UiPanel_h
+
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Text/Alignment.h>
+#include <Magnum/Ui/Anchor.h>
+#include <Magnum/Ui/Plane.h>
+#include <Magnum/Ui/Style.h>
+#include <Magnum/Ui/Ui.h>
+
+namespace Magnum {
+
+/**
+@brief Data-driven UI panel
+
+A @ref Ui::Plane with buttons, labels and inputs created from a compact
+table of @ref WidgetDescription entries instead of one hand-written member
+per widget. Plane capacities are calculated from the table by
+@ref capacity(), so they don't need to be tuned by hand when widgets are
+added. All widgets are constructed in place in a single arena allocated
+upfront, building a panel thus does one allocation for the arena and one for
+the widget table in addition to what the widgets themselves need.
+
+Widget anchors can be relative to the plane or to any widget earlier in the
+table, referenced by its index.
+
+@code{.cpp}
+const UiPanel::WidgetDescription widgets[]{
+    UiPanel::button(Ui::Snap::Top|Ui::Snap::Left, UiPanel::RelativeToPlane,
+        Range2D::fromSize(Vector2::yAxis(-36.0f), ButtonSize), "OK", Ui::Style::Primary),
+    UiPanel::button(Ui::Snap::Right, 0, {{}, ButtonSize}, "Cancel", Ui::Style::Default)
+};
+UiPanel panel{ui, Ui::Snap::Top|Ui::Snap::Bottom|Ui::Snap::Left|Ui::Snap::Right, widgets};
+Interconnect::connect(panel.button(0), &Ui::Button::tapped, ...);
+@endcode
+*/
+class UiPanel: public Ui::Plane {
+    public:
+        /** @brief Widget type */
+        enum class WidgetType: UnsignedByte {
+            Button,     /**< @ref Ui::Button */
+            Label,      /**< @ref Ui::Label */
+            Input       /**< @ref Ui::Input */
+        };
+
+        /** @brief Index for anchoring a widget relative to the plane */
+        enum: Int { RelativeToPlane = -1 };
+
+        /**
+         * @brief Widget description
+         *
+         * Use @ref button(), @ref label() and @ref input() to fill it.
+         */
+        struct WidgetDescription {
+            WidgetType type;
+            Ui::Style style;
+            bool disabled;
+            /** Index of an earlier widget or @ref RelativeToPlane */
+            Int relativeTo;
+            Ui::Snaps snaps;
+            Range2D rect;
+            /** Button and label text or initial input value, not copied */
+            const char* text;
+            /** Max input value size, unused for other widgets */
+            UnsignedInt maxValueSize;
+            /** Label alignment, unused for other widgets */
+            Text::Alignment alignment;
+        };
+
+        /** @brief Plane capacities */
+        struct Capacity {
+            std::size_t background, foreground, text;
+        };
+
+        /** @brief Describe a button */
+        static WidgetDescription button(Ui::Snaps snaps, Int relativeTo, const Range2D& rect, const char* text, Ui::Style style = Ui::Style::Default, bool disabled = false);
+
+        /** @brief Describe a label */
+        static WidgetDescription label(Ui::Snaps snaps, Int relativeTo, const Range2D& rect, const char* text, Text::Alignment alignment, Ui::Style style = Ui::Style::Default, bool disabled = false);
+
+        /** @brief Describe an input */
+        static WidgetDescription input(Ui::Snaps snaps, Int relativeTo, const Range2D& rect, const char* value, UnsignedInt maxValueSize, Ui::Style style = Ui::Style::Default, bool disabled = false);
+
+        /**
+         * @brief Plane capacities needed for given widgets
+         *
+         * Buttons take one foreground quad, inputs two for the frame and
+         * the cursor. Text capacity is the count of UTF-8 characters of
+         * all button and label texts plus max value sizes of all inputs.
+         */
+        static Capacity capacity(Containers::ArrayView<const WidgetDescription> widgets);
+
+        /**
+         * @brief Constructor
+         * @param ui        User interface
+         * @param anchor    Plane anchor
+         * @param widgets   Widgets to create. Only needs to be alive
+         *      during the constructor.
+         */
+        explicit UiPanel(Ui::UserInterface& ui, const Ui::Anchor& anchor, Containers::ArrayView<const WidgetDescription> widgets);
+
+        /** @brief Copying is not allowed */
+        UiPanel(const UiPanel&) = delete;
+
+        /** @brief Copying is not allowed */
+        UiPanel& operator=(const UiPanel&) = delete;
+
+        ~UiPanel();
+
+        /** @brief Widget count */
+        std::size_t widgetCount() const { return _widgets.size(); }
+
+        /** @brief Widget type */
+        WidgetType widgetType(std::size_t id) const { return _widgets[id].type; }
+
+        /** @brief Widget */
+        Ui::Widget& widget(std::size_t id) { return *_widgets[id].widget; }
+
+        /**
+         * @brief Button
+         *
+         * Expects that the widget is a button.
+         */
+        Ui::Button& button(std::size_t id);
+
+        /**
+         * @brief Label
+         *
+         * Expects that the widget is a label.
+         */
+        Ui::Label& label(std::size_t id);
+
+        /**
+         * @brief Input
+         *
+         * Expects that the widget is an input.
+         */
+        Ui::Input& input(std::size_t id);
+
+    private:
+        struct Slot {
+            WidgetType type;
+            Ui::Widget* widget;
+        };
+
+        explicit UiPanel(Ui::UserInterface& ui, const Ui::Anchor& anchor, Containers::ArrayView<const WidgetDescription> widgets, const Capacity& capacity);
+
+        Containers::Array<char> _arena;
+        Containers::Array<Slot> _widgets;
+};
+
+}
+
+#endif